@@ -98,6 +98,19 @@ void printUsage() {
     << "                          Valid values: 'on' and 'off'\n"
     << "  -pixels-per-thread <n>  Specify how many pixels should be calculated per thread\n"
     << "  -target-II <n>          Specify target Initiation Interval for Vivado\n"
+    << "  -fixed-point <e>        Convert floating-point computations of Vivado kernels to fixed-point,\n"
+    << "                          bounding the absolute error of each kernel result by <e>\n"
+    << "  -target-throughput <n>  Choose pixels per thread and Initiation Interval for Vivado reaching\n"
+    << "                          a throughput of <n> Mpixel/s at the clock given by -target-clock\n"
+    << "  -target-clock <n>       Specify target clock in MHz for Vivado\n"
+    << "  -strip-width <n>        Process frames in vertical strips of <n> pixels for Vivado, sizing\n"
+    << "                          line buffers for the strip instead of the frame width\n"
+    << "  -video                  Emit a free-running Vivado entry processing a sequence of frames,\n"
+    << "                          marking frame starts (TUSER) and line ends (TLAST) in-band;\n"
+    << "                          scalars and mask coefficients are sampled at each frame start\n"
+    << "                          and may only be written between frames\n"
+    << "  -m-axi <nxm>            Emit m_axi memory ports for the Vivado entry, transferring frames in\n"
+    << "                          bursts of <n> words with up to <m> outstanding bursts, e.g. 64x8\n"
     << "  -rs-package <string>    Specify Renderscript package name. (default: \"org.hipacc.rs\")\n"
     << "  -o <file>               Write output to <file>\n"
     << "  --help                  Display available options\n"
@@ -120,6 +133,7 @@ int main(int argc, char *argv[]) {
   SmallVector<const char *, 16> args;
   CompilerOptions compilerOptions = CompilerOptions();
   std::string out;
+  double target_throughput = 0, target_clock = 0;
 
   // parse command line options
   for (int i=0; i<argc; ++i) {
@@ -301,6 +315,75 @@ int main(int argc, char *argv[]) {
       ++i;
       continue;
     }
+    if (StringRef(argv[i]) == "-fixed-point") {
+      assert(i<(argc-1) && "Mandatory error bound for -fixed-point switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      double val;
+      buffer >> val;
+      if (buffer.fail() || val <= 0) {
+        llvm::errs() << "ERROR: Expected positive error bound for -fixed-point switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      compilerOptions.setFixedPointError(val);
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-target-throughput") {
+      assert(i<(argc-1) && "Mandatory throughput for -target-throughput switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      buffer >> target_throughput;
+      if (buffer.fail() || target_throughput <= 0) {
+        llvm::errs() << "ERROR: Expected positive throughput in Mpixel/s for -target-throughput switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-target-clock") {
+      assert(i<(argc-1) && "Mandatory clock for -target-clock switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      buffer >> target_clock;
+      if (buffer.fail() || target_clock <= 0) {
+        llvm::errs() << "ERROR: Expected positive clock in MHz for -target-clock switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-strip-width") {
+      assert(i<(argc-1) && "Mandatory strip width for -strip-width switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      int val;
+      buffer >> val;
+      if (buffer.fail() || val <= 0) {
+        llvm::errs() << "ERROR: Expected positive strip width for -strip-width switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      compilerOptions.setStripWidth(val);
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-video") {
+      compilerOptions.setVideoMode(true);
+      continue;
+    }
+    if (StringRef(argv[i]) == "-m-axi") {
+      assert(i<(argc-1) && "Mandatory burst specification for -m-axi switch missing.");
+      int length=0, outstanding=0, ret=0;
+      ret = sscanf(argv[i+1], "%dx%d", &length, &outstanding);
+      if (ret!=2 || length < 1 || length > 256 || outstanding < 1) {
+        llvm::errs() << "ERROR: Expected burst length between 1 and 256 and positive number of outstanding bursts for -m-axi switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      compilerOptions.setMemoryPorts(length, outstanding);
+      ++i;
+      continue;
+    }
     if (StringRef(argv[i]) == "-rs-package") {
       assert(i<(argc-1) && "Mandatory package name string for -rs-package switch missing.");
       compilerOptions.setRSPackageName(argv[i+1]);
@@ -416,6 +499,62 @@ int main(int argc, char *argv[]) {
                  << "  Local memory disabled!\n";
     compilerOptions.setLocalMemory(USER_OFF);
   }
+  // Fixed-point conversion only for scalar Vivado streams
+  if (compilerOptions.useFixedPoint() && !compilerOptions.emitVivado()) {
+    llvm::errs() << "Warning: fixed-point conversion is only supported for Vivado!\n"
+                 << "  Keeping floating-point types!\n";
+    compilerOptions.setFixedPointError(0);
+  }
+  if (compilerOptions.useFixedPoint() &&
+      compilerOptions.getPixelsPerThread() > 1) {
+    llvm::errs() << "Warning: fixed-point conversion is not supported for multiple pixels per thread!\n"
+                 << "  Keeping floating-point types!\n";
+    compilerOptions.setFixedPointError(0);
+  }
+  // Throughput target only for Vivado, requires the clock
+  if (target_throughput > 0) {
+    if (target_clock <= 0) {
+      llvm::errs() << "ERROR: -target-throughput requires the clock given by -target-clock.\n\n";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    if (!compilerOptions.emitVivado()) {
+      llvm::errs() << "Warning: throughput targets are only supported for Vivado!\n"
+                   << "  Ignoring -target-throughput!\n";
+    } else {
+      compilerOptions.setTargetThroughput(target_throughput, target_clock);
+    }
+  }
+  // Memory ports only for the Vivado entry
+  if (compilerOptions.useMemoryPorts() && !compilerOptions.emitVivado()) {
+    llvm::errs() << "Warning: m_axi memory ports are only supported for Vivado!\n"
+                 << "  Ignoring -m-axi!\n";
+    compilerOptions.setMemoryPorts(0, 0);
+  }
+  // Strips are read from and written to memory, requires memory ports
+  if (compilerOptions.useStrips()) {
+    if (!compilerOptions.emitVivado()) {
+      llvm::errs() << "Warning: strip-mining is only supported for Vivado!\n"
+                   << "  Ignoring -strip-width!\n";
+      compilerOptions.setStripWidth(0);
+    } else if (!compilerOptions.useMemoryPorts()) {
+      llvm::errs() << "Warning: strip-mining re-reads frames from memory!\n"
+                   << "  Using m_axi memory ports (-m-axi 64x4)!\n";
+      compilerOptions.setMemoryPorts(64, 4);
+    }
+  }
+  // Video mode streams frames, memory ports are started per frame
+  if (compilerOptions.useVideoMode()) {
+    if (!compilerOptions.emitVivado()) {
+      llvm::errs() << "Warning: video mode is only supported for Vivado!\n"
+                   << "  Ignoring -video!\n";
+      compilerOptions.setVideoMode(false);
+    } else if (compilerOptions.useMemoryPorts()) {
+      llvm::errs() << "Warning: video mode is not supported with m_axi memory ports!\n"
+                   << "  Ignoring -video!\n";
+      compilerOptions.setVideoMode(false);
+    }
+  }
   if (compilerOptions.timeKernels(USER_ON) &&
       compilerOptions.exploreConfig(USER_ON)) {
     // kernels are timed internally by the runtime in case of exploration
@@ -43,6 +43,24 @@ double hipacc_time_ms() {
 }
 
 
+// median of the given values using min/max operations only, like the
+// selection networks generated by the compiler; vector types are processed
+// element-wise
+template<typename data_t>
+data_t get_median(std::vector<data_t> &values) {
+    // odd-even transposition sort
+    for (size_t pass=0; pass<values.size(); ++pass) {
+        for (size_t i=pass%2; i+1<values.size(); i+=2) {
+            data_t lo = hipacc::math::min(values[i], values[i+1]);
+            values[i+1] = hipacc::math::max(values[i], values[i+1]);
+            values[i] = lo;
+        }
+    }
+
+    return values[values.size()/2];
+}
+
+
 template<typename data_t>
 class Kernel {
     private:
@@ -63,6 +81,8 @@ class Kernel {
         virtual ~Kernel() {}
         virtual void kernel() = 0;
         virtual data_t reduce(data_t left, data_t right) { return left; }
+        // histogram: bin of an output pixel, bins >= num_bins are skipped
+        virtual uint binning(data_t pixel, uint num_bins) { return num_bins; }
 
         void add_accessor(AccessorBase *acc) { images.push_back(acc); }
 
@@ -125,6 +145,27 @@ class Kernel {
             return reduction_result;
         }
 
+        // histogram of the output image using the binning function
+        std::vector<uint> binned_data(uint num_bins) {
+            auto end  = iteration_space.end();
+            auto iter = iteration_space.begin();
+            std::vector<uint> bins(num_bins, 0);
+
+            // register output accessors
+            out_acc.setEI(&iter);
+
+            while (iter != end) {
+                uint bin = binning(out_acc(), num_bins);
+                if (bin < num_bins) ++bins[bin];
+                ++iter;
+            }
+
+            // de-register output accessor
+            out_acc.setEI(nullptr);
+
+            return bins;
+        }
+
 
         // access output image
         data_t &output(void) {
@@ -171,6 +212,10 @@ auto Kernel<data_t>::convolve(Mask<data_m> &mask, Reduce mode, const Function& f
 
     // initialize result - calculate first iteration
     auto result = fun();
+    std::vector<decltype(fun())> taps;
+    if (mode == Reduce::MEDIAN) {
+        taps.push_back(result);
+    }
 
     // advance iterator and apply kernel to remaining iteration space
     while (++iter != end && !break_iteration) {
@@ -194,11 +239,15 @@ auto Kernel<data_t>::convolve(Mask<data_m> &mask, Reduce mode, const Function& f
                 result *= fun();
                 break;
             case Reduce::MEDIAN:
-                assert(0 && "HipaccMEDIAN not implemented yet!");
+                taps.push_back(fun());
                 break;
         }
     }
 
+    if (mode == Reduce::MEDIAN) {
+        result = get_median(taps);
+    }
+
     // de-register mask
     mask.setEI(nullptr);
 
@@ -217,6 +266,10 @@ auto Kernel<data_t>::reduce(Domain &domain, Reduce mode, const Function &fun) ->
 
     // initialize result - calculate first iteration
     auto result = fun();
+    std::vector<decltype(fun())> taps;
+    if (mode == Reduce::MEDIAN) {
+        taps.push_back(result);
+    }
 
     // advance iterator and apply kernel to remaining iteration space
     while (++iter != end && !break_iteration) {
@@ -238,11 +291,15 @@ auto Kernel<data_t>::reduce(Domain &domain, Reduce mode, const Function &fun) ->
                 result *= fun();
                 break;
             case Reduce::MEDIAN:
-                assert(0 && "HipaccMEDIAN not implemented yet!");
+                taps.push_back(fun());
                 break;
         }
     }
 
+    if (mode == Reduce::MEDIAN) {
+        result = get_median(taps);
+    }
+
     // de-register domain
     domain.setDI(nullptr);
 
@@ -49,6 +49,8 @@
 #include "hipacc/DSL/ClassRepresentation.h"
 #include "hipacc/Vectorization/SIMDTypes.h"
 
+#include <map>
+
 
 //===----------------------------------------------------------------------===//
 // Statement/expression transformations
@@ -101,6 +103,8 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
     SmallVector<DeclRefExpr *, 4> redTmps;
     SmallVector<Reduce, 4> redModes;
     SmallVector<int, 4> redIdxX, redIdxY;
+    // variables storing the taps of median convolutions/reductions
+    std::map<DeclRefExpr *, SmallVector<VarDecl *, 16>> medianTaps;
     SmallVector<LabelDecl *, 4> breakLabels;
     SmallVector<bool, 4> containsBreak;
 
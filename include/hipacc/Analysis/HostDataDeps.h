@@ -31,7 +31,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <vector>
+#include <map>
 #include <iostream>
 #include <sstream>
 
@@ -46,6 +48,7 @@
 #include "hipacc/DSL/CompilerKnownClasses.h"
 #include "hipacc/DSL/ClassRepresentation.h"
 #include "hipacc/AST/ASTNode.h"
+#include "hipacc/Analysis/RangeAnalysis.h"
 
 //#define PRINT_DEBUG
 
@@ -68,13 +71,28 @@ class DependencyTracker : public StmtVisitor<DependencyTracker> {
     llvm::DenseMap<ValueDecl *, HipaccImage *> imgDeclMap_;
     llvm::DenseMap<ValueDecl *, HipaccIterationSpace *> iterDeclMap_;
     llvm::DenseMap<ValueDecl *, HipaccBoundaryCondition *> bcDeclMap_;
+    llvm::DenseMap<ValueDecl *, HipaccPyramid *> pyrDeclMap_;
+
+    // function of the traversal being unrolled, the depth of its pyramids and
+    // the level currently visited
+    Stmt *traverseBody_;
+    size_t traverseDepth_;
+    size_t level_;
+
+    int evaluateInt(Expr *E);
+    size_t getNumBins(CXXMemberCallExpr *E, ValueDecl *VD);
+    bool getPyramidCall(Expr *E, ValueDecl *&PVD, int &relative);
+    bool evaluateLevelCondition(Expr *E);
+    void unrollTraversal(Stmt *S);
+    void unrollTraversalScope(Stmt *body);
 
   public:
     DependencyTracker(ASTContext &Context,
                       AnalysisDeclContext &analysisContext,
                       CompilerKnownClasses &compilerClasses,
                       HostDataDeps &dataDeps)
-        : Context(Context), compilerClasses(compilerClasses), dataDeps(dataDeps) {
+        : Context(Context), compilerClasses(compilerClasses), dataDeps(dataDeps),
+          traverseBody_(nullptr), traverseDepth_(0), level_(0) {
       if (DEBUG) std::cout << "Tracking data dependencies:" << std::endl;
       PostOrderCFGView *POV = analysisContext.getAnalysis<PostOrderCFGView>();
       for (auto it=POV->begin(), ei=POV->end(); it!=ei; ++it) {
@@ -93,6 +111,7 @@ class DependencyTracker : public StmtVisitor<DependencyTracker> {
 
     void VisitDeclStmt(DeclStmt *S);
     void VisitCXXMemberCallExpr(CXXMemberCallExpr *E);
+    void VisitCallExpr(CallExpr *E);
 };
 
 
@@ -111,6 +130,7 @@ class HostDataDeps : public ManagedAnalysis {
 
     class Accessor;
     class Image;
+    class Pyramid;
     class IterationSpace;
     class BoundaryCondition;
     class Kernel;
@@ -124,13 +144,64 @@ class HostDataDeps : public ManagedAnalysis {
     llvm::DenseMap<ValueDecl *, IterationSpace *> iterMap_;
     llvm::DenseMap<ValueDecl *, BoundaryCondition *> bcMap_;
     llvm::DenseMap<ValueDecl *, Kernel *> kernelMap_;
+    llvm::DenseMap<ValueDecl *, Pyramid *> pyrMap_;
 
     std::vector<Space*> spaces_;
     std::vector<Process*> processes_;
 
-    unsigned int outId, tmpId;
+    unsigned int outId, tmpId, resampleId;
     std::vector<Node*> schedule;
 
+    // process template parameters of the Vivado kernels, set by Rewrite
+    struct ProcessInfo {
+      bool local;
+      bool vect;
+      std::string sizeX;
+      std::string sizeY;
+      std::string border;
+      std::string inType;
+      std::string outType;
+      // coefficient declarations and accumulator type of separable kernels
+      std::string sepCoef;
+      std::string sepType;
+    };
+    std::map<std::string, ProcessInfo> processInfo_;
+    // frame and window bounds of the pipeline, set by Rewrite; the lines
+    // streamed are at most maxImageWidth_ wide, less than the frame width
+    // when strip-mining
+    size_t maxImageWidth_, maxImageHeight_, maxWindowSizeX_, maxWindowSizeY_;
+    size_t maxFrameWidth_, stripWidth_, stripHalo_;
+    // depth of the streams declared in the dataflow region
+    std::map<std::string, size_t> streamDepth_;
+    // range of the results of kernels with narrowed output streams, set by
+    // Rewrite, and the resulting fixed-point formats and integer ranges of
+    // the streams
+    std::map<std::string, std::pair<double, double>> outputRange_;
+    std::map<Space*, FixedPointFormat> fixedPointFormat_;
+    std::map<Space*, ValueRange> integerRange_;
+    // operations of the kernels for the resource estimate, set by Rewrite
+    struct KernelCost {
+      OperationCount ops;
+      OperationCount lambdaOps;
+      bool floatOps;
+    };
+    std::map<std::string, KernelCost> kernelCost_;
+    // reports unsupported pipelines detected after parsing
+    DiagnosticsEngine *diags_;
+    struct ResourceEstimate {
+      size_t bram, dsp, ff, lut;
+
+      ResourceEstimate() : bram(0), dsp(0), ff(0), lut(0) {}
+
+      ResourceEstimate &operator+=(const ResourceEstimate &e) {
+        bram += e.bram;
+        dsp += e.dsp;
+        ff += e.ff;
+        lut += e.lut;
+        return *this;
+      }
+    };
+
     // inner class definitions
     class IterationSpace {
       private:
@@ -143,7 +214,8 @@ class HostDataDeps : public ManagedAnalysis {
         }
 
         std::string getName() {
-          return iter->getName();
+          // resampling stages have no iteration space in the source
+          return iter ? iter->getName() : image->getName();
         }
 
         Image *getImage() {
@@ -162,6 +234,11 @@ class HostDataDeps : public ManagedAnalysis {
             : acc(acc), image(image), space(nullptr) {
         }
 
+        // accessor reading the resampled stream of acc
+        Accessor(Accessor *acc, Image *image)
+            : acc(acc->acc), image(image), space(nullptr) {
+        }
+
         Space *getSpace() {
           return space;
         }
@@ -177,6 +254,18 @@ class HostDataDeps : public ManagedAnalysis {
         Image *getImage() {
           return image;
         }
+
+        Interpolate getInterpolationMode() {
+          return acc->getInterpolationMode();
+        }
+
+        SourceLocation getLocation() {
+          return acc->getDecl()->getLocation();
+        }
+
+        Boundary getBoundaryMode() {
+          return acc->getBoundaryMode();
+        }
     };
 
     class BoundaryCondition {
@@ -197,19 +286,82 @@ class HostDataDeps : public ManagedAnalysis {
     class Image {
       private:
         HipaccImage *img;
+        size_t level;
 
       public:
         Image(HipaccImage *img)
-            : img(img) {
+            : img(img), level(0) {
+        }
+
+        // image of a lower pyramid level, half the size per level
+        Image(Image *image, size_t level)
+            : img(image->img), level(level) {
         }
 
         std::string getName() {
-          return img->getName();
+          if (level == 0) {
+            return img->getName();
+          }
+          std::ostringstream name;
+          name << img->getName() << "_" << level;
+          return name.str();
+        }
+
+        size_t getLevel() {
+          return level;
+        }
+
+        SourceLocation getLocation() {
+          return img->getDecl()->getLocation();
         }
 
         std::string getTypeStr(size_t ppt) {
           return ASTNode::createVivadoTypeStr(img, ppt);
         }
+
+        bool isVectorType() {
+          return isa<VectorType>(img->getType().getCanonicalType().getTypePtr());
+        }
+
+        bool isFloatType() {
+          return img->getType()->isRealFloatingType();
+        }
+
+        bool isIntegerType() {
+          return img->getType()->isIntegerType();
+        }
+
+        size_t getTypeWidth() {
+          QualType QT = img->getType().getCanonicalType();
+          if (const VectorType *VT = dyn_cast<VectorType>(QT.getTypePtr())) {
+            ASTNode::VectorTypeInfo info = ASTNode::createVectorTypeInfo(VT);
+            return info.elementCount * info.elementWidth;
+          }
+          return ASTNode::getBuiltinTypeSize(QT->getAs<BuiltinType>());
+        }
+    };
+
+    class Pyramid {
+      private:
+        std::vector<Image*> levels;
+
+      public:
+        Pyramid(Image *image, size_t depth) {
+          levels.push_back(image);
+          for (size_t i = 1; i < depth; ++i) {
+            levels.push_back(new Image(image, i));
+          }
+        }
+
+        size_t getDepth() {
+          return levels.size();
+        }
+
+        Image *getImage(size_t level) {
+          assert(level < levels.size() &&
+                 "Accessed pyramid stage is out of bounds.");
+          return levels[level];
+        }
     };
 
     class Kernel {
@@ -217,16 +369,42 @@ class HostDataDeps : public ManagedAnalysis {
         std::string name;
         IterationSpace *iter;
         std::vector<Accessor*> accs;
+        bool reduce;
+        size_t numBins;
+        SourceLocation loc;
 
       public:
-        Kernel(std::string name, IterationSpace *iter)
-            : name(name), iter(iter) {
+        Kernel(std::string name, IterationSpace *iter, bool reduce=false)
+            : name(name), iter(iter), reduce(reduce), numBins(0) {
+        }
+
+        // declaration of the kernel in the source, invalid for resampling
+        // stages
+        void setLocation(SourceLocation loc) {
+          this->loc = loc;
+        }
+
+        SourceLocation getLocation() {
+          return loc;
         }
 
         std::string getName() {
           return name;
         }
 
+        bool hasReduceFunction() {
+          return reduce;
+        }
+
+        // number of bins requested by binned_data(), 0 if not binned
+        void setNumBins(size_t num) {
+          numBins = num;
+        }
+
+        size_t getNumBins() {
+          return numBins;
+        }
+
         IterationSpace *getIterationSpace() {
           return iter;
         }
@@ -248,6 +426,10 @@ class HostDataDeps : public ManagedAnalysis {
         void addAccessor(Accessor *acc) {
           accs.push_back(acc);
         }
+
+        void replaceAccessor(Accessor *acc, Accessor *with) {
+          std::replace(accs.begin(), accs.end(), acc, with);
+        }
     };
 
     class Node {
@@ -335,8 +517,20 @@ class HostDataDeps : public ManagedAnalysis {
         std::vector<std::string> inStreams;
         std::string outStream;
 
+        // point operators fused into this process: the producers of the
+        // input spaces applied to the pixels read (nullptr if not fused) and
+        // the consumers applied to the result
+        Process *fusedInto;
+        std::vector<Process*> inputMap;
+        std::vector<Process*> outputMap;
+
+        // interpolation mode of processes resampling a stream to the size of
+        // another pyramid level
+        Interpolate resample;
+
         Process(Kernel *kernel, Space *outSpace)
-            : Node(false), kernel(kernel), outSpace(outSpace) {
+            : Node(false), kernel(kernel), outSpace(outSpace),
+              fusedInto(nullptr), resample(Interpolate::NO) {
           outSpace->srcProcess = this;
         }
 
@@ -375,11 +569,19 @@ class HostDataDeps : public ManagedAnalysis {
     }
 
     void addImage(ValueDecl *VD, HipaccImage *img);
+    void addPyramid(ValueDecl *PVD, ValueDecl *IVD, size_t depth);
+    Image *getPyramidImage(ValueDecl *PVD, size_t level);
+    size_t getPyramidDepth(ValueDecl *PVD);
     void addBoundaryCondition(ValueDecl *BCVD, HipaccBoundaryCondition *BC, ValueDecl *IVD);
+    void addBoundaryCondition(ValueDecl *BCVD, HipaccBoundaryCondition *BC, Image *img);
     void addKernel(ValueDecl *KVD, ValueDecl *ISVD, std::vector<ValueDecl*> AVDS);
     void addAccessor(ValueDecl *AVD, HipaccAccessor *acc, ValueDecl* IVD);
+    void addAccessor(ValueDecl *AVD, HipaccAccessor *acc, Image *img);
     void addIterationSpace(ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD);
+    void addIterationSpace(ValueDecl *ISVD, HipaccIterationSpace *iter, Image *img);
+    Space *resampleSpace(Space *s, Accessor *acc, Kernel *kernel);
     void runKernel(ValueDecl *VD);
+    void binKernel(ValueDecl *VD, size_t numBins);
 
     void dump(Process *proc);
     void dump(Space *space);
@@ -391,13 +593,65 @@ class HostDataDeps : public ManagedAnalysis {
     void markProcess(Process *t);
     void markSpace(Space *s);
     void createSchedule();
+    bool writesStreamCopies(Process *proc);
+    std::string getKernelName(Process *proc) {
+      return "cc" + proc->getKernel()->getName() + "Kernel";
+    }
+    ProcessInfo *getProcessInfo(Process *proc);
+    bool isFusable(Process *proc);
+    Process *getFusedOutput(Process *proc);
+    void getFusedInputs(Process *proc, std::vector<std::string> &streams,
+        std::vector<Space*> &spaces);
+    void getFusedProcesses(Process *proc, std::vector<Process*> &procs);
+    std::string printInputMap(Process *proc, size_t slot,
+        std::map<Process*,std::string> &member, size_t &rawId);
+    bool fuseInput(Process *proc, Process *consumer);
+    void fuseProcesses();
+    std::string printFusedProcess(Process *proc, std::string name,
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
+    std::vector<std::string> getOutputStreams(Process *proc);
+    bool isSharedSpace(Space *s);
+    std::string printSharedProcess(Space *s, std::string name,
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
+    bool isReducedSpace(Space *s);
+    std::string printReduceProcess(Process *proc, std::string name);
+    std::string printBinningProcess(Process *proc, std::string name);
+    std::string printSize(Space *s);
+    size_t getProcessDelay(Process *proc);
+    size_t computeStripHalo();
+    void computeStreamDepths();
+    std::string printStreamDecl(std::string type, std::string stream,
+        std::string indent);
     std::string getEntrySignature(
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
-        bool withTypes=false);
+        bool withTypes=false, std::string img="", bool streams=false);
+    std::string printMemoryPortEntry(
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
+    std::string printVideoEntry(
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
+    std::string printStripArguments(
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
+        bool withTypes);
+    std::string printStripEntry(
+        std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
+    size_t getStreamWidth(Space *s);
+    static size_t estimateOperators(OperationCount ops, bool floatOps,
+        size_t bits, size_t ppt, size_t ii, ResourceEstimate &est);
+    std::string printProcessEstimate(Process *proc, ResourceEstimate &est,
+        size_t &depth, std::string indent);
     std::string prettyPrint(
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
         bool print=false);
+    size_t getNumProcesses(Kernel *kernel);
+    bool isPyramidImage(Image *image);
+    bool isNarrowedSpace(Space *s);
+    Space *getAccessorSpace(std::string kernelName, std::string accName);
+    void resolveStreamTypes();
+    std::string getResolvedTypeStr(Space *s);
     std::string getTypeStr(Space *s) {
+      if (isNarrowedSpace(s)) {
+        return getKernelName(s->getSrcProcess()) + "Type";
+      }
       return s->getTypeStr(compilerOptions.getPixelsPerThread());
     }
 
@@ -406,12 +660,41 @@ class HostDataDeps : public ManagedAnalysis {
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
     std::string printEntryCall(
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
-        std::string img);
+        std::string img, bool stmt=true);
     std::string printEntryDef(
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args);
     std::string getInputStream(ValueDecl *VD);
     std::string getOutputStream(ValueDecl *VD);
     std::string getStreamDecl(ValueDecl *VD);
+    size_t getNumOutputStreams(std::string kernelName);
+    std::string getReduceResult(std::string kernelName);
+    std::string getBinningResult(std::string kernelName);
+    std::string printReduceResultDecls(std::string indent);
+    void setProcessInfo(std::string kernelName, bool local, bool vect,
+        std::string sizeX, std::string sizeY, std::string border,
+        std::string inType, std::string outType, std::string sepCoef="",
+        std::string sepType="");
+    std::string getInputTypeStr(std::string kernelName, std::string accName,
+        HipaccImage *img, size_t ppt);
+    std::string getOutputTypeStr(std::string kernelName, HipaccImage *img,
+        size_t ppt);
+    bool isNarrowedInput(std::string kernelName, std::string accName);
+    bool getInputRange(std::string kernelName, std::string accName,
+        double &lo, double &hi);
+    void setOutputRange(std::string kernelName, double lo, double hi);
+    std::string printStreamTypes();
+    void setKernelOperations(std::string kernelName, OperationCount ops,
+        OperationCount lambdaOps, bool floatOps);
+    std::string printEstimate();
+    static size_t getKernelCost(OperationCount ops, bool floatOps,
+        size_t bits, size_t ppt, size_t ii);
+    void setMaxSizes(size_t imageWidth, size_t imageHeight,
+        size_t windowSizeX, size_t windowSizeY);
+    // width of the lines streamed through the pipeline, the strip width
+    // including the halos when strip-mining
+    size_t getMaxLineWidth() { return maxImageWidth_; }
+    size_t getStripWidth() { return stripWidth_; }
+    size_t getStripHalo() { return stripHalo_; }
 
     static HostDataDeps *parse(ASTContext &Context,
         AnalysisDeclContext &analysisContext,
@@ -420,6 +703,7 @@ class HostDataDeps : public ManagedAnalysis {
       static HostDataDeps dataDeps;
       dataDeps.compilerClasses = compilerClasses;
       dataDeps.compilerOptions = compilerOptions;
+      dataDeps.diags_ = &Context.getDiagnostics();
       DependencyTracker DT(Context, analysisContext, compilerClasses, dataDeps);
 
       if (DEBUG) {
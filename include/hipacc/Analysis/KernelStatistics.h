@@ -69,6 +69,13 @@ enum VectorInfo {
   PROPAGATE   = 0x2
 };
 
+// number of operations, used to estimate the resources of hardware kernels
+struct OperationCount {
+  unsigned ops, mulOps, divOps, specialOps;
+
+  OperationCount() : ops(0), mulOps(0), divOps(0), specialOps(0) {}
+};
+
 class KernelStatistics : public ManagedAnalysis {
   private:
     KernelStatistics(void *impl);
@@ -79,6 +86,10 @@ class KernelStatistics : public ManagedAnalysis {
     MemoryPattern getMemPattern(const FieldDecl *FD);
     VectorInfo getVectorizeInfo(const VarDecl *VD);
     KernelType getKernelType();
+    // operations of the kernel body excluding lambda functions, which are
+    // executed for each element of the Mask or Domain they iterate over
+    OperationCount getOperations();
+    OperationCount getLambdaOperations();
 
     virtual ~KernelStatistics();
 
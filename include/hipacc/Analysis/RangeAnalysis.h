@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+//===--- RangeAnalysis.h - Value ranges and fixed-point formats -----------===//
+//
+// This file implements an interval analysis of translated kernel bodies. It
+// computes the range of the values of the kernel result and of its local
+// variables, and bounds the error of evaluating all floating-point
+// computations in a fixed-point format.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _RANGEANALYSIS_H_
+#define _RANGEANALYSIS_H_
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Expr.h>
+#include <clang/AST/ExprCXX.h>
+#include <clang/AST/Stmt.h>
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+
+#include <string>
+
+namespace clang {
+namespace hipacc {
+// interval of the exact values of an expression and bound of the absolute
+// error of its fixed-point computation
+struct ValueRange {
+  double lo, hi;
+  double err;
+
+  ValueRange(double lo=0, double hi=0, double err=0)
+    : lo(lo), hi(hi), err(err) {}
+
+  // largest magnitude of the computed values
+  double getMaxAbs() const;
+};
+
+
+// fixed-point format ap_fixed<intBits+fracBits,intBits> with rounding to the
+// nearest value
+struct FixedPointFormat {
+  int intBits, fracBits;
+
+  FixedPointFormat(int intBits=1, int fracBits=0)
+    : intBits(intBits), fracBits(fracBits) {}
+
+  int getWidth() const { return intBits + fracBits; }
+  std::string getTypeStr() const;
+
+  // format holding values of magnitude maxAbs with a rounding error of at
+  // most maxError
+  static FixedPointFormat get(double maxAbs, double maxError);
+  static int getIntBits(double maxAbs);
+  static int getFracBits(double maxError);
+};
+
+
+// arbitrary precision integer type ap_int<width>/ap_uint<width>
+struct IntegerFormat {
+  int width;
+  bool isSigned;
+
+  IntegerFormat(int width=1, bool isSigned=false)
+    : width(width), isSigned(isSigned) {}
+
+  std::string getTypeStr() const;
+
+  // narrowest format holding all values of range
+  static IntegerFormat get(const ValueRange &range);
+};
+
+
+class RangeAnalysis {
+  private:
+    ASTContext &Ctx;
+    llvm::DenseMap<const ValueDecl *, ValueRange> inputs_;
+    llvm::DenseMap<const ValueDecl *, bool> rounded_;
+    llvm::DenseMap<const ValueDecl *, ValueRange> vars_;
+    // values of local variables over the whole body
+    llvm::DenseMap<const ValueDecl *, ValueRange> hulls_;
+    llvm::SmallPtrSet<const ValueDecl *, 4> outputs_;
+    // error of rounding a value to the fixed-point format, 2^-(fracBits+1)
+    int fracBits_;
+    double round_;
+    double maxAbs_;
+    bool supported_;
+    bool usesFloat_;
+    bool widthDependent_;
+    bool wraps_;
+    bool hasResult_;
+    ValueRange result_;
+
+    ValueRange unsupported();
+    void noteValue(const ValueRange &val);
+    ValueRange roundValue(ValueRange val, QualType QT);
+    ValueRange getTypeRange(QualType QT);
+    ValueRange convertValue(ValueRange val, QualType from, QualType to);
+    ValueRange readInput(Expr *E);
+    void writeVar(const ValueDecl *VD, const ValueRange &val);
+    void writeResult(const ValueRange &val);
+    void havoc(Stmt *S);
+    ValueRange visitBinary(BinaryOperatorKind op, ValueRange a, ValueRange b,
+        QualType QT);
+    ValueRange visitExpr(Expr *E);
+    void visitStmt(Stmt *S);
+
+  public:
+    RangeAnalysis(ASTContext &Ctx)
+      : Ctx(Ctx), fracBits_(0), round_(0), maxAbs_(0), supported_(true),
+        usesFloat_(false), widthDependent_(false), wraps_(false),
+        hasResult_(false) {}
+
+    // range of the values of an integer type
+    static bool getTypeRange(ASTContext &Ctx, QualType QT, ValueRange &range);
+
+    // range of the values of a kernel parameter. Reads of rounded inputs are
+    // converted to the fixed-point format of the kernel.
+    void addInput(const ValueDecl *VD, double lo, double hi, bool rounded);
+    // input parameter accessed by E, nullptr if E is no input read
+    const ValueDecl *getInput(Expr *E);
+    // array parameter the kernel result is stored to
+    void addOutput(const ValueDecl *VD) { outputs_.insert(VD); }
+
+    // analyzes body computing all floating-point values with fracBits
+    // fractional bits, returns false for unsupported statements
+    bool analyze(Stmt *body, int fracBits);
+    bool usesFloat() { return usesFloat_; }
+    // body uses operators whose result depends on the width of their operand
+    // types or that require operands of a common type: shifts to the left,
+    // bitwise negation, and the conditional operator
+    bool usesWidthDependentOps() { return widthDependent_; }
+    // body computes integer values exceeding the range of their type, e.g.
+    // unsigned subtractions wrapping around, which depend on the type width
+    bool usesWrappingOps() { return wraps_; }
+    // range of the values assigned to a local variable
+    bool getVarRange(const ValueDecl *VD, ValueRange &range);
+    bool hasResult() { return hasResult_; }
+    ValueRange getResult() { return result_; }
+    double getMaxAbs() { return maxAbs_; }
+
+    // smallest format computing the result of body with an error of at most
+    // maxError
+    bool computeFormat(Stmt *body, double maxError, FixedPointFormat &format,
+        ValueRange &result);
+    // smallest format of the accumulator of a separable convolution of the
+    // input range in, computing the result with an error of at most maxError
+    static bool computeSeparableFormat(ValueRange in, bool rounded,
+        ArrayRef<double> rowCoef, ArrayRef<double> colCoef, double maxError,
+        FixedPointFormat &format);
+    // range of the partial sums of an integer separable convolution of the
+    // input range in, and of its result
+    static void computeSeparableRange(ValueRange in, ArrayRef<double> rowCoef,
+        ArrayRef<double> colCoef, ValueRange &acc, ValueRange &result);
+};
+} // end namespace hipacc
+} // end namespace clang
+
+#endif  // _RANGEANALYSIS_H_
+
+// vim: set ts=2 sw=2 sts=2 et ai:
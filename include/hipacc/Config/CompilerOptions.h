@@ -86,6 +86,11 @@ class CompilerOptions {
     Texture texture_type;
     std::string rs_package_name;
     int target_ii;
+    double fixed_point_error;
+    int axi_burst_length, axi_outstanding;
+    double target_throughput, target_clock;
+    int strip_width;
+    bool video_mode;
 
     void getOptionAsString(CompilerOption option, int val=-1) {
       switch (option) {
@@ -126,7 +131,14 @@ class CompilerOptions {
       pixels_per_thread(1),
       texture_type(Texture::None),
       rs_package_name("org.hipacc.rs"),
-      target_ii(1)
+      target_ii(1),
+      fixed_point_error(0),
+      axi_burst_length(0),
+      axi_outstanding(0),
+      target_throughput(0),
+      target_clock(0),
+      strip_width(0),
+      video_mode(false)
     {}
 
     bool emitC99() { return target_lang == Language::C99; }
@@ -191,6 +203,17 @@ class CompilerOptions {
     int getPixelsPerThread() { return pixels_per_thread; }
     std::string getRSPackageName() { return rs_package_name; }
     int getTargetII() { return target_ii; }
+    bool useFixedPoint() { return fixed_point_error > 0; }
+    double getFixedPointError() { return fixed_point_error; }
+    bool useMemoryPorts() { return axi_burst_length > 0; }
+    int getBurstLength() { return axi_burst_length; }
+    int getOutstandingBursts() { return axi_outstanding; }
+    bool useTargetThroughput() { return target_throughput > 0; }
+    double getTargetThroughput() { return target_throughput; }
+    double getTargetClock() { return target_clock; }
+    bool useStrips() { return strip_width > 0; }
+    int getStripWidth() { return strip_width; }
+    bool useVideoMode() { return video_mode; }
 
     void setTargetLang(Language lang) { target_lang = lang; }
     void setTargetDevice(Device td) { target_device = td; }
@@ -231,6 +254,39 @@ class CompilerOptions {
       target_ii = ii;
     }
 
+    // absolute error bound of the fixed-point computation of Vivado kernels,
+    // 0 keeps floating-point types
+    void setFixedPointError(double error) {
+      fixed_point_error = error;
+    }
+
+    // m_axi ports of the Vivado entry transferring frames in bursts of at
+    // most length words with up to outstanding bursts in flight, 0 keeps
+    // streams
+    void setMemoryPorts(int length, int outstanding) {
+      axi_burst_length = length;
+      axi_outstanding = outstanding;
+    }
+
+    // throughput in Mpixel/s at a clock in MHz the pixels per thread and II
+    // of Vivado pipelines are chosen for, 0 keeps the given configuration
+    void setTargetThroughput(double throughput, double clock) {
+      target_throughput = throughput;
+      target_clock = clock;
+    }
+
+    // width of the vertical strips Vivado pipelines process frames in, 0
+    // processes whole frames
+    void setStripWidth(int width) {
+      strip_width = width;
+    }
+
+    // free-running Vivado entry processing a sequence of frames delimited
+    // in-band on AXI4-Stream side channels
+    void setVideoMode(bool video) {
+      video_mode = video;
+    }
+
     std::string getTargetPrefix() {
       switch (target_lang) {
         case Language::Vivado:
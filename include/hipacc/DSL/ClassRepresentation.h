@@ -369,6 +369,9 @@ class HipaccMask : public HipaccMemory {
     HipaccMask *getCopyMask() {
       return copy_mask;
     }
+    // factorize a constant rank-1 mask into a row and a column vector
+    bool getSeparableCoefficients(ASTContext &Ctx, SmallVectorImpl<double> &row,
+        SmallVectorImpl<double> &col);
 };
 
 
@@ -389,7 +392,7 @@ class HipaccKernelClass {
     };
 
     std::string name;
-    CXXMethodDecl *kernelFunction, *reduceFunction;
+    CXXMethodDecl *kernelFunction, *reduceFunction, *binningFunction;
     KernelStatistics *kernelStatistics;
     // kernel member information
     SmallVector<KernelMemberInfo, 16> members;
@@ -403,6 +406,7 @@ class HipaccKernelClass {
       name(name),
       kernelFunction(nullptr),
       reduceFunction(nullptr),
+      binningFunction(nullptr),
       kernelStatistics(nullptr),
       members(0),
       imgFields(0),
@@ -420,8 +424,10 @@ class HipaccKernelClass {
     }
 
     void setReduceFunction(CXXMethodDecl *fun) { reduceFunction = fun; }
+    void setBinningFunction(CXXMethodDecl *fun) { binningFunction = fun; }
     CXXMethodDecl *getKernelFunction() { return kernelFunction; }
     CXXMethodDecl *getReduceFunction() { return reduceFunction; }
+    CXXMethodDecl *getBinningFunction() { return binningFunction; }
 
     KernelStatistics &getKernelStatistics(void) {
       return *kernelStatistics;
@@ -568,7 +574,7 @@ class HipaccKernel : public HipaccKernelFeatures {
     ASTContext &Ctx;
     VarDecl *VD;
     std::string name;
-    std::string kernelName, reduceName;
+    std::string kernelName, reduceName, binningName;
     std::string fileName;
     std::string reduceStr, infoStr;
     unsigned infoStrCnt;
@@ -608,6 +614,7 @@ class HipaccKernel : public HipaccKernelFeatures {
       name(VD->getNameAsString()),
       kernelName(options.getTargetPrefix() + KC->getName() + name + "Kernel"),
       reduceName(options.getTargetPrefix() + KC->getName() + name + "Reduce"),
+      binningName(options.getTargetPrefix() + KC->getName() + name + "Binning"),
       fileName(options.getTargetPrefix() + KC->getName() + VD->getNameAsString()),
       reduceStr(), infoStr(),
       infoStrCnt(0),
@@ -646,6 +653,7 @@ class HipaccKernel : public HipaccKernelFeatures {
     const std::string &getName() const { return name; }
     const std::string &getKernelName() const { return kernelName; }
     const std::string &getReduceName() const { return reduceName; }
+    const std::string &getBinningName() const { return binningName; }
     const std::string &getFileName() const { return fileName; }
     void setInfoStr() {
       std::string cnt(std::to_string(infoStrCnt++));
@@ -96,6 +96,8 @@ class CreateHostStrings {
         HipaccKernel *K, std::string &resultStr);
     void writeReduceCall(HipaccKernelClass *KC, HipaccKernel *K, std::string
         &resultStr);
+    void writeBinningCall(HipaccKernel *K, std::string numBins, std::string
+        &resultStr);
     void writeInterpolationDefinition(HipaccKernel *K, HipaccAccessor *Acc,
         std::string function_name, std::string type_suffix, Interpolate ip_mode,
         Boundary bh_mode, std::string &resultStr);
@@ -2081,6 +2081,7 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
           switch (compilerOptions.getTargetLang()) {
             case Language::C99:
             case Language::CUDA:
+            case Language::Vivado:
               // array subscript: Mask[conv_y][conv_x]
               result = accessMem2DAt(LHS, midx_x, midx_y);
               break;
@@ -2096,9 +2097,6 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
               // allocation access: rsGetElementAt(Mask, conv_x, conv_y)
               result = accessMemAllocAt(LHS, mem_acc, midx_x, midx_y);
               break;
-            case Language::Vivado:
-              assert(false && "Only constant masks are allowed for Vivado");
-              break;
           }
         }
         break;
@@ -2135,6 +2133,7 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
           switch (compilerOptions.getTargetLang()) {
             case Language::C99:
             case Language::CUDA:
+            case Language::Vivado:
               // array subscript: Mask[conv_y][conv_x]
               result = accessMem2DAt(LHS, midx_x, midx_y);
               break;
@@ -2150,9 +2149,6 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
               // allocation access: rsGetElementAt(Mask, conv_x, conv_y)
               result = accessMemAllocAt(LHS, mem_acc, midx_x, midx_y);
               break;
-            case Language::Vivado:
-              assert(false && "Only constant masks are allowed for Vivado");
-              break;
           }
         }
         }
@@ -2167,6 +2163,7 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
         switch (compilerOptions.getTargetLang()) {
           case Language::C99:
           case Language::CUDA:
+          case Language::Vivado:
             // array subscript: Mask[y+size_y/2][x+size_x/2]
             result = accessMem2DAt(LHS, createBinaryOperator(Ctx,
                   Clone(E->getArg(1)), createIntegerLiteral(Ctx,
@@ -2217,9 +2214,6 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
                     Ctx.IntTy));
             }
             break;
-          case Language::Vivado:
-            assert(false && "Only constant masks are allowed for Vivado");
-            break;
         }
         break;
     }
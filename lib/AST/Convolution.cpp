@@ -30,7 +30,9 @@
 //===----------------------------------------------------------------------===//
 
 // includes for numeric_limits
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "hipacc/AST/ASTTranslate.h"
 
@@ -39,15 +41,178 @@ using namespace hipacc;
 using namespace ASTNode;
 
 
+// split a product with a constant scalar factor, e.g. a propagated mask
+// coefficient, into the factor and the remaining operand
+static Expr *getConstantFactor(ASTContext &Ctx, Expr *E, QualType QT,
+    APValue &factor, Expr *&constant) {
+  BinaryOperator *BO = dyn_cast<BinaryOperator>(E->IgnoreParens());
+  if (!BO || BO->getOpcode() != BO_Mul ||
+      !BO->getType()->isArithmeticType() ||
+      !Ctx.hasSameUnqualifiedType(BO->getType(), QT)) {
+    return nullptr;
+  }
+
+  Expr::EvalResult val;
+  if (BO->getLHS()->EvaluateAsRValue(val, Ctx) && !val.HasSideEffects) {
+    factor = val.Val;
+    constant = BO->getLHS();
+    return BO->getRHS();
+  }
+  if (BO->getRHS()->EvaluateAsRValue(val, Ctx) && !val.HasSideEffects) {
+    factor = val.Val;
+    constant = BO->getRHS();
+    return BO->getLHS();
+  }
+  return nullptr;
+}
+
+
+// check if two constant factors are equal
+static bool isSameFactor(const APValue &lhs, const APValue &rhs) {
+  if (lhs.isInt() && rhs.isInt()) {
+    return lhs.getInt() == rhs.getInt();
+  }
+  if (lhs.isFloat() && rhs.isFloat()) {
+    return lhs.getFloat().bitwiseIsEqual(rhs.getFloat());
+  }
+  return false;
+}
+
+
+// check if a statement has no effect, e.g. the iteration of a zero tap
+static bool isEmptyStmt(Stmt *S) {
+  CompoundStmt *CS = dyn_cast<CompoundStmt>(S);
+  if (!CS) {
+    return false;
+  }
+  for (auto stmt : CS->body()) {
+    if (!isEmptyStmt(stmt)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+// compare-exchange of a sorting network, the minimum is stored to lo and the
+// maximum to hi; outputs not required for the selected value are not computed
+struct Comparator {
+  size_t lo, hi;
+  bool min, max;
+};
+
+// Data-independent network selecting the k-th smallest of n values. The 3x3
+// median uses the 19 comparators of Paeth's network, other sizes Batcher's
+// odd-even merge sort. Comparators that do not contribute to the k-th output
+// are removed.
+static std::vector<Comparator> getSelectionNetwork(size_t n, size_t k) {
+  std::vector<Comparator> network;
+  if (n == 9 && k == 4) {
+    const size_t paeth[19][2] = {
+      {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5}, {7, 8},
+      {0, 3}, {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7}, {4, 2}, {6, 4},
+      {4, 2} };
+    for (auto cmp : paeth) {
+      network.push_back({ cmp[0], cmp[1], true, true });
+    }
+  } else {
+    size_t size = 1;
+    while (size < n) {
+      size *= 2;
+    }
+    for (size_t p=1; p<size; p*=2) {
+      for (size_t s=p; s>=1; s/=2) {
+        for (size_t j=s%p; j+s<size; j+=2*s) {
+          for (size_t i=0; i<std::min(s, size-j-s); ++i) {
+            if ((i+j)/(2*p) == (i+j+s)/(2*p) && i+j+s < n) {
+              network.push_back({ i+j, i+j+s, true, true });
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // keep only comparators the k-th output depends on
+  std::vector<bool> required(n, false);
+  required[k] = true;
+  std::vector<Comparator> selection;
+  for (auto it = network.rbegin(); it != network.rend(); ++it) {
+    Comparator cmp = *it;
+    cmp.min = required[cmp.lo];
+    cmp.max = required[cmp.hi];
+    if (cmp.min || cmp.max) {
+      required[cmp.lo] = required[cmp.hi] = true;
+      selection.insert(selection.begin(), cmp);
+    }
+  }
+
+  return selection;
+}
+
+
+// index of a tap among the iterated elements of a Mask or Domain
+static size_t getTapIndex(HipaccMask *Mask, size_t x, size_t y) {
+  size_t idx = 0;
+  for (size_t i=0; i<y*Mask->getSizeX()+x; ++i) {
+    if (!Mask->isDomain() || !Mask->isConstant() ||
+        Mask->isDomainDefined(i%Mask->getSizeX(), i/Mask->getSizeX())) {
+      ++idx;
+    }
+  }
+  return idx;
+}
+
+
 // create expression for convolutions
 Stmt *ASTTranslate::getConvolutionStmt(Reduce mode, DeclRefExpr *tmp_var,
     Expr *ret_val) {
   Stmt *result = nullptr;
   FunctionDecl *fun;
   SmallVector<Expr *, 16> funArgs;
+  APValue factor;
+  Expr *constant, *val;
 
   switch (mode) {
     case Reduce::SUM:
+      val = getConstantFactor(Ctx, ret_val, tmp_var->getType(), factor,
+          constant);
+      if (val && factor.isInt()) {
+        llvm::APSInt coef = factor.getInt();
+        bool neg = coef.isSigned() && coef.isNegative();
+        if (neg) {
+          coef = -coef;
+        }
+        if (!coef) {
+          // zero tap: nothing to add
+          return createCompoundStmt(Ctx, ArrayRef<Stmt *>());
+        }
+        // shifting negative values is undefined in C, ap_int shifts bits
+        bool shift = val->getType()->isUnsignedIntegerType() ||
+                     compilerOptions.emitVivado();
+        if (coef.isPowerOf2() && (!coef.logBase2() || shift)) {
+          // red += val; red -= val; red += val << n; red -= val << n;
+          if (coef.logBase2()) {
+            val = createBinaryOperator(Ctx, createParenExpr(Ctx, val),
+                createIntegerLiteral(Ctx, (int)coef.logBase2()), BO_Shl,
+                val->getType());
+          }
+          return createCompoundAssignOperator(Ctx, tmp_var, val,
+              neg ? BO_SubAssign : BO_AddAssign, tmp_var->getType());
+        }
+      } else if (val && factor.isFloat()) {
+        const llvm::APFloat &coef = factor.getFloat();
+        if (coef.isZero()) {
+          // zero tap: nothing to add
+          return createCompoundStmt(Ctx, ArrayRef<Stmt *>());
+        }
+        if (coef.isExactlyValue(1.0) || coef.isExactlyValue(-1.0)) {
+          // red += val; red -= val;
+          return createCompoundAssignOperator(Ctx, tmp_var, val,
+              coef.isNegative() ? BO_SubAssign : BO_AddAssign,
+              tmp_var->getType());
+        }
+      }
       // red += val;
       result = createCompoundAssignOperator(Ctx, tmp_var, ret_val, BO_AddAssign,
           tmp_var->getType());
@@ -80,7 +245,18 @@ Stmt *ASTTranslate::getConvolutionStmt(Reduce mode, DeclRefExpr *tmp_var,
           tmp_var->getType());
       break;
     case Reduce::MEDIAN:
-      assert(0 && "Unsupported convolution mode.");
+      // red_idx = val; the median is selected after the last tap
+      if (tmp_var == convTmp) {
+        result = createBinaryOperator(Ctx, createDeclRefExpr(Ctx,
+              medianTaps[tmp_var][getTapIndex(convMask, convIdxX, convIdxY)]),
+            ret_val, BO_Assign, ret_val->getType());
+      } else {
+        result = createBinaryOperator(Ctx, createDeclRefExpr(Ctx,
+              medianTaps[tmp_var][getTapIndex(redDomains.back(),
+                redIdxX.back(), redIdxY.back())]),
+            ret_val, BO_Assign, ret_val->getType());
+      }
+      break;
   }
 
   return result;
@@ -395,24 +571,50 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
     }
   }
 
-  // init temporary variable depending on aggregation mode
+  // init temporary variable depending on aggregation mode, for the median
+  // all taps are stored to scalar variables, the first one is the temporary
+  QualType QT = LE->getCallOperator()->getReturnType();
   Expr *init = nullptr;
-  switch (method) {
-    case Method::Convolve:
-      init = getInitExpr(convMode, LE->getCallOperator()->getReturnType());
-      break;
-    case Method::Reduce:
-      init = getInitExpr(redModes.back(),
-          LE->getCallOperator()->getReturnType());
-      break;
-    case Method::Iterate: break;
+  bool median = (method==Method::Convolve && convMode==Reduce::MEDIAN) ||
+                (method==Method::Reduce && redModes.back()==Reduce::MEDIAN);
+  size_t numTaps = getTapIndex(Mask, 0, Mask->getSizeY());
+  if (median) {
+    if (Mask->isDomain() && !Mask->isConstant()) {
+      unsigned DiagIDMedian = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+          "Reduce::MEDIAN requires a constant Domain.");
+      Diags.Report(E->getArg(0)->getExprLoc(), DiagIDMedian);
+      exit(EXIT_FAILURE);
+    }
+    assert(numTaps && "Domain without elements.");
+  } else {
+    switch (method) {
+      case Method::Convolve:
+        init = getInitExpr(convMode, QT);
+        break;
+      case Method::Reduce:
+        init = getInitExpr(redModes.back(), QT);
+        break;
+      case Method::Iterate: break;
+    }
   }
   std::string tmp_lit("_tmp" + std::to_string(literalCount++));
-  VarDecl *tmp_decl = createVarDecl(Ctx, kernelDecl, tmp_lit,
-      LE->getCallOperator()->getReturnType(), init);
+  VarDecl *tmp_decl = createVarDecl(Ctx, kernelDecl, tmp_lit, QT, init);
   DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
   DC->addDecl(tmp_decl);
   DeclRefExpr *tmp_dre = createDeclRefExpr(Ctx, tmp_decl);
+  SmallVector<VarDecl *, 16> taps;
+  if (median) {
+    // scalars instead of an array are kept in registers by Vivado HLS
+    // without partitioning
+    taps.push_back(tmp_decl);
+    for (size_t i=1; i<numTaps; ++i) {
+      VarDecl *tap_decl = createVarDecl(Ctx, kernelDecl, tmp_lit + "_" +
+          std::to_string(i), QT, nullptr);
+      DC->addDecl(tap_decl);
+      taps.push_back(tap_decl);
+    }
+    medianTaps[tmp_dre] = taps;
+  }
 
   // check if current lambda expression contains an break_iterate
   containsBreak.push_back(searchForBreakIterate(LE->getBody()));
@@ -443,6 +645,22 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
       redDomains.push_back(Mask);
       break;
   }
+  for (size_t i=1; i<taps.size(); ++i) {
+    preStmts.push_back(createDeclStmt(Ctx, taps[i]));
+    preCStmt.push_back(outerCompountStmt);
+  }
+
+  // taps of constant masks sharing the same coefficient, e.g. of symmetric
+  // masks, are summed up first and multiplied only once
+  ReturnStmt *convRet = nullptr;
+  CompoundStmt *convBody = dyn_cast<CompoundStmt>(LE->getBody());
+  if (method==Method::Convolve && convMode==Reduce::SUM &&
+      Mask->isConstant() && convBody && convBody->size()==1) {
+    convRet = dyn_cast<ReturnStmt>(*convBody->body_begin());
+  }
+  SmallVector<Stmt *, 16> tapStmts;
+  SmallVector<APValue, 16> tapFactors;
+  SmallVector<Expr *, 16> tapConstants, tapSums;
 
   // unroll Mask/Domain
   for (size_t y=0; y<Mask->getSizeY(); ++y) {
@@ -460,6 +678,45 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
           case Method::Convolve:
             convIdxX = x;
             convIdxY = y;
+            if (convRet) {
+              // translate the tap, border handling statements go first
+              curCStmt = convBody;
+              Expr *ret_val = Clone(convRet->getRetValue());
+              for (size_t i=0; i<preStmts.size(); ) {
+                if (preCStmt[i]==convBody) {
+                  tapStmts.push_back(preStmts[i]);
+                  preStmts.erase(preStmts.begin() + i);
+                  preCStmt.erase(preCStmt.begin() + i);
+                } else {
+                  ++i;
+                }
+              }
+              curCStmt = outerCompountStmt;
+
+              APValue factor;
+              Expr *constant;
+              Expr *val = getConstantFactor(Ctx, ret_val, tmp_dre->getType(),
+                  factor, constant);
+              if (!val) {
+                tapStmts.push_back(getConvolutionStmt(convMode, tmp_dre,
+                      ret_val));
+                break;
+              }
+              size_t i = 0;
+              while (i<tapFactors.size() &&
+                     !isSameFactor(tapFactors[i], factor)) {
+                ++i;
+              }
+              if (i==tapFactors.size()) {
+                tapFactors.push_back(factor);
+                tapConstants.push_back(constant);
+                tapSums.push_back(val);
+              } else {
+                tapSums[i] = createBinaryOperator(Ctx, tapSums[i], val, BO_Add,
+                    val->getType());
+              }
+              break;
+            }
             iteration = Clone(LE->getBody());
             break;
           case Method::Reduce:
@@ -481,15 +738,89 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
             redIdxY.pop_back();
             break;
         }
-        preStmts.push_back(iteration);
-        preCStmt.push_back(outerCompountStmt);
+        // iterations of zero taps are empty
+        if (iteration && !isEmptyStmt(iteration)) {
+          preStmts.push_back(iteration);
+          preCStmt.push_back(outerCompountStmt);
+        }
         // clear decls added while cloning last iteration
         LambdaDeclMap.clear();
       }
     }
   }
 
+  if (convRet) {
+    // red += coef * (val0 + val1 + ...);
+    for (size_t i=0; i<tapSums.size(); ++i) {
+      Expr *sum = tapSums[i];
+      if (isa<BinaryOperator>(sum)) {
+        sum = createParenExpr(Ctx, sum);
+      }
+      Stmt *tap = getConvolutionStmt(convMode, tmp_dre,
+          createBinaryOperator(Ctx, tapConstants[i], sum, BO_Mul,
+            sum->getType()));
+      if (!isEmptyStmt(tap)) {
+        tapStmts.push_back(tap);
+      }
+    }
+    if (!tapStmts.empty()) {
+      preStmts.push_back(createCompoundStmt(Ctx, tapStmts));
+      preCStmt.push_back(outerCompountStmt);
+    }
+  }
+
+  if (median) {
+    // select the median by a data-independent network of min/max operations
+    FunctionDecl *min = lookup<FunctionDecl>(std::string("min"), QT,
+        hipaccMathNS);
+    FunctionDecl *max = lookup<FunctionDecl>(std::string("max"), QT,
+        hipaccMathNS);
+    assert(min && max && "could not lookup 'min' and 'max'");
+
+    auto getTap = [&] (size_t idx) -> Expr * {
+      return createImplicitCastExpr(Ctx, QT, CK_LValueToRValue,
+          createDeclRefExpr(Ctx, taps[idx]), nullptr, VK_RValue);
+    };
+    auto select = [&] (FunctionDecl *fun, Expr *lhs, Expr *rhs) -> Expr * {
+      SmallVector<Expr *, 16> funArgs;
+      funArgs.push_back(lhs);
+      funArgs.push_back(rhs);
+      return createFunctionCall(Ctx, fun, funArgs);
+    };
+
+    for (auto cmp : getSelectionNetwork(numTaps, numTaps/2)) {
+      Stmt *exchange = nullptr;
+      if (cmp.min && cmp.max) {
+        // T t = red_lo; red_lo = min(t, red_hi); red_hi = max(t, red_hi);
+        std::string cmp_lit("_tmp" + std::to_string(literalCount++));
+        VarDecl *cmp_decl = createVarDecl(Ctx, kernelDecl, cmp_lit, QT,
+            getTap(cmp.lo));
+        DC->addDecl(cmp_decl);
+        SmallVector<Stmt *, 16> stmts;
+        stmts.push_back(createDeclStmt(Ctx, cmp_decl));
+        stmts.push_back(createBinaryOperator(Ctx, createDeclRefExpr(Ctx,
+                taps[cmp.lo]), select(min, createDeclRefExpr(Ctx, cmp_decl),
+                  getTap(cmp.hi)), BO_Assign, QT));
+        stmts.push_back(createBinaryOperator(Ctx, createDeclRefExpr(Ctx,
+                taps[cmp.hi]), select(max, createDeclRefExpr(Ctx, cmp_decl),
+                  getTap(cmp.hi)), BO_Assign, QT));
+        exchange = createCompoundStmt(Ctx, stmts);
+      } else if (cmp.min) {
+        // red_lo = min(red_lo, red_hi);
+        exchange = createBinaryOperator(Ctx,
+            createDeclRefExpr(Ctx, taps[cmp.lo]), select(min, getTap(cmp.lo), getTap(cmp.hi)), BO_Assign, QT);
+      } else {
+        // red_hi = max(red_lo, red_hi);
+        exchange = createBinaryOperator(Ctx,
+            createDeclRefExpr(Ctx, taps[cmp.hi]), select(max, getTap(cmp.lo), getTap(cmp.hi)), BO_Assign, QT);
+      }
+      preStmts.push_back(exchange);
+      preCStmt.push_back(outerCompountStmt);
+    }
+  }
+
   // reset global variables
+  medianTaps.erase(tmp_dre);
   switch (method) {
     case Method::Convolve:
       convMask = nullptr;
@@ -520,8 +851,12 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
     case Method::Convolve:
     case Method::Reduce:
       // add ICE for CodeGen
-      return createImplicitCastExpr(Ctx, LE->getCallOperator()->getReturnType(),
-          CK_LValueToRValue, tmp_dre, nullptr, VK_RValue);
+      if (median) {
+        return createImplicitCastExpr(Ctx, QT, CK_LValueToRValue,
+            createDeclRefExpr(Ctx, taps[numTaps/2]), nullptr, VK_RValue);
+      }
+      return createImplicitCastExpr(Ctx, QT, CK_LValueToRValue, tmp_dre,
+          nullptr, VK_RValue);
     case Method::Iterate:
       return nullptr;
     default:
@@ -33,6 +33,9 @@
 
 #include "hipacc/Analysis/HostDataDeps.h"
 
+#include <cmath>
+#include <cstdio>
+
 namespace clang {
 namespace hipacc {
 
@@ -61,20 +64,43 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
         break;
       }
 
-      // TODO: Not yet supported
       // found Pyramid decl
-      //if (compilerClasses.isTypeOfTemplateClass(VD->getType(),
-      //      compilerClasses.Pyramid)) {
-      //  CXXConstructExpr *CCE = dyn_cast<CXXConstructExpr>(VD->getInit());
+      if (compilerClasses.isTypeOfTemplateClass(VD->getType(),
+            compilerClasses.Pyramid)) {
+        if (DEBUG) std::cout << "  Tracked Pyramid declaration: "
+                  << VD->getNameAsString() << std::endl;
+
+        CXXConstructExpr *CCE = dyn_cast<CXXConstructExpr>(VD->getInit());
+        assert(CCE->getNumArgs() == 2 &&
+               "Pyramid definition requires exactly two arguments!");
+
+        DeclRefExpr *DRE =
+            dyn_cast<DeclRefExpr>(CCE->getArg(0)->IgnoreParenCasts());
+        assert(DRE && imgDeclMap_.count(DRE->getDecl()) &&
+               "First Pyramid argument is not an Image");
+
+        // the pipeline is unrolled for each level
+        int depth = evaluateInt(CCE->getArg(1));
+        if (depth < 1) {
+          DiagnosticsEngine &Diags = Context.getDiagnostics();
+          unsigned DiagIDDepth = Diags.getCustomDiagID(
+              DiagnosticsEngine::Error,
+              "Depth of pyramid %0 has to be positive.");
+          Diags.Report(CCE->getArg(1)->getExprLoc(), DiagIDDepth)
+            << VD->getName();
+          exit(EXIT_FAILURE);
+        }
+
+        HipaccPyramid *Pyr = new HipaccPyramid(Context, VD,
+            compilerClasses.getFirstTemplateType(VD->getType()));
 
-      //  HipaccPyramid *Pyr = new HipaccPyramid(Context, VD,
-      //      compilerClasses.getFirstTemplateType(VD->getType()));
+        // store Pyramid definition
+        pyrDeclMap_[VD] = Pyr;
 
-      //  // store Pyramid definition
-      //  pyrDeclMap_[VD] = Pyr;
+        dataDeps.addPyramid(VD, DRE->getDecl(), depth);
 
-      //  break;
-      //}
+        break;
+      }
 
       // found BoundaryCondition decl
       if (compilerClasses.isTypeOfTemplateClass(VD->getType(),
@@ -86,7 +112,8 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
 
         HipaccBoundaryCondition *BC = nullptr;
         HipaccImage *Img = nullptr;
-        //HipaccPyramid *Pyr = nullptr;
+        ValueDecl *PVD = nullptr;
+        int relative = 0;
 
         // check if the first argument is an Image
         if (isa<DeclRefExpr>(CCE->getArg(0))) {
@@ -101,21 +128,13 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
           }
         }
 
-        // TODO: Not yet supported
         // check if the first argument is a Pyramid call
-        //if (isa<CXXOperatorCallExpr>(CCE->getArg(0)) &&
-        //    isa<DeclRefExpr>(dyn_cast<CXXOperatorCallExpr>(
-        //        CCE->getArg(0))->getArg(0))) {
-        //  CXXOperatorCallExpr *COCE =
-        //    dyn_cast<CXXOperatorCallExpr>(CCE->getArg(0));
-        //  DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(COCE->getArg(0));
-
-        //  // get the Pyramid from the DRE if we have one
-        //  if (pyrDeclMap_.count(DRE->getDecl())) {
-        //    Pyr = pyrDeclMap_[DRE->getDecl()];
-        //    BC = new HipaccBoundaryCondition(Pyr, VD);
-        //  }
-        //}
+        if (getPyramidCall(CCE->getArg(0), PVD, relative)) {
+          BC = new HipaccBoundaryCondition(VD, pyrDeclMap_[PVD]);
+
+          dataDeps.addBoundaryCondition(VD, BC,
+              dataDeps.getPyramidImage(PVD, level_ + relative));
+        }
 
         break;
       }
@@ -132,7 +151,8 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
         HipaccAccessor *Acc = nullptr;
         HipaccBoundaryCondition *BC = nullptr;
         HipaccImage *Img = nullptr;
-        //HipaccPyramid *Pyr = nullptr;
+        ValueDecl *PVD = nullptr;
+        int relative = 0;
 
         // check if the first argument is an Image
         DeclRefExpr *DRE = nullptr;
@@ -160,31 +180,41 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
           }
         }
 
-        // TODO: Not yet supported
         // check if the first argument is a Pyramid call
-        //if (isa<CXXOperatorCallExpr>(CCE->getArg(0)) &&
-        //    isa<DeclRefExpr>(dyn_cast<CXXOperatorCallExpr>(
-        //        CCE->getArg(0))->getArg(0))) {
-        //  DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(
-        //      dyn_cast<CXXOperatorCallExpr>(CCE->getArg(0))->getArg(0));
-
-        //  // get the Pyramid from the DRE if we have one
-        //  if (pyrDeclMap_.count(DRE->getDecl())) {
-        //    Pyr = pyrDeclMap_[DRE->getDecl()];
-        //    BC = new HipaccBoundaryCondition(Pyr, VD);
-
-        //    bcDeclMap_[VD] = BC;
-        //  }
-        //}
+        if (getPyramidCall(CCE->getArg(0), PVD, relative)) {
+          if (DEBUG) std::cout << "    -> Based on Pyramid: "
+                  << PVD->getNameAsString() << "(" << relative << ")"
+                  << std::endl;
+
+          BC = new HipaccBoundaryCondition(VD, pyrDeclMap_[PVD]);
 
-        // TODO: Read from arguments
+          bcDeclMap_[VD] = BC;
+        }
+
+        // interpolation is applied when reading another pyramid level
         Interpolate mode = Interpolate::NO;
+        for (auto arg : CCE->arguments()) {
+          if (auto ARG = dyn_cast<DeclRefExpr>(arg->IgnoreParenCasts())) {
+            if (ARG->getDecl()->getKind() == Decl::EnumConstant &&
+                ARG->getDecl()->getType().getAsString() ==
+                "enum hipacc::Interpolate") {
+              mode = static_cast<Interpolate>(
+                  ARG->EvaluateKnownConstInt(Context).getZExtValue());
+            }
+          }
+        }
 
         Acc = new HipaccAccessor(VD, BC, mode, false);
 
         // store Accessor definition
         accDeclMap_[VD] = Acc;
 
+        if (PVD != nullptr) {
+          dataDeps.addAccessor(VD, Acc,
+              dataDeps.getPyramidImage(PVD, level_ + relative));
+          break;
+        }
+
         assert(DRE != nullptr && "First Accessor argument is not a BC or Image");
         dataDeps.addAccessor(VD, Acc, DRE->getDecl());
 
@@ -201,7 +231,8 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
 
         HipaccIterationSpace *IS = nullptr;
         HipaccImage *Img = nullptr;
-        //HipaccPyramid *Pyr = nullptr;
+        ValueDecl *PVD = nullptr;
+        int relative = 0;
 
         // check if the first argument is an Image
         if (isa<DeclRefExpr>(CCE->getArg(0))) {
@@ -219,20 +250,17 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
           }
         }
 
-        // TODO: Not yet supported
         // check if the first argument is a Pyramid call
-        //if (isa<CXXOperatorCallExpr>(CCE->getArg(0)) &&
-        //    isa<DeclRefExpr>(dyn_cast<CXXOperatorCallExpr>(
-        //        CCE->getArg(0))->getArg(0))) {
-        //  DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(
-        //      dyn_cast<CXXOperatorCallExpr>(CCE->getArg(0))->getArg(0));
-
-        //  // get the Pyramid from the DRE if we have one
-        //  if (pyrDeclMap_.count(DRE->getDecl())) {
-        //    Pyr = pyrDeclMap_[DRE->getDecl()];
-        //    IS = new HipaccIterationSpace(Pyr, VD);
-        //  }
-        //}
+        if (getPyramidCall(CCE->getArg(0), PVD, relative)) {
+          if (DEBUG) std::cout << "    -> Based on Pyramid: "
+                  << PVD->getNameAsString() << "(" << relative << ")"
+                  << std::endl;
+
+          IS = new HipaccIterationSpace(VD, pyrDeclMap_[PVD], false);
+
+          dataDeps.addIterationSpace(VD, IS,
+              dataDeps.getPyramidImage(PVD, level_ + relative));
+        }
 
         // store IterationSpace
         iterDeclMap_[VD] = IS;
@@ -311,9 +339,269 @@ void DependencyTracker::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
                   << std::endl;
           dataDeps.runKernel(DRE->getDecl());
         }
+        if (CRD->getNameAsString() == "Kernel" &&
+            E->getMethodDecl()->getNameAsString() == "binned_data") {
+          dataDeps.binKernel(DRE->getDecl(), getNumBins(E, DRE->getDecl()));
+        }
+      }
+    }
+  }
+}
+
+
+static Stmt *getLambdaBody(Stmt *S) {
+  if (S == nullptr) {
+    return nullptr;
+  }
+  if (LambdaExpr *LE = dyn_cast<LambdaExpr>(S)) {
+    return LE->getBody();
+  }
+  for (auto it = S->child_begin(); it != S->child_end(); ++it) {
+    if (Stmt *body = getLambdaBody(*it)) {
+      return body;
+    }
+  }
+  return nullptr;
+}
+
+
+// Kernels executed within a traversal are unrolled for each pyramid level: the
+// function passed to traverse() is visited on the top level and again on the
+// next level wherever it recursively calls traverse().
+void DependencyTracker::VisitCallExpr(CallExpr *E) {
+  FunctionDecl *FD = E->getDirectCallee();
+  if (FD == nullptr || FD->getNameAsString() != "traverse") {
+    return;
+  }
+
+  Stmt *func = nullptr;
+  if (E->getNumArgs() > 0) {
+    func = getLambdaBody(E->getArg(E->getNumArgs() - 1));
+  }
+
+  if (traverseBody_ == nullptr) {
+    // traverse(P0, ..., Pn, [&] { ... })
+    assert(func && "Expected function as last argument of traverse");
+    for (unsigned i = 0; i + 1 < E->getNumArgs(); ++i) {
+      DeclRefExpr *DRE =
+          dyn_cast<DeclRefExpr>(E->getArg(i)->IgnoreParenCasts());
+      assert(DRE && pyrDeclMap_.count(DRE->getDecl()) &&
+             "Expected Pyramids as arguments of traverse");
+      traverseDepth_ = dataDeps.getPyramidDepth(DRE->getDecl());
+    }
+    if (DEBUG) std::cout << "  Tracked traversal of depth: "
+            << traverseDepth_ << std::endl;
+
+    traverseBody_ = func;
+    level_ = 0;
+    unrollTraversalScope(traverseBody_);
+    traverseBody_ = nullptr;
+  } else {
+    // recursion to the next level: traverse([loop[, func]])
+    size_t loop = 1;
+    if (E->getNumArgs() > 0 && !isa<CXXDefaultArgExpr>(E->getArg(0))) {
+      loop = evaluateInt(E->getArg(0));
+    }
+    if (level_ + 1 < traverseDepth_) {
+      ++level_;
+      for (size_t i = 0; i < loop; ++i) {
+        unrollTraversalScope(traverseBody_);
+        if (func && i + 1 < loop) {
+          unrollTraversalScope(func);
+        }
       }
+      --level_;
+    }
+  }
+}
+
+
+// Declarations within the traversal function are local to each of its calls.
+void DependencyTracker::unrollTraversalScope(Stmt *body) {
+  auto accDeclMap = accDeclMap_;
+  auto imgDeclMap = imgDeclMap_;
+  auto iterDeclMap = iterDeclMap_;
+  auto bcDeclMap = bcDeclMap_;
+  auto accMap = dataDeps.accMap_;
+  auto imgMap = dataDeps.imgMap_;
+  auto iterMap = dataDeps.iterMap_;
+  auto bcMap = dataDeps.bcMap_;
+  auto kernelMap = dataDeps.kernelMap_;
+
+  unrollTraversal(body);
+
+  accDeclMap_ = accDeclMap;
+  imgDeclMap_ = imgDeclMap;
+  iterDeclMap_ = iterDeclMap;
+  bcDeclMap_ = bcDeclMap;
+  dataDeps.accMap_ = accMap;
+  dataDeps.imgMap_ = imgMap;
+  dataDeps.iterMap_ = iterMap;
+  dataDeps.bcMap_ = bcMap;
+  dataDeps.kernelMap_ = kernelMap;
+}
+
+
+// Visits the statements of the traversal function on the current level,
+// conditions may only depend on the level.
+void DependencyTracker::unrollTraversal(Stmt *S) {
+  if (S == nullptr) {
+    return;
+  }
+  if (ExprWithCleanups *EWC = dyn_cast<ExprWithCleanups>(S)) {
+    S = EWC->getSubExpr();
+  }
+
+  if (CompoundStmt *CS = dyn_cast<CompoundStmt>(S)) {
+    for (auto it = CS->body_begin(); it != CS->body_end(); ++it) {
+      unrollTraversal(*it);
     }
+    return;
   }
+
+  if (IfStmt *IS = dyn_cast<IfStmt>(S)) {
+    if (evaluateLevelCondition(IS->getCond())) {
+      unrollTraversal(IS->getThen());
+    } else {
+      unrollTraversal(IS->getElse());
+    }
+    return;
+  }
+
+  if (isa<ForStmt>(S) || isa<WhileStmt>(S) || isa<DoStmt>(S) ||
+      isa<SwitchStmt>(S)) {
+    DiagnosticsEngine &Diags = Context.getDiagnostics();
+    unsigned DiagIDLoop = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Loops and switch statements within traversals are not supported "
+        "for Vivado.");
+    Diags.Report(S->getLocStart(), DiagIDLoop);
+    exit(EXIT_FAILURE);
+  }
+
+  Visit(S);
+}
+
+
+bool DependencyTracker::evaluateLevelCondition(Expr *E) {
+  E = E->IgnoreParenImpCasts();
+
+  if (UnaryOperator *UO = dyn_cast<UnaryOperator>(E)) {
+    if (UO->getOpcode() == UO_LNot) {
+      return !evaluateLevelCondition(UO->getSubExpr());
+    }
+  }
+
+  if (BinaryOperator *BO = dyn_cast<BinaryOperator>(E)) {
+    switch (BO->getOpcode()) {
+      default: break;
+      case BO_LAnd:
+        return evaluateLevelCondition(BO->getLHS()) &&
+               evaluateLevelCondition(BO->getRHS());
+      case BO_LOr:
+        return evaluateLevelCondition(BO->getLHS()) ||
+               evaluateLevelCondition(BO->getRHS());
+    }
+  }
+
+  if (CXXMemberCallExpr *MCE = dyn_cast<CXXMemberCallExpr>(E)) {
+    std::string name = MCE->getMethodDecl()->getNameAsString();
+    if (name == "is_top_level") {
+      return level_ == 0;
+    }
+    if (name == "is_bottom_level") {
+      return level_ + 1 == traverseDepth_;
+    }
+  }
+
+  bool result;
+  if (!E->EvaluateAsBooleanCondition(result, Context)) {
+    DiagnosticsEngine &Diags = Context.getDiagnostics();
+    unsigned DiagIDCond = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Only is_top_level() and is_bottom_level() are supported as "
+        "conditions within traversals for Vivado.");
+    Diags.Report(E->getExprLoc(), DiagIDCond);
+    exit(EXIT_FAILURE);
+  }
+  return result;
+}
+
+
+int DependencyTracker::evaluateInt(Expr *E) {
+  llvm::APSInt result;
+  if (!E->EvaluateAsInt(result, Context)) {
+    DiagnosticsEngine &Diags = Context.getDiagnostics();
+    unsigned DiagIDConst = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Pyramid depth, level indices, and traversal loop counts have to be "
+        "constant for Vivado.");
+    Diags.Report(E->getExprLoc(), DiagIDConst);
+    exit(EXIT_FAILURE);
+  }
+  return (int)result.getSExtValue();
+}
+
+
+// Number of bins requested by binned_data() of kernel VD, the histogram is
+// computed within hipaccRun and has to be the same for all calls.
+size_t DependencyTracker::getNumBins(CXXMemberCallExpr *E, ValueDecl *VD) {
+  DiagnosticsEngine &Diags = Context.getDiagnostics();
+  llvm::APSInt result;
+  if (!E->getArg(0)->EvaluateAsInt(result, Context) ||
+      result.getSExtValue() < 1) {
+    unsigned DiagIDBins = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Number of bins of kernel %0 has to be a positive constant for "
+        "Vivado.");
+    Diags.Report(E->getArg(0)->getExprLoc(), DiagIDBins) << VD->getName();
+    exit(EXIT_FAILURE);
+  }
+  size_t numBins = (size_t)result.getSExtValue();
+
+  assert(dataDeps.kernelMap_.count(VD) && "Kernel was not declared");
+  HostDataDeps::Kernel *kernel = dataDeps.kernelMap_[VD];
+  if (kernel->getNumBins() != 0 && kernel->getNumBins() != numBins) {
+    unsigned DiagIDBins = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Histograms of kernel %0 with %1 and %2 bins are not supported for "
+        "Vivado.");
+    Diags.Report(E->getArg(0)->getExprLoc(), DiagIDBins) << VD->getName()
+      << (unsigned)kernel->getNumBins() << (unsigned)numBins;
+    exit(EXIT_FAILURE);
+  }
+  if (kernel->hasReduceFunction()) {
+    unsigned DiagIDReduce = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Kernel %0 with reduce and binning function is not supported for "
+        "Vivado.");
+    Diags.Report(E->getExprLoc(), DiagIDReduce) << VD->getName();
+    exit(EXIT_FAILURE);
+  }
+
+  return numBins;
+}
+
+
+// Matches pyramid calls P(relative).
+bool DependencyTracker::getPyramidCall(Expr *E, ValueDecl *&PVD,
+    int &relative) {
+  CXXOperatorCallExpr *COCE =
+      dyn_cast<CXXOperatorCallExpr>(E->IgnoreParenCasts());
+  if (COCE == nullptr || COCE->getNumArgs() != 2) {
+    return false;
+  }
+
+  DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(COCE->getArg(0)->IgnoreParenCasts());
+  if (DRE == nullptr || !pyrDeclMap_.count(DRE->getDecl())) {
+    return false;
+  }
+  if (!traverseBody_) {
+    DiagnosticsEngine &Diags = Context.getDiagnostics();
+    unsigned DiagIDLevel = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Pyramid levels accessed outside of traversals are not supported for "
+        "Vivado.");
+    Diags.Report(E->getExprLoc(), DiagIDLevel);
+    exit(EXIT_FAILURE);
+  }
+
+  PVD = DRE->getDecl();
+  relative = evaluateInt(COCE->getArg(1));
+  return true;
 }
 
 
@@ -323,11 +611,37 @@ void HostDataDeps::addImage(ValueDecl *VD, HipaccImage *img) {
 }
 
 
+void HostDataDeps::addPyramid(ValueDecl *PVD, ValueDecl *IVD, size_t depth) {
+  assert(imgMap_.count(IVD) && "Image was not declared");
+  assert(!pyrMap_.count(PVD) && "Duplicate Pyramid declaration");
+  pyrMap_[PVD] = new Pyramid(imgMap_[IVD], depth);
+}
+
+
+HostDataDeps::Image *HostDataDeps::getPyramidImage(ValueDecl *PVD,
+    size_t level) {
+  assert(pyrMap_.count(PVD) && "Pyramid was not declared");
+  return pyrMap_[PVD]->getImage(level);
+}
+
+
+size_t HostDataDeps::getPyramidDepth(ValueDecl *PVD) {
+  assert(pyrMap_.count(PVD) && "Pyramid was not declared");
+  return pyrMap_[PVD]->getDepth();
+}
+
+
 void HostDataDeps::addBoundaryCondition(
     ValueDecl *BCVD, HipaccBoundaryCondition *BC, ValueDecl *IVD) {
   assert(imgMap_.count(IVD) && "Image was not declared");
+  addBoundaryCondition(BCVD, BC, imgMap_[IVD]);
+}
+
+
+void HostDataDeps::addBoundaryCondition(
+    ValueDecl *BCVD, HipaccBoundaryCondition *BC, Image *img) {
   assert(!bcMap_.count(BCVD) && "Duplicate BoundaryCondition declaration");
-  bcMap_[BCVD] = new BoundaryCondition(BC, imgMap_[IVD]);
+  bcMap_[BCVD] = new BoundaryCondition(BC, img);
 }
 
 
@@ -336,10 +650,17 @@ void HostDataDeps::addKernel(
   Kernel *kernel;
   assert(iterMap_.count(ISVD) && "IterationSpace was not declared");
   assert(!kernelMap_.count(KVD) && "Duplicate Kernel declaration");
+  CXXRecordDecl *CRD = KVD->getType()->getAsCXXRecordDecl();
+  bool reduce = false;
+  for (auto method : CRD->methods()) {
+    if (method->getNameAsString() == "reduce") {
+      reduce = true;
+    }
+  }
   kernel = new Kernel(
-      KVD->getType()->getAsCXXRecordDecl()->getNameAsString()
-          .append(KVD->getNameAsString()),
-      iterMap_[ISVD]);
+      CRD->getNameAsString().append(KVD->getNameAsString()),
+      iterMap_[ISVD], reduce);
+  kernel->setLocation(KVD->getLocation());
   for (auto it = AVDS.begin(); it != AVDS.end(); ++it) {
     assert(accMap_.count(*it) && "Accessor was not declared");
     kernel->addAccessor(accMap_[*it]);
@@ -363,6 +684,12 @@ void HostDataDeps::addAccessor(
     }
   }
 
+  addAccessor(AVD, acc, img);
+}
+
+
+void HostDataDeps::addAccessor(
+    ValueDecl *AVD, HipaccAccessor *acc, Image *img) {
   assert(!accMap_.count(AVD) && "Duplicate Accessor declaration");
   accMap_[AVD] = new Accessor(acc, img);
 }
@@ -371,8 +698,14 @@ void HostDataDeps::addAccessor(
 void HostDataDeps::addIterationSpace(
     ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD) {
   assert(imgMap_.count(IVD) && "Image was not declared");
+  addIterationSpace(ISVD, iter, imgMap_[IVD]);
+}
+
+
+void HostDataDeps::addIterationSpace(
+    ValueDecl *ISVD, HipaccIterationSpace *iter, Image *img) {
   assert(!iterMap_.count(ISVD) && "Duplicate IterationSpace declaration");
-  iterMap_[ISVD] = new IterationSpace(iter, imgMap_[IVD]);
+  iterMap_[ISVD] = new IterationSpace(iter, img);
 }
 
 
@@ -380,6 +713,7 @@ void HostDataDeps::runKernel(ValueDecl *VD) {
   assert(kernelMap_.count(VD) && "Kernel was not declared");
 
   Kernel *kernel = kernelMap_[VD];
+  size_t level = kernel->getIterationSpace()->getImage()->getLevel();
 
   // Create new process and output space
   Space *space = new Space(kernel->getIterationSpace()->getImage());
@@ -408,10 +742,21 @@ void HostDataDeps::runKernel(ValueDecl *VD) {
       }
     }
     if (s == nullptr) {
+      if ((*it)->getImage()->getLevel() != 0) {
+        unsigned DiagIDLevel = diags_->getCustomDiagID(
+            DiagnosticsEngine::Error,
+            "Accessor %0 reads pyramid level %1 before it was written.");
+        diags_->Report((*it)->getLocation(), DiagIDLevel) << (*it)->getName()
+          << (unsigned)(*it)->getImage()->getLevel();
+        exit(EXIT_FAILURE);
+      }
       s = new Space((*it)->getImage());
       (*it)->setSpace(s);
       spaces_.push_back(s);
     }
+    if ((*it)->getImage()->getLevel() != level) {
+      s = resampleSpace(s, *it, kernel);
+    }
     s->addDstProcess(proc);
     proc->addInputSpace(s);
   }
@@ -428,6 +773,71 @@ void HostDataDeps::runKernel(ValueDecl *VD) {
 }
 
 
+// The histogram of a kernel's result is computed within hipaccRun if the
+// number of bins is requested by binned_data(), see
+// DependencyTracker::getNumBins.
+void HostDataDeps::binKernel(ValueDecl *VD, size_t numBins) {
+  assert(kernelMap_.count(VD) && "Kernel was not declared");
+  kernelMap_[VD]->setNumBins(numBins);
+}
+
+
+// Accessors reading another pyramid level than the one iterated by the kernel
+// get their own stream, which is resampled to the size of the iteration space
+// by an additional process.
+HostDataDeps::Space *HostDataDeps::resampleSpace(Space *s, Accessor *acc,
+    Kernel *kernel) {
+  size_t from = acc->getImage()->getLevel();
+  size_t to = kernel->getIterationSpace()->getImage()->getLevel();
+  Interpolate mode = acc->getInterpolationMode();
+
+  if (from != to + 1 && to != from + 1) {
+    unsigned DiagIDLevel = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+        "Accessor %0 reads level %1 from level %2, only adjacent pyramid "
+        "levels are supported for Vivado.");
+    diags_->Report(acc->getLocation(), DiagIDLevel) << acc->getName()
+      << (unsigned)from << (unsigned)to;
+    exit(EXIT_FAILURE);
+  }
+  if (mode != Interpolate::NN && mode != Interpolate::LF) {
+    unsigned DiagIDMode = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+        "Accessor %0 reads another pyramid level, only nearest neighbor and "
+        "linear filtering are supported for Vivado.");
+    diags_->Report(acc->getLocation(), DiagIDMode) << acc->getName();
+    exit(EXIT_FAILURE);
+  }
+  if (acc->getImage()->isVectorType() ||
+      compilerOptions.getPixelsPerThread() > 1) {
+    unsigned DiagIDVect = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+        "Accessor %0 reads another pyramid level, vector types and multiple "
+        "pixels per thread are not supported for Vivado.");
+    diags_->Report(acc->getLocation(), DiagIDVect) << acc->getName();
+    exit(EXIT_FAILURE);
+  }
+
+  Image *img = new Image(acc->getImage(), to);
+  Accessor *resampled = new Accessor(acc, img);
+  kernel->replaceAccessor(acc, resampled);
+
+  std::ostringstream name;
+  name << (to < from ? "Upsample" : "Downsample") << resampleId++;
+  Kernel *resample = new Kernel(name.str(), new IterationSpace(nullptr, img));
+  resample->addAccessor(acc);
+
+  Space *space = new Space(img);
+  Process *proc = new Process(resample, space);
+  proc->resample = mode;
+  space->setSrcProcess(proc);
+  spaces_.push_back(space);
+  processes_.push_back(proc);
+
+  s->addDstProcess(proc);
+  proc->addInputSpace(s);
+
+  return space;
+}
+
+
 void HostDataDeps::dump(Process *proc) {
   std::cout << " <- " << proc->getKernel()->getName();
 
@@ -517,7 +927,7 @@ std::string HostDataDeps::createStream(Space *s) {
 
   if (s->getSrcProcess() == nullptr && s->stream.empty()) {
     stream = "_strm" + s->getImage()->getName();
-  } else if (s->getDstProcesses().empty()) {
+  } else if (s->getDstProcesses().empty() && !isReducedSpace(s)) {
     std::ostringstream var;
     var << "_strmOut" << outId;
     ++outId;
@@ -577,169 +987,2010 @@ void HostDataDeps::createSchedule() {
 
   outId = tmpId = 0;
   for (auto it = outSpaces.begin(); it != outSpaces.end(); ++it) {
+    if ((*it)->getImage()->getLevel() != 0) {
+      unsigned DiagIDLevel = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+          "Level %0 of pyramid %1 is read after the traversal, pyramid levels "
+          "have to be consumed within the traversal for Vivado.");
+      diags_->Report((*it)->getImage()->getLocation(), DiagIDLevel)
+        << (unsigned)(*it)->getImage()->getLevel()
+        << (*it)->getImage()->getName();
+      exit(EXIT_FAILURE);
+    }
     markSpace(*it);
   }
 }
 
 
-std::string HostDataDeps::getEntrySignature(
-    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
-    bool withTypes) {
-  std::ostringstream retVal;
-  if (withTypes) {
-    retVal << "void ";
+// A process whose result is read by several processes writes one copy of the
+// result per consumer itself, instead of being followed by a splitStream
+// stage. Vectorized kernels are restricted to a single output stream, as are
+// kernels executed several times, e.g. once per pyramid level.
+bool HostDataDeps::writesStreamCopies(Process *proc) {
+  Space *s = proc->getOutSpace();
+  if (s->getDstProcesses().size() < 2 ||
+      compilerOptions.getPixelsPerThread() > 1 ||
+      s->getImage()->isVectorType() || isSharedSpace(s)) {
+    return false;
   }
-  retVal << "hipaccRun(";
 
-  std::vector<Space*> out = getOutputSpaces();
-  for (auto it = out.begin(); it != out.end(); ++it) {
-    if (it != out.begin()) {
-      retVal << ", ";
-    }
-    if (withTypes) {
-      retVal << "hls::stream<" << getTypeStr(*it) << " > &";
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    if (*it != proc && (*it)->getKernel()->getName() ==
+                       proc->getKernel()->getName()) {
+      return false;
     }
-    retVal << (*it)->stream;
   }
 
-  std::vector<Space*> in = getInputSpaces();
+  std::vector<Space*> in = proc->getInSpaces();
   for (auto it = in.begin(); it != in.end(); ++it) {
-    retVal << ", ";
-    if (withTypes) {
-      retVal << "hls::stream<" << getTypeStr(*it) << " > &";
+    if ((*it)->getImage()->isVectorType()) {
+      return false;
     }
-    retVal << (*it)->stream;
   }
 
-  for (auto it = args.begin(); it != args.end(); ++it) {
-    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      retVal << ", ";
-      if (withTypes) {
-        retVal << it2->first << " ";
-      }
-      retVal << it2->second;
-    }
-  }
+  return true;
+}
 
-  retVal << ")";
 
-  return retVal.str();
+HostDataDeps::ProcessInfo *HostDataDeps::getProcessInfo(Process *proc) {
+  auto it = processInfo_.find(getKernelName(proc));
+  if (it == processInfo_.end()) {
+    return nullptr;
+  }
+  return &it->second;
 }
 
 
-std::string HostDataDeps::prettyPrint(
-    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
-    bool print) {
-  std::ostringstream retVal;
-  std::string indent = "";
-
-  retVal << indent << getEntrySignature(args, true) << " {" << std::endl;
-  retVal << "#pragma HLS dataflow" << std::endl;
+// Only kernels already printed by Rewrite and operating on scalar pixels take
+// part in the fusion.
+bool HostDataDeps::isFusable(Process *proc) {
+  ProcessInfo *info = getProcessInfo(proc);
+  return info && !info->vect;
+}
 
-  indent = "  ";
 
-  //int cpyId = 0;
-  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
-    if ((*it)->isSpace()) {
-      Space *s = (Space*)*it;
-      if (s->cpyStreams.size() > 0) {
-        for (auto it2 = s->cpyStreams.begin();
-                  it2 != s->cpyStreams.end(); ++it2) {
-          retVal << indent << "hls::stream<" << getTypeStr(s) << " > " << *it2 << ";"
-                 << std::endl;
-        }
-#define NICO_LIB
-#ifdef NICO_LIB
-        retVal << indent << "splitStream";
-        if (compilerOptions.getPixelsPerThread() > 1) {
-          retVal << "VECT";
-        }
-        retVal << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_WINDOW_SIZE_X,HIPACC_WINDOW_SIZE_Y";
-        if (compilerOptions.getPixelsPerThread() > 1) {
-          retVal << ",HIPACC_PPT";
-        }
-        retVal << ">(" << s->stream;
-        for (auto it2 = s->cpyStreams.begin();
-                  it2 != s->cpyStreams.end(); ++it2) {
-          retVal << ", " << *it2;
-        }
-        retVal << ", HIPACC_MAX_WIDTH, HIPACC_MAX_HEIGHT);" << std::endl;
-#else // NICO_LIB
-        retVal << indent << "for (int i = 0; i < HIPACC_MAX_WIDTH*HIPACC_MAX_HEIGHT; ++i) {"
-               << std::endl;
-        retVal << indent << indent << getTypeStr(s) << " val;"
-               << std::endl;
-        retVal << indent << indent << s->stream << " >> val;" << std::endl;
-        for (auto it2 = s->cpyStreams.begin();
-                  it2 != s->cpyStreams.end(); ++it2) {
-          retVal << indent << indent << *it2 << " << val;" << std::endl;
-        }
-        retVal << indent << "}"
-               << std::endl;
-#endif // NICO_LIB
+// The last point operator fused into the output of a process writes the
+// resulting streams.
+HostDataDeps::Process *HostDataDeps::getFusedOutput(Process *proc) {
+  if (proc->outputMap.empty()) {
+    return proc;
+  }
+  return proc->outputMap.back();
+}
 
-        //std::ostringstream var;
-        //var << "_strmCpy" << cpyId;
-        //++cpyId;
 
-        //retVal << indent << getTypeStr(s) << " " << var.str() << ";"
-        //       << std::endl;
-        //retVal << indent << s->stream << " >> " << var.str() << ";"
-        //       << std::endl;
-        //for (auto it2 = s->cpyStreams.begin();
-        //          it2 != s->cpyStreams.end(); ++it2) {
-        //  retVal << indent << "stream<" << getTypeStr(s) << "> " << *it2 << ";"
-        //         << std::endl;
-        //  retVal << indent << *it2 << " << " << var.str() << ";"
-        //         << std::endl;
-        //}
-      }
+// Collects the streams read by a process including the inputs of the point
+// operators fused into its inputs.
+void HostDataDeps::getFusedInputs(Process *proc,
+    std::vector<std::string> &streams, std::vector<Space*> &spaces) {
+  std::vector<Space*> in = proc->getInSpaces();
+  for (size_t i = 0; i < in.size() && i < proc->inStreams.size(); ++i) {
+    if (proc->inputMap[i]) {
+      getFusedInputs(proc->inputMap[i], streams, spaces);
     } else {
-      Process *t = (Process*)*it;
-      if (!t->getOutSpace()->getDstProcesses().empty()) {
-        // do not print out stream (because it is function argument)
-        retVal << indent << "hls::stream<"
-               << getTypeStr(t->getOutSpace()) << " > " << t->outStream << ";"
-               << std::endl;
-      }
-      retVal << indent << "cc" << t->getKernel()->getName() << "Kernel(";
-      retVal << t->outStream;
-      for (auto it2 = t->inStreams.begin();
-                it2 != t->inStreams.end(); ++it2) {
-        retVal << ", " << *it2;
-      }
-      if (args.find("cc" + t->getKernel()->getName() + "Kernel") != args.end()) {
-        std::vector<std::pair<std::string,std::string>> a =
-            args["cc" + t->getKernel()->getName() + "Kernel"];
-        for (auto it2 = a.begin(); it2 != a.end(); ++it2) {
-          retVal << ", " << it2->second;
-        }
-      }
-      retVal << ", HIPACC_MAX_WIDTH, HIPACC_MAX_HEIGHT);" << std::endl;
+      streams.push_back(proc->inStreams[i]);
+      spaces.push_back(in[i]);
     }
   }
+}
 
-  indent = "";
-  retVal << indent << "}" << std::endl;
 
-  if (print) {
-    std::cout << retVal.str() << std::endl;
+void HostDataDeps::getFusedProcesses(Process *proc,
+    std::vector<Process*> &procs) {
+  for (auto it = proc->inputMap.begin(); it != proc->inputMap.end(); ++it) {
+    if (*it) {
+      procs.push_back(*it);
+      getFusedProcesses(*it, procs);
+    }
   }
-
-  return retVal.str();
 }
 
 
-std::string HostDataDeps::printEntryDecl(
-    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
-  return getEntrySignature(args, true) + ";\n";
-}
-
+// Fuses the point operator proc into the process reading its result. Fails if
+// the result is read more than once or if the fused process would read
+// streams of different types.
+bool HostDataDeps::fuseInput(Process *proc, Process *consumer) {
+  std::vector<Space*> in = consumer->getInSpaces();
+  size_t slot = in.size();
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (in[i] == proc->getOutSpace()) {
+      if (slot != in.size()) {
+        return false;
+      }
+      slot = i;
+    }
+  }
+  if (slot == in.size()) {
+    return false;
+  }
+
+  consumer->inputMap[slot] = proc;
+  proc->fusedInto = consumer;
+
+  Process *root = consumer;
+  while (root->fusedInto) {
+    root = root->fusedInto;
+  }
+
+  std::vector<std::string> streams;
+  std::vector<Space*> spaces;
+  getFusedInputs(root, streams, spaces);
+  for (auto it = spaces.begin(); it != spaces.end(); ++it) {
+    if (getResolvedTypeStr(*it) != getResolvedTypeStr(spaces.front())) {
+      consumer->inputMap[slot] = nullptr;
+      proc->fusedInto = nullptr;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// Point operators are merged into neighbouring processes, avoiding a dataflow
+// process and an intermediate stream per operator: first into the process
+// reading their result, otherwise into the process producing their input.
+void HostDataDeps::fuseProcesses() {
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    proc->fusedInto = nullptr;
+    proc->inputMap.assign(proc->getInSpaces().size(), nullptr);
+    proc->outputMap.clear();
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+      Process *proc = *it;
+      if (proc->fusedInto || !isFusable(proc) ||
+          getProcessInfo(proc)->local) {
+        continue;
+      }
+
+      std::vector<Process*> dst = proc->getOutSpace()->getDstProcesses();
+      if (dst.size() == 1 && isFusable(dst.front()) &&
+          fuseInput(proc, dst.front())) {
+        changed = true;
+      }
+    }
+  }
+
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    if (proc->fusedInto || !isFusable(proc) ||
+        getProcessInfo(proc)->local || proc->getInSpaces().size() != 1 ||
+        proc->inputMap.front()) {
+      continue;
+    }
+
+    Space *s = proc->getInSpaces().front();
+    Process *src = s->getSrcProcess();
+    if (!src || s->getDstProcesses().size() != 1 || !isFusable(src)) {
+      continue;
+    }
+
+    // separable kernels compute the result without calling the kernel
+    Process *root = src->fusedInto ? src->fusedInto : src;
+    if (!getProcessInfo(root)->sepCoef.empty()) {
+      continue;
+    }
+
+    root->outputMap.push_back(proc);
+    proc->fusedInto = root;
+    for (auto it2 = proc->outputMap.begin(); it2 != proc->outputMap.end();
+              ++it2) {
+      root->outputMap.push_back(*it2);
+      (*it2)->fusedInto = root;
+    }
+    proc->outputMap.clear();
+  }
+}
+
+
+// Declaration of an entry argument; array types such as the coefficients of
+// non-constant masks carry their extents after the name
+static std::string printArgDecl(std::string type, std::string name) {
+  size_t pos = type.find(" [");
+  if (pos == std::string::npos) {
+    return type + " " + name;
+  }
+  return type.substr(0, pos) + " " + name + type.substr(pos + 1);
+}
+
+
+std::string HostDataDeps::printInputMap(Process *proc, size_t slot,
+    std::map<Process*,std::string> &member, size_t &rawId) {
+  Process *src = proc->inputMap[slot];
+  if (!src) {
+    std::ostringstream raw;
+    raw << "raw[" << rawId++ << "]";
+    return raw.str();
+  }
+
+  std::string retVal = member[src] + "(";
+  for (size_t i = 0; i < src->inputMap.size(); ++i) {
+    if (i) {
+      retVal += ", ";
+    }
+    retVal += printInputMap(src, i, member, rawId);
+  }
+  return retVal + ")";
+}
+
+
+// Prints the functor and the entry function of a process with fused point
+// operators. The functor maps the pixels read from the streams to the kernel
+// inputs and applies the fused operators to the kernel result.
+std::string HostDataDeps::printFusedProcess(Process *proc, std::string name,
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  std::ostringstream retVal;
+
+  std::vector<Process*> procs(1, proc);
+  getFusedProcesses(proc, procs);
+  procs.insert(procs.end(), proc->outputMap.begin(), proc->outputMap.end());
+
+  std::map<Process*,std::string> member;
+  member[proc] = "kernel";
+  for (size_t i = 1; i < procs.size(); ++i) {
+    std::ostringstream var;
+    var << "p" << i-1;
+    member[procs[i]] = var.str();
+  }
+
+  ProcessInfo *info = getProcessInfo(proc);
+  Process *last = getFusedOutput(proc);
+  std::string outType = getProcessInfo(last)->outType;
+  size_t numIn = proc->getInSpaces().size();
+  size_t numOut = writesStreamCopies(last) ?
+      last->getOutSpace()->getDstProcesses().size() : 1;
+
+  std::vector<std::string> streams;
+  std::vector<Space*> spaces;
+  getFusedInputs(proc, streams, spaces);
+  std::string rawType = getTypeStr(spaces.front());
+
+  // functor
+  if (procs.size() > 1) {
+    retVal << "// point operators fused into " << getKernelName(proc) << "\n";
+  } else {
+    retVal << "// " << getKernelName(proc) << " writing a single stream\n";
+  }
+  retVal << "struct " << name << "Kernel {\n";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    retVal << "  " << getKernelName(*it) << "Kernel &" << member[*it] << ";\n";
+  }
+  retVal << "\n  " << name << "Kernel(";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << getKernelName(*it) << "Kernel &" << member[*it];
+  }
+  retVal << ")\n      : ";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << member[*it] << "(" << member[*it] << ")";
+  }
+  retVal << " {}\n\n";
+
+  size_t rawId = 0;
+  retVal << "  void operator()(const " << rawType << " raw[" << spaces.size()
+         << "], " << info->inType << " in[" << numIn << "]) {\n";
+  for (size_t i = 0; i < numIn; ++i) {
+    retVal << "    in[" << i << "] = "
+           << printInputMap(proc, i, member, rawId) << ";\n";
+  }
+  retVal << "  }\n\n";
+
+  std::string result = "kernel(";
+  retVal << "  " << outType << " operator()(";
+  for (size_t i = 0; i < numIn; ++i) {
+    if (i) {
+      retVal << ", ";
+      result += ", ";
+    }
+    std::ostringstream var;
+    var << "in" << i;
+    retVal << info->inType << " " << var.str();
+    if (info->local) {
+      retVal << "[" << info->sizeY << "][" << info->sizeX << "]";
+    }
+    result += var.str();
+  }
+  result += ")";
+  for (auto it = proc->outputMap.begin(); it != proc->outputMap.end(); ++it) {
+    result = member[*it] + "(" + result + ")";
+  }
+  retVal << ") {\n    return " << result << ";\n  }\n};\n\n";
+
+  // entry function
+  retVal << "void " << name << "(";
+  for (size_t i = 0; i < numOut; ++i) {
+    if (i) {
+      retVal << ", ";
+    }
+    retVal << "hls::stream<" << getTypeStr(last->getOutSpace()) << " > &Output";
+    if (i) {
+      retVal << i;
+    }
+  }
+  for (size_t i = 0; i < spaces.size(); ++i) {
+    retVal << ", hls::stream<" << rawType << " > &Input" << i;
+  }
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    std::vector<std::pair<std::string,std::string>> a = args[getKernelName(*it)];
+    for (auto it2 = a.begin(); it2 != a.end(); ++it2) {
+      retVal << ", " << printArgDecl(it2->first,
+                                     member[*it] + "_" + it2->second);
+    }
+  }
+  retVal << ", int IS_width, int IS_height) {\n";
+
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    retVal << "    struct " << getKernelName(*it) << "Kernel " << member[*it];
+    std::vector<std::pair<std::string,std::string>> a = args[getKernelName(*it)];
+    for (auto it2 = a.begin(); it2 != a.end(); ++it2) {
+      retVal << (it2 == a.begin() ? "(" : ", ") << member[*it] << "_"
+             << it2->second;
+    }
+    if (!a.empty()) {
+      retVal << ")";
+    }
+    retVal << ";\n";
+  }
+  retVal << "    struct " << name << "Kernel fused(";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << member[*it];
+  }
+  retVal << ");\n";
+
+  if (!info->sepCoef.empty()) {
+    retVal << info->sepCoef;
+    retVal << "    processMappedSeparable<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,"
+           << "HIPACC_MAX_HEIGHT," << info->sizeX << "," << info->sizeY << ","
+           << info->border << "," << info->sepType << "," << rawType << ","
+           << info->inType << ">(Output, IS_width, IS_height, rowCoef, colCoef, "
+           << "fused";
+  } else {
+    if (info->local) {
+      retVal << "    processMappedMIMO";
+    } else {
+      retVal << "    processPixelsMappedMIMO";
+    }
+    retVal << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,"
+           << info->sizeX << "," << info->sizeY;
+    if (info->local) {
+      retVal << "," << info->border;
+    }
+    retVal << "," << numOut << "," << numIn << "," << rawType << ","
+           << info->inType << "," << outType
+           << ">(IS_width, IS_height, fused, fused";
+    for (size_t i = 0; i < numOut; ++i) {
+      retVal << ", Output";
+      if (i) {
+        retVal << i;
+      }
+    }
+  }
+  for (size_t i = 0; i < spaces.size(); ++i) {
+    retVal << ", Input" << i;
+  }
+  retVal << ");\n}\n\n";
+
+  return retVal.str();
+}
+
+
+std::vector<std::string> HostDataDeps::getOutputStreams(Process *proc) {
+  if (writesStreamCopies(proc)) {
+    return proc->getOutSpace()->cpyStreams;
+  }
+  return std::vector<std::string>(1, proc->outStream);
+}
+
+
+// Local operators that are the only readers of a stream share a single line
+// buffer sized for the largest window instead of buffering copies of the
+// stream each, see processShared. This requires the same border handling for
+// all of them.
+bool HostDataDeps::isSharedSpace(Space *s) {
+  std::vector<Process*> dst = s->getDstProcesses();
+  if (dst.size() < 2) {
+    return false;
+  }
+
+  // the producer has to write a single stream
+  Process *src = s->getSrcProcess();
+  if (src && !isFusable(src)) {
+    return false;
+  }
+
+  auto isNumber = [] (std::string str) {
+    return !str.empty() &&
+           std::all_of(str.begin(), str.end(), [] (char c) {
+             return c >= '0' && c <= '9';
+           });
+  };
+
+  std::string border;
+  for (auto it = dst.begin(); it != dst.end(); ++it) {
+    Process *proc = *it;
+    ProcessInfo *info = getProcessInfo(proc);
+    if (!isFusable(proc) || !info->local || !info->sepCoef.empty() ||
+        proc->fusedInto || proc->getInSpaces().size() != 1 ||
+        (!proc->inputMap.empty() && proc->inputMap.front()) ||
+        !isNumber(info->sizeX) || !isNumber(info->sizeY)) {
+      return false;
+    }
+    if (it != dst.begin() && border != info->border) {
+      return false;
+    }
+    border = info->border;
+  }
+
+  return true;
+}
+
+
+// Prints the functor and the entry function of the local operators sharing
+// the line buffer of a stream. The functor applies each operator to its part
+// of the shared window and writes the results.
+std::string HostDataDeps::printSharedProcess(Space *s, std::string name,
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  std::ostringstream retVal;
+  std::vector<Process*> dst = s->getDstProcesses();
+  std::string inType = getTypeStr(s);
+
+  std::vector<Process*> procs;
+  std::map<Process*,std::string> member;
+  int sizeX = 1, sizeY = 1;
+  for (size_t i = 0; i < dst.size(); ++i) {
+    std::ostringstream var;
+    var << "k" << i;
+    procs.push_back(dst[i]);
+    member[dst[i]] = var.str();
+    for (size_t j = 0; j < dst[i]->outputMap.size(); ++j) {
+      std::ostringstream post;
+      post << var.str() << "_" << j;
+      procs.push_back(dst[i]->outputMap[j]);
+      member[dst[i]->outputMap[j]] = post.str();
+    }
+    sizeX = std::max(sizeX, std::stoi(getProcessInfo(dst[i])->sizeX));
+    sizeY = std::max(sizeY, std::stoi(getProcessInfo(dst[i])->sizeY));
+  }
+
+  // functor
+  retVal << "// local operators sharing the line buffer of " << s->stream
+         << "\n";
+  retVal << "struct " << name << "Kernel {\n";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    retVal << "  " << getKernelName(*it) << "Kernel &" << member[*it] << ";\n";
+  }
+  retVal << "\n  " << name << "Kernel(";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << getKernelName(*it) << "Kernel &" << member[*it];
+  }
+  retVal << ")\n      : ";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << member[*it] << "(" << member[*it] << ")";
+  }
+  retVal << " {}\n\n";
+
+  std::ostringstream outParams, body;
+  for (size_t i = 0; i < dst.size(); ++i) {
+    ProcessInfo *info = getProcessInfo(dst[i]);
+    Process *last = getFusedOutput(dst[i]);
+    std::string outType = getProcessInfo(last)->outType;
+    size_t numOut = getOutputStreams(last).size();
+
+    for (size_t j = 0; j < numOut; ++j) {
+      outParams << ", hls::stream<" << getTypeStr(last->getOutSpace())
+                << " > &Output" << i;
+      if (j) {
+        outParams << "_" << j;
+      }
+    }
+
+    std::string result = member[dst[i]] + "(win" + std::to_string(i) + ")";
+    for (auto it = dst[i]->outputMap.begin(); it != dst[i]->outputMap.end();
+              ++it) {
+      result = member[*it] + "(" + result + ")";
+    }
+    body << "    " << inType << " win" << i << "[" << info->sizeY << "]["
+         << info->sizeX << "];\n";
+    body << "    getSubWindow<" << sizeX << "," << sizeY << "," << info->sizeX
+         << "," << info->sizeY << ">(win, win" << i << ");\n";
+    body << "    " << outType << " res" << i << " = " << result << ";\n";
+    for (size_t j = 0; j < numOut; ++j) {
+      body << "    Output" << i;
+      if (j) {
+        body << "_" << j;
+      }
+      body << " << res" << i << ";\n";
+    }
+  }
+  retVal << "  void operator()(" << inType << " win[" << sizeY << "]["
+         << sizeX << "]" << outParams.str() << ") {\n" << body.str()
+         << "  }\n};\n\n";
+
+  // entry function
+  retVal << "void " << name << "(hls::stream<" << inType << " > &Input"
+         << outParams.str();
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    std::vector<std::pair<std::string,std::string>> a = args[getKernelName(*it)];
+    for (auto it2 = a.begin(); it2 != a.end(); ++it2) {
+      retVal << ", " << printArgDecl(it2->first,
+                                     member[*it] + "_" + it2->second);
+    }
+  }
+  retVal << ", int IS_width, int IS_height) {\n";
+
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    retVal << "    struct " << getKernelName(*it) << "Kernel " << member[*it];
+    std::vector<std::pair<std::string,std::string>> a = args[getKernelName(*it)];
+    for (auto it2 = a.begin(); it2 != a.end(); ++it2) {
+      retVal << (it2 == a.begin() ? "(" : ", ") << member[*it] << "_"
+             << it2->second;
+    }
+    if (!a.empty()) {
+      retVal << ")";
+    }
+    retVal << ";\n";
+  }
+  retVal << "    struct " << name << "Kernel shared(";
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if (it != procs.begin()) {
+      retVal << ", ";
+    }
+    retVal << member[*it];
+  }
+  retVal << ");\n";
+
+  retVal << "    processShared<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,"
+         << "HIPACC_MAX_HEIGHT," << sizeX << "," << sizeY << ","
+         << getProcessInfo(dst.front())->border << "," << inType
+         << ">(IS_width, IS_height, shared, Input";
+  for (size_t i = 0; i < dst.size(); ++i) {
+    size_t numOut = getOutputStreams(getFusedOutput(dst[i])).size();
+    for (size_t j = 0; j < numOut; ++j) {
+      retVal << ", Output" << i;
+      if (j) {
+        retVal << "_" << j;
+      }
+    }
+  }
+  retVal << ");\n}\n\n";
+
+  return retVal.str();
+}
+
+
+// The result of a kernel with reduce function is consumed by a streaming
+// reduction within hipaccRun, only the reduced value is returned. The same
+// applies to histograms, only the bins are returned.
+bool HostDataDeps::isReducedSpace(Space *s) {
+  Process *src = s->getSrcProcess();
+  if (!src || (!src->getKernel()->hasReduceFunction() &&
+               !src->getKernel()->getNumBins())) {
+    return false;
+  }
+  if (!s->getDstProcesses().empty()) {
+    unsigned DiagIDReduce = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+        "Result of kernel %0 with reduce or binning function read by other "
+        "kernels is not supported for Vivado.");
+    diags_->Report(src->getKernel()->getLocation(), DiagIDReduce)
+      << src->getKernel()->getName();
+    exit(EXIT_FAILURE);
+  }
+  return true;
+}
+
+
+// Prints the functor and the entry function reducing the result of proc at
+// one pixel per cycle, see processReduce.
+std::string HostDataDeps::printReduceProcess(Process *proc, std::string name) {
+  std::ostringstream retVal;
+  std::string type = getTypeStr(proc->getOutSpace());
+
+  retVal << "// streaming reduction of the result of " << getKernelName(proc)
+         << "\n";
+  retVal << "struct " << name << "Kernel {\n";
+  retVal << "  " << type << " operator()(" << type << " left, " << type
+         << " right) {\n";
+  retVal << "    return cc" << proc->getKernel()->getName()
+         << "Reduce(left, right);\n";
+  retVal << "  }\n};\n\n";
+
+  retVal << "void " << name << "(hls::stream<" << type << " > &Input, "
+         << type << " &Output, int IS_width, int IS_height) {\n";
+  retVal << "    struct " << name << "Kernel reduce;\n";
+  retVal << "    processReduce<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,"
+         << "HIPACC_MAX_HEIGHT,HIPACC_REDUCE_LATENCY," << type
+         << ">(Input, Output, IS_width, IS_height, reduce);\n";
+  retVal << "}\n\n";
+
+  return retVal.str();
+}
+
+
+// Prints the functor and the entry function computing the histogram of the
+// result of proc at one pixel per cycle, see processBinning.
+std::string HostDataDeps::printBinningProcess(Process *proc, std::string name) {
+  std::ostringstream retVal;
+  std::string type = getTypeStr(proc->getOutSpace());
+  size_t numBins = proc->getKernel()->getNumBins();
+
+  retVal << "// streaming histogram of the result of " << getKernelName(proc)
+         << "\n";
+  retVal << "struct " << name << "Kernel {\n";
+  retVal << "  uint operator()(" << type << " pixel, uint num_bins) {\n";
+  retVal << "    return cc" << proc->getKernel()->getName()
+         << "Binning(pixel, num_bins);\n";
+  retVal << "  }\n};\n\n";
+
+  retVal << "void " << name << "(hls::stream<" << type << " > &Input, "
+         << "uint Output[" << numBins << "], int IS_width, int IS_height) {\n";
+  retVal << "    struct " << name << "Kernel binning;\n";
+  retVal << "    processBinning<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,"
+         << "HIPACC_MAX_HEIGHT,HIPACC_BINNING_BANKS," << numBins << ","
+         << type << ">(Input, Output, IS_width, IS_height, binning);\n";
+  retVal << "}\n\n";
+
+  return retVal.str();
+}
+
+
+// Size of the frames streamed through s, pyramid levels are half the size of
+// the level above.
+std::string HostDataDeps::printSize(Space *s) {
+  size_t level = s->getImage()->getLevel();
+  if (level == 0) {
+    return "width, height";
+  }
+  std::ostringstream size;
+  size << "width >> " << level << ", height >> " << level;
+  return size.str();
+}
+
+
+// default depth of Vivado HLS streams
+static const size_t DEFAULT_STREAM_DEPTH = 2;
+
+
+// Window size given by the template parameter str, max if not a literal
+static size_t getWindowSize(std::string str, size_t max) {
+  if (str.empty() ||
+      !std::all_of(str.begin(), str.end(), [] (char c) {
+        return c >= '0' && c <= '9';
+      })) {
+    return max;
+  }
+  return (size_t)std::stoul(str);
+}
+
+
+// Latency of a process in stream elements: a local operator emits its first
+// result after reading GDELAY_Y rows plus GDELAY_X pixels of its input. Lower
+// pyramid levels are streamed at a quarter of the rate of the level above,
+// their latencies are given in elements of the top level.
+size_t HostDataDeps::getProcessDelay(Process *proc) {
+  if (proc->resample != Interpolate::NO) {
+    // linear filtering waits for the next row (downsampling) or the next two
+    // rows (upsampling) of its input, see downsampleStream and upsampleStream
+    size_t in = proc->getInSpaces().front()->getImage()->getLevel();
+    size_t out = proc->getOutSpace()->getImage()->getLevel();
+    if (proc->resample == Interpolate::NN) {
+      return 0;
+    }
+    if (out > in) {
+      return (maxImageWidth_ << in) + ((size_t)1 << (2 * in));
+    }
+    return maxImageWidth_ << (in + 1);
+  }
+
+  ProcessInfo *info = getProcessInfo(proc);
+  if (!info || !info->local) {
+    return 0;
+  }
+
+  size_t ppt = compilerOptions.getPixelsPerThread();
+  size_t delayX = getWindowSize(info->sizeX, maxWindowSizeX_) / 2;
+  size_t delayY = getWindowSize(info->sizeY, maxWindowSizeY_) / 2;
+  size_t level = proc->getOutSpace()->getImage()->getLevel();
+
+  return (delayY * ((maxImageWidth_ + ppt - 1) / ppt) << level) +
+         ((delayX + ppt - 1) / ppt << (2 * level));
+}
+
+
+// Columns left and right of a strip required to compute its pixels: the sum
+// of the window radii along the path with the largest one, rounded to whole
+// words of the streams.
+size_t HostDataDeps::computeStripHalo() {
+  std::map<Space*, size_t> halo;
+  size_t maxHalo = 0;
+
+  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
+    if ((*it)->isSpace()) {
+      continue;
+    }
+    Process *t = (Process*)*it;
+    if (t->resample != Interpolate::NO ||
+        isPyramidImage(t->getOutSpace()->getImage())) {
+      unsigned DiagIDStrip = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+          "Image %0 is a pyramid level, strip-mining of image pyramids is "
+          "not supported for Vivado.");
+      diags_->Report(t->getOutSpace()->getImage()->getLocation(), DiagIDStrip)
+        << t->getOutSpace()->getImage()->getName();
+      exit(EXIT_FAILURE);
+    }
+    if (t->getKernel()->hasReduceFunction() || t->getKernel()->getNumBins()) {
+      unsigned DiagIDStrip = diags_->getCustomDiagID(DiagnosticsEngine::Error,
+          "Kernel %0 has a reduce or binning function, strip-mining of "
+          "reductions and histograms is not supported for Vivado.");
+      diags_->Report(t->getKernel()->getLocation(), DiagIDStrip)
+        << t->getKernel()->getName();
+      exit(EXIT_FAILURE);
+    }
+
+    size_t in = 0;
+    std::vector<Space*> inSpaces = t->getInSpaces();
+    for (auto it2 = inSpaces.begin(); it2 != inSpaces.end(); ++it2) {
+      in = std::max(in, halo[*it2]);
+    }
+    ProcessInfo *info = getProcessInfo(t);
+    if (info && info->local) {
+      in += getWindowSize(info->sizeX, maxWindowSizeX_) / 2;
+    }
+    halo[t->getOutSpace()] = in;
+    maxHalo = std::max(maxHalo, in);
+  }
+
+  size_t ppt = compilerOptions.getPixelsPerThread();
+  return (maxHalo + ppt - 1) / ppt * ppt;
+}
+
+
+void HostDataDeps::setMaxSizes(size_t imageWidth, size_t imageHeight,
+    size_t windowSizeX, size_t windowSizeY) {
+  maxImageWidth_ = maxFrameWidth_ = imageWidth;
+  maxImageHeight_ = imageHeight;
+  maxWindowSizeX_ = windowSizeX;
+  maxWindowSizeY_ = windowSizeY;
+  stripWidth_ = stripHalo_ = 0;
+
+  if (compilerOptions.useStrips()) {
+    size_t ppt = compilerOptions.getPixelsPerThread();
+    stripWidth_ = (compilerOptions.getStripWidth() + ppt - 1) / ppt * ppt;
+    stripHalo_ = computeStripHalo();
+    maxImageWidth_ = std::min(imageWidth, stripWidth_ + 2 * stripHalo_);
+  }
+}
+
+
+// Paths of different latency reconverging in a process have to be balanced
+// by the streams of the faster paths, otherwise the process stalls on the
+// slower input and the producers of the faster ones block on full streams.
+// Each input stream gets the difference between the latest and its own
+// arrival in addition to the default depth.
+void HostDataDeps::computeStreamDepths() {
+  std::map<Space*, size_t> latency;
+
+  streamDepth_.clear();
+  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
+    if ((*it)->isSpace()) {
+      continue;
+    }
+    Process *t = (Process*)*it;
+    if (t->fusedInto) {
+      continue;
+    }
+
+    std::vector<std::string> inStreams;
+    std::vector<Space*> inSpaces;
+    getFusedInputs(t, inStreams, inSpaces);
+
+    size_t arrival = 0;
+    for (auto it2 = inSpaces.begin(); it2 != inSpaces.end(); ++it2) {
+      arrival = std::max(arrival, latency[*it2]);
+    }
+    for (size_t i = 0; i < inStreams.size(); ++i) {
+      size_t scale = (size_t)1 << (2 * inSpaces[i]->getImage()->getLevel());
+      streamDepth_[inStreams[i]] =
+          (arrival - latency[inSpaces[i]] + scale - 1) / scale +
+          DEFAULT_STREAM_DEPTH;
+    }
+
+    // processes sharing a line buffer emit their results in lockstep after
+    // the delay of the largest window
+    size_t delay = getProcessDelay(t);
+    if (inSpaces.size() == 1 && isSharedSpace(inSpaces.front())) {
+      std::vector<Process*> dst = inSpaces.front()->getDstProcesses();
+      for (auto it2 = dst.begin(); it2 != dst.end(); ++it2) {
+        delay = std::max(delay, getProcessDelay(*it2));
+      }
+    }
+    latency[getFusedOutput(t)->getOutSpace()] = arrival + delay;
+  }
+}
+
+
+std::string HostDataDeps::printStreamDecl(std::string type, std::string stream,
+    std::string indent) {
+  std::ostringstream retVal;
+  size_t depth = DEFAULT_STREAM_DEPTH;
+  if (streamDepth_.find(stream) != streamDepth_.end()) {
+    depth = streamDepth_[stream];
+  }
+  retVal << indent << "hls::stream<" << type << " > " << stream << "(\""
+         << stream << "\");" << std::endl;
+  retVal << indent << "HIPACC_STREAM_DEPTH(" << stream << ", " << depth << ")"
+         << std::endl;
+  return retVal.str();
+}
+
+
+// Signature or call of the entry function. With memory ports or in video
+// mode, hipaccRun transfers the frames of its memory ports or video streams
+// from and to the streams of hipaccRunStreams, which is selected by streams.
+std::string HostDataDeps::getEntrySignature(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
+    bool withTypes, std::string img, bool streams) {
+  std::ostringstream retVal;
+  bool ports = compilerOptions.useMemoryPorts() && !streams;
+  bool video = compilerOptions.useVideoMode() && !streams;
+  if (withTypes) {
+    retVal << "void ";
+  }
+  if ((compilerOptions.useMemoryPorts() || compilerOptions.useVideoMode()) &&
+      streams) {
+    retVal << "hipaccRunStreams(";
+  } else {
+    retVal << "hipaccRun(";
+  }
+
+  auto printStream = [&] (Space *s) {
+    if (ports) {
+      if (withTypes) {
+        retVal << getTypeStr(s) << " *" << s->stream << "_port";
+      } else {
+        retVal << s->stream << ".data()";
+      }
+    } else if (video && withTypes) {
+      retVal << "hls::stream<HipaccVideo<" << getTypeStr(s) << " > > &"
+             << s->stream << "_video";
+    } else {
+      if (withTypes) {
+        retVal << "hls::stream<" << getTypeStr(s) << " > &";
+      }
+      retVal << s->stream;
+    }
+  };
+
+  std::vector<Space*> out = getOutputSpaces();
+  bool comma = false;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (isReducedSpace(*it)) {
+      continue;
+    }
+    if (comma) {
+      retVal << ", ";
+    }
+    printStream(*it);
+    comma = true;
+  }
+
+  // reduced values
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      continue;
+    }
+    if (comma) {
+      retVal << ", ";
+    }
+    Kernel *kernel = (*it)->getSrcProcess()->getKernel();
+    if (kernel->getNumBins()) {
+      // histograms are returned in arrays
+      retVal << (withTypes ? "uint " : "") << "_bin" << kernel->getName();
+      if (withTypes) {
+        retVal << "[" << kernel->getNumBins() << "]";
+      } else if (!streams) {
+        retVal << ".data()";
+      }
+    } else {
+      if (withTypes) {
+        retVal << getTypeStr(*it) << " &";
+      }
+      retVal << "_red" << kernel->getName();
+    }
+    comma = true;
+  }
+
+  std::vector<Space*> in = getInputSpaces();
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << ", ";
+    printStream(*it);
+  }
+
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      retVal << ", ";
+      retVal << (withTypes ? printArgDecl(it2->first, it2->second) :
+                             it2->second);
+    }
+  }
+
+  // actual frame size, bounds the trip count of all stages at runtime
+  if (img.empty() && !in.empty()) {
+    // reduced values only, take the size from the first input image
+    img = in.front()->getImage()->getName();
+  }
+  if (withTypes) {
+    retVal << ", const int width, const int height";
+  } else if (streams) {
+    retVal << ", width, height";
+  } else {
+    retVal << ", " << img << ".width, " << img << ".height";
+  }
+
+  retVal << ")";
+
+  return retVal.str();
+}
+
+
+std::string HostDataDeps::prettyPrint(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
+    bool print) {
+  std::ostringstream retVal;
+  std::ostringstream fused;
+  std::string indent = "";
+  int fusedId = 0;
+
+  resolveStreamTypes();
+  fuseProcesses();
+  computeStreamDepths();
+
+  retVal << indent << getEntrySignature(args, true, "", true) << " {"
+         << std::endl;
+  retVal << "#pragma HLS dataflow" << std::endl;
+  // each process runs on its own thread when simulated with vivado_sim
+  retVal << "HIPACC_DATAFLOW_BEGIN" << std::endl;
+
+  indent = "  ";
+
+  //int cpyId = 0;
+  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
+    if ((*it)->isSpace()) {
+      Space *s = (Space*)*it;
+      if (isSharedSpace(s)) {
+        std::vector<Process*> dst = s->getDstProcesses();
+        std::vector<std::string> outStreams;
+        for (auto it2 = dst.begin(); it2 != dst.end(); ++it2) {
+          Process *last = getFusedOutput(*it2);
+          std::vector<std::string> streams = getOutputStreams(last);
+          if (!last->getOutSpace()->getDstProcesses().empty()) {
+            for (auto it3 = streams.begin(); it3 != streams.end(); ++it3) {
+              retVal << printStreamDecl(getTypeStr(last->getOutSpace()), *it3,
+                                        indent);
+            }
+          }
+          outStreams.insert(outStreams.end(), streams.begin(), streams.end());
+        }
+
+        std::ostringstream name;
+        name << "ccShared" << fusedId++ << "Kernel";
+        fused << printSharedProcess(s, name.str(), args);
+        retVal << indent << "HIPACC_PROCESS(" << name.str() << "("
+               << s->stream;
+        for (auto it2 = outStreams.begin(); it2 != outStreams.end(); ++it2) {
+          retVal << ", " << *it2;
+        }
+        for (auto it2 = dst.begin(); it2 != dst.end(); ++it2) {
+          std::vector<Process*> procs(1, *it2);
+          procs.insert(procs.end(), (*it2)->outputMap.begin(),
+                       (*it2)->outputMap.end());
+          for (auto it3 = procs.begin(); it3 != procs.end(); ++it3) {
+            if (args.find(getKernelName(*it3)) != args.end()) {
+              std::vector<std::pair<std::string,std::string>> a =
+                  args[getKernelName(*it3)];
+              for (auto it4 = a.begin(); it4 != a.end(); ++it4) {
+                retVal << ", " << it4->second;
+              }
+            }
+          }
+        }
+        retVal << ", " << printSize(s) << "));" << std::endl;
+      } else if (s->cpyStreams.size() > 0 &&
+          !(s->getSrcProcess() && writesStreamCopies(s->getSrcProcess()))) {
+        for (auto it2 = s->cpyStreams.begin();
+                  it2 != s->cpyStreams.end(); ++it2) {
+          retVal << printStreamDecl(getTypeStr(s), *it2, indent);
+        }
+#define NICO_LIB
+#ifdef NICO_LIB
+        retVal << indent << "HIPACC_PROCESS(splitStream";
+        if (compilerOptions.getPixelsPerThread() > 1) {
+          retVal << "VECT";
+        } else if (s->cpyStreams.size() > 2) {
+          // e.g. pyramid levels read by kernels of both adjacent levels
+          if (s->cpyStreams.size() > 4) {
+            unsigned DiagIDCopies = diags_->getCustomDiagID(
+                DiagnosticsEngine::Error,
+                "Image %0 read by %1 kernels, at most four kernels may read "
+                "the same image for Vivado.");
+            diags_->Report(s->getImage()->getLocation(), DiagIDCopies)
+              << s->getImage()->getName() << (unsigned)s->cpyStreams.size();
+            exit(EXIT_FAILURE);
+          }
+          retVal << s->cpyStreams.size();
+        }
+        retVal << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_WINDOW_SIZE_X,HIPACC_WINDOW_SIZE_Y";
+        if (compilerOptions.getPixelsPerThread() > 1) {
+          retVal << ",HIPACC_PPT";
+        }
+        retVal << ">(" << s->stream;
+        for (auto it2 = s->cpyStreams.begin();
+                  it2 != s->cpyStreams.end(); ++it2) {
+          retVal << ", " << *it2;
+        }
+        retVal << ", " << printSize(s) << "));" << std::endl;
+#else // NICO_LIB
+        retVal << indent << "for (int i = 0; i < width*height; ++i) {"
+               << std::endl;
+        retVal << indent << indent << getTypeStr(s) << " val;"
+               << std::endl;
+        retVal << indent << indent << s->stream << " >> val;" << std::endl;
+        for (auto it2 = s->cpyStreams.begin();
+                  it2 != s->cpyStreams.end(); ++it2) {
+          retVal << indent << indent << *it2 << " << val;" << std::endl;
+        }
+        retVal << indent << "}"
+               << std::endl;
+#endif // NICO_LIB
+
+        //std::ostringstream var;
+        //var << "_strmCpy" << cpyId;
+        //++cpyId;
+
+        //retVal << indent << getTypeStr(s) << " " << var.str() << ";"
+        //       << std::endl;
+        //retVal << indent << s->stream << " >> " << var.str() << ";"
+        //       << std::endl;
+        //for (auto it2 = s->cpyStreams.begin();
+        //          it2 != s->cpyStreams.end(); ++it2) {
+        //  retVal << indent << "stream<" << getTypeStr(s) << "> " << *it2 << ";"
+        //         << std::endl;
+        //  retVal << indent << *it2 << " << " << var.str() << ";"
+        //         << std::endl;
+        //}
+      }
+    } else {
+      Process *t = (Process*)*it;
+      if (t->fusedInto || (t->getInSpaces().size() == 1 &&
+                           isSharedSpace(t->getInSpaces().front()))) {
+        // part of the process it is fused into or sharing its input
+        continue;
+      }
+
+      if (t->resample != Interpolate::NO) {
+        // stream of another pyramid level, resized for the kernel reading it
+        Space *in = t->getInSpaces().front();
+        Space *out = t->getOutSpace();
+        bool up = out->getImage()->getLevel() < in->getImage()->getLevel();
+        retVal << printStreamDecl(getTypeStr(out), t->outStream, indent);
+        retVal << indent << "HIPACC_PROCESS("
+               << (up ? "upsampleStream" : "downsampleStream")
+               << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,"
+               << (t->resample == Interpolate::LF ? "true" : "false") << ","
+               << getTypeStr(out) << ">(" << t->inStreams.front() << ", "
+               << t->outStream << ", " << printSize(up ? out : in) << "));"
+               << std::endl;
+        continue;
+      }
+
+      std::vector<Process*> procs(1, t);
+      getFusedProcesses(t, procs);
+      procs.insert(procs.end(), t->outputMap.begin(), t->outputMap.end());
+
+      Process *last = getFusedOutput(t);
+      std::vector<std::string> outStreams = getOutputStreams(last);
+      bool reduced = isReducedSpace(last->getOutSpace());
+      if (!last->getOutSpace()->getDstProcesses().empty() || reduced) {
+        // do not print out stream (because it is function argument)
+        for (auto it2 = outStreams.begin(); it2 != outStreams.end(); ++it2) {
+          retVal << printStreamDecl(getTypeStr(last->getOutSpace()), *it2,
+                                    indent);
+        }
+      }
+
+      std::vector<std::string> inStreams;
+      std::vector<Space*> inSpaces;
+      getFusedInputs(t, inStreams, inSpaces);
+
+      // the entry printed by Rewrite writes a copy of the result for each
+      // consumer, which is not needed if they share a line buffer
+      if (procs.size() > 1 || isSharedSpace(last->getOutSpace())) {
+        std::ostringstream name;
+        name << "cc" << t->getKernel()->getName() << "Fused" << fusedId++
+             << "Kernel";
+        fused << printFusedProcess(t, name.str(), args);
+        retVal << indent << "HIPACC_PROCESS(" << name.str() << "(";
+      } else {
+        retVal << indent << "HIPACC_PROCESS(cc" << t->getKernel()->getName()
+               << "Kernel(";
+      }
+      for (auto it2 = outStreams.begin(); it2 != outStreams.end(); ++it2) {
+        if (it2 != outStreams.begin()) {
+          retVal << ", ";
+        }
+        retVal << *it2;
+      }
+      for (auto it2 = inStreams.begin(); it2 != inStreams.end(); ++it2) {
+        retVal << ", " << *it2;
+      }
+      for (auto it2 = procs.begin(); it2 != procs.end(); ++it2) {
+        if (args.find(getKernelName(*it2)) != args.end()) {
+          std::vector<std::pair<std::string,std::string>> a =
+              args[getKernelName(*it2)];
+          for (auto it3 = a.begin(); it3 != a.end(); ++it3) {
+            retVal << ", " << it3->second;
+          }
+        }
+      }
+      retVal << ", " << printSize(t->getOutSpace()) << "));" << std::endl;
+
+      if (reduced && last->getKernel()->getNumBins()) {
+        std::string name = "cc" + last->getKernel()->getName() + "BinningKernel";
+        fused << printBinningProcess(last, name);
+        retVal << indent << "HIPACC_PROCESS(" << name << "(" << last->outStream
+               << ", _bin" << last->getKernel()->getName() << ", "
+               << printSize(last->getOutSpace()) << "));" << std::endl;
+      } else if (reduced) {
+        std::string name = "cc" + last->getKernel()->getName() + "ReduceKernel";
+        fused << printReduceProcess(last, name);
+        retVal << indent << "HIPACC_PROCESS(" << name << "(" << last->outStream
+               << ", _red" << last->getKernel()->getName() << ", "
+               << printSize(last->getOutSpace()) << "));" << std::endl;
+      }
+    }
+  }
+
+  retVal << "HIPACC_DATAFLOW_END" << std::endl;
+  indent = "";
+  retVal << indent << "}" << std::endl;
+
+  if (compilerOptions.useMemoryPorts()) {
+    retVal << std::endl << printMemoryPortEntry(args);
+  }
+  if (compilerOptions.useVideoMode()) {
+    retVal << std::endl << printVideoEntry(args);
+  }
+
+  // functors and entry functions of processes with fused point operators
+  retVal.str(fused.str() + retVal.str());
+
+  if (print) {
+    std::cout << retVal.str() << std::endl;
+  }
+
+  return retVal.str();
+}
+
+
+// Entry function with m_axi interfaces: input frames are read from their
+// memory ports line by line in bursts, streamed through hipaccRunStreams, and
+// the output frames are written back the same way. Scalars and the frame size
+// are passed through the AXI4-Lite control interface.
+std::string HostDataDeps::printMemoryPortEntry(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  std::ostringstream retVal;
+  std::string indent = "  ";
+  std::vector<Space*> in = getInputSpaces();
+  std::vector<Space*> out = getOutputSpaces();
+  int bundle = 0;
+
+  auto printPort = [&] (std::string port) {
+    retVal << "#pragma HLS INTERFACE m_axi port=" << port
+           << " offset=slave bundle=gmem" << bundle++
+           << " max_read_burst_length=" << compilerOptions.getBurstLength()
+           << " num_read_outstanding="
+           << compilerOptions.getOutstandingBursts()
+           << " max_write_burst_length=" << compilerOptions.getBurstLength()
+           << " num_write_outstanding="
+           << compilerOptions.getOutstandingBursts() << std::endl;
+    retVal << "#pragma HLS INTERFACE s_axilite port=" << port
+           << " bundle=control" << std::endl;
+  };
+  auto printControl = [&] (std::string port) {
+    retVal << "#pragma HLS INTERFACE s_axilite port=" << port
+           << " bundle=control" << std::endl;
+  };
+
+  retVal << getEntrySignature(args, true) << " {" << std::endl;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      printPort((*it)->stream + "_port");
+      continue;
+    }
+    Kernel *kernel = (*it)->getSrcProcess()->getKernel();
+    if (kernel->getNumBins()) {
+      printPort("_bin" + kernel->getName());
+    } else {
+      printControl("_red" + kernel->getName());
+    }
+  }
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    printPort((*it)->stream + "_port");
+  }
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      printControl(it2->second);
+    }
+  }
+  printControl("width");
+  printControl("height");
+  printControl("return");
+
+  if (compilerOptions.useStrips()) {
+    // the frame is processed strip by strip, each strip is read with the
+    // halos of its neighbours and only its own columns are written
+    retVal << indent << "for (int x = 0; x < width; x += HIPACC_STRIP_WIDTH) {"
+           << std::endl;
+    retVal << indent << indent << "const int left = x < HIPACC_STRIP_HALO ? "
+           << "x : HIPACC_STRIP_HALO;" << std::endl;
+    retVal << indent << indent << "const int count = width - x < "
+           << "HIPACC_STRIP_WIDTH ? width - x : HIPACC_STRIP_WIDTH;"
+           << std::endl;
+    retVal << indent << indent << "const int right = width - x - count < "
+           << "HIPACC_STRIP_HALO ? width - x - count : HIPACC_STRIP_HALO;"
+           << std::endl;
+    retVal << indent << indent << "hipaccRunStrip(" << printStripArguments(args,
+        false) << "width, x - left, left + count + right, left, count, "
+           << "height);" << std::endl;
+    retVal << indent << "}" << std::endl;
+    retVal << "}" << std::endl;
+
+    return printStripEntry(args) + "\n" + retVal.str();
+  }
+
+  retVal << "#pragma HLS dataflow" << std::endl;
+  retVal << "HIPACC_DATAFLOW_BEGIN" << std::endl;
+
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+  }
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+    }
+  }
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << indent << "HIPACC_PROCESS(readMemoryPort"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << "_port, " << (*it)->stream << ", "
+           << printSize(*it) << "));" << std::endl;
+  }
+  retVal << indent << "HIPACC_PROCESS("
+         << getEntrySignature(args, false, "", true) << ");" << std::endl;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (isReducedSpace(*it)) {
+      continue;
+    }
+    retVal << indent << "HIPACC_PROCESS(writeMemoryPort"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << ", " << (*it)->stream << "_port, "
+           << printSize(*it) << "));" << std::endl;
+  }
+
+  retVal << "HIPACC_DATAFLOW_END" << std::endl;
+  retVal << "}" << std::endl;
+
+  return retVal.str();
+}
+
+
+// Free-running entry function with AXI4-Stream interfaces: frames arrive
+// back to back, the first word of a frame is marked by TUSER and the last word
+// of each line by TLAST. There is no start handshake, each process restarts as
+// soon as it finished its frame, so that the next frame is read while later
+// stages still drain the last one. The frame size and scalars are sampled from
+// the AXI4-Lite control interface once, when the reader of the first input
+// sees TUSER, and are forwarded in-band as HipaccVideoParams to all other
+// processes, so that all stages process a frame with the same parameters.
+std::string HostDataDeps::printVideoEntry(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  std::ostringstream retVal;
+  std::ostringstream params;
+  std::string indent = "  ";
+  std::vector<Space*> in = getInputSpaces();
+  std::vector<Space*> out = getOutputSpaces();
+  int bundle = 0;
+
+  assert(!in.empty() && "Video mode requires an input image");
+
+  auto printControl = [&] (std::string port) {
+    retVal << "#pragma HLS INTERFACE s_axilite port=" << port
+           << " bundle=control" << std::endl;
+  };
+  auto printParamDecl = [&] (std::string type, std::string name) {
+    if (type.compare(0, 6, "const ") == 0) {
+      type = type.substr(6);
+    }
+    params << indent << printArgDecl(type, name) << ";" << std::endl;
+  };
+
+  // parameters of a frame
+  params << "struct HipaccVideoParams {" << std::endl;
+  printParamDecl("int", "width");
+  printParamDecl("int", "height");
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      printParamDecl(it2->first, it2->second);
+    }
+  }
+  params << "};" << std::endl << std::endl;
+
+  // reader of the first input, latches and forwards the parameters
+  std::vector<std::string> paramStreams;
+  for (auto it = in.begin() + 1; it != in.end(); ++it) {
+    paramStreams.push_back((*it)->stream + "_params");
+  }
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      paramStreams.push_back((*it)->stream + "_params");
+    }
+  }
+  Space *first = in.front();
+  params << "// samples the frame size, scalars and coefficients at the start "
+         << "of a frame, the host" << std::endl
+         << "// may only write them between frames" << std::endl;
+  params << "void hipaccReadVideo(hls::stream<HipaccVideo<"
+         << getTypeStr(first) << " > > &" << first->stream << "_video, "
+         << "hls::stream<" << getTypeStr(first) << " > &" << first->stream
+         << ", hls::stream<HipaccVideoParams> &frame_params";
+  for (auto it = paramStreams.begin(); it != paramStreams.end(); ++it) {
+    params << ", hls::stream<HipaccVideoParams> &" << *it;
+  }
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      params << ", " << printArgDecl(it2->first, it2->second);
+    }
+  }
+  params << ", const int width, const int height) {" << std::endl;
+  params << indent << "HipaccVideo<" << getTypeStr(first) << " > word = "
+         << "readVideoStart(" << first->stream << "_video);" << std::endl;
+  params << indent << "HipaccVideoParams params;" << std::endl;
+  params << indent << "latchVideoParam(params.width, width);" << std::endl;
+  params << indent << "latchVideoParam(params.height, height);" << std::endl;
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      params << indent << "latchVideoParam(params." << it2->second << ", "
+             << it2->second << ");" << std::endl;
+    }
+  }
+  params << indent << "frame_params << params;" << std::endl;
+  for (auto it = paramStreams.begin(); it != paramStreams.end(); ++it) {
+    params << indent << *it << " << params;" << std::endl;
+  }
+  size_t level = first->getImage()->getLevel();
+  params << indent << "readVideoFrame"
+         << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+         << first->stream << "_video, " << first->stream << ", word, "
+         << "params.width >> " << level << ", params.height >> " << level
+         << ");" << std::endl;
+  params << "}" << std::endl << std::endl;
+
+  // processes a frame with the parameters latched at its start
+  std::ostringstream frameArgs;
+  std::ostringstream scalarArgs;
+  params << "void hipaccRunFrame(";
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      params << "hls::stream<" << getTypeStr(*it) << " > &" << (*it)->stream
+             << ", ";
+      frameArgs << (*it)->stream << ", ";
+    }
+  }
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      continue;
+    }
+    Kernel *kernel = (*it)->getSrcProcess()->getKernel();
+    if (kernel->getNumBins()) {
+      params << "uint _bin" << kernel->getName() << "["
+             << kernel->getNumBins() << "], ";
+      frameArgs << "_bin" << kernel->getName() << ", ";
+    } else {
+      params << getTypeStr(*it) << " &_red" << kernel->getName() << ", ";
+      frameArgs << "_red" << kernel->getName() << ", ";
+    }
+  }
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    params << "hls::stream<" << getTypeStr(*it) << " > &" << (*it)->stream
+           << ", ";
+    frameArgs << (*it)->stream << ", ";
+  }
+  params << "hls::stream<HipaccVideoParams> &frame_params) {" << std::endl;
+  params << indent << "const HipaccVideoParams params = frame_params.read();"
+         << std::endl;
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      scalarArgs << "params." << it2->second << ", ";
+    }
+  }
+  params << indent << "hipaccRunStreams(" << frameArgs.str()
+         << scalarArgs.str() << "params.width, params.height);" << std::endl;
+  params << "}" << std::endl << std::endl;
+
+  retVal << getEntrySignature(args, true) << " {" << std::endl;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      retVal << "#pragma HLS INTERFACE axis port=" << (*it)->stream
+             << "_video" << std::endl;
+      continue;
+    }
+    Kernel *kernel = (*it)->getSrcProcess()->getKernel();
+    if (kernel->getNumBins()) {
+      retVal << "#pragma HLS INTERFACE m_axi port=_bin" << kernel->getName()
+             << " offset=slave bundle=gmem" << bundle++ << std::endl;
+      printControl("_bin" + kernel->getName());
+    } else {
+      printControl("_red" + kernel->getName());
+    }
+  }
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << "#pragma HLS INTERFACE axis port=" << (*it)->stream << "_video"
+           << std::endl;
+  }
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      printControl(it2->second);
+    }
+  }
+  printControl("width");
+  printControl("height");
+  retVal << "#pragma HLS INTERFACE ap_ctrl_none port=return" << std::endl;
+  retVal << "#pragma HLS dataflow" << std::endl;
+  retVal << "HIPACC_DATAFLOW_BEGIN" << std::endl;
+
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+  }
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+    }
+  }
+  retVal << printStreamDecl("HipaccVideoParams", "frame_params", indent);
+  for (auto it = paramStreams.begin(); it != paramStreams.end(); ++it) {
+    retVal << printStreamDecl("HipaccVideoParams", *it, indent);
+  }
+
+  retVal << indent << "HIPACC_PROCESS(hipaccReadVideo(" << first->stream
+         << "_video, " << first->stream << ", frame_params";
+  for (auto it = paramStreams.begin(); it != paramStreams.end(); ++it) {
+    retVal << ", " << *it;
+  }
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      retVal << ", " << it2->second;
+    }
+  }
+  retVal << ", width, height));" << std::endl;
+  for (auto it = in.begin() + 1; it != in.end(); ++it) {
+    retVal << indent << "HIPACC_PROCESS(readVideoStream"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << "_video, " << (*it)->stream << ", "
+           << (*it)->stream << "_params, " << (*it)->getImage()->getLevel()
+           << "));" << std::endl;
+  }
+  retVal << indent << "HIPACC_PROCESS(hipaccRunFrame(" << frameArgs.str()
+         << "frame_params));" << std::endl;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (isReducedSpace(*it)) {
+      continue;
+    }
+    retVal << indent << "HIPACC_PROCESS(writeVideoStream"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << ", " << (*it)->stream << "_video, "
+           << (*it)->stream << "_params, " << (*it)->getImage()->getLevel()
+           << "));" << std::endl;
+  }
+
+  retVal << "HIPACC_DATAFLOW_END" << std::endl;
+  retVal << "}" << std::endl;
+
+  return params.str() + retVal.str();
+}
+
+
+// Ports and scalars passed from hipaccRun to hipaccRunStrip
+std::string HostDataDeps::printStripArguments(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
+    bool withTypes) {
+  std::ostringstream retVal;
+  std::vector<Space*> ports = getOutputSpaces();
+  std::vector<Space*> in = getInputSpaces();
+  ports.insert(ports.end(), in.begin(), in.end());
+  for (auto it = ports.begin(); it != ports.end(); ++it) {
+    if (withTypes) {
+      retVal << getTypeStr(*it) << " *";
+    }
+    retVal << (*it)->stream << "_port, ";
+  }
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
+      retVal << (withTypes ? printArgDecl(it2->first, it2->second) :
+                             it2->second) << ", ";
+    }
+  }
+  return retVal.str();
+}
+
+
+// Dataflow region processing one strip of the frame: the columns x0 up to
+// x0+width of the frame, of which count columns starting at skip are written
+// back. hipaccRunStreams processes the strip as a frame of width columns.
+std::string HostDataDeps::printStripEntry(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  std::ostringstream retVal;
+  std::string indent = "  ";
+  std::vector<Space*> in = getInputSpaces();
+  std::vector<Space*> out = getOutputSpaces();
+
+  retVal << "void hipaccRunStrip(" << printStripArguments(args, true)
+         << "const int frameWidth, const int x0, const int width, "
+         << "const int skip, const int count, const int height) {"
+         << std::endl;
+  retVal << "#pragma HLS dataflow" << std::endl;
+  retVal << "HIPACC_DATAFLOW_BEGIN" << std::endl;
+
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+  }
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    retVal << printStreamDecl(getTypeStr(*it), (*it)->stream, indent);
+  }
+  for (auto it = in.begin(); it != in.end(); ++it) {
+    retVal << indent << "HIPACC_PROCESS(readMemoryStrip"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << "_port, " << (*it)->stream
+           << ", frameWidth, x0, width, height));" << std::endl;
+  }
+  retVal << indent << "HIPACC_PROCESS("
+         << getEntrySignature(args, false, "", true) << ");" << std::endl;
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    retVal << indent << "HIPACC_PROCESS(writeMemoryStrip"
+           << "<HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT,HIPACC_PPT>("
+           << (*it)->stream << ", " << (*it)->stream
+           << "_port, frameWidth, x0, width, skip, count, height));"
+           << std::endl;
+  }
+
+  retVal << "HIPACC_DATAFLOW_END" << std::endl;
+  retVal << "}" << std::endl;
+
+  return retVal.str();
+}
+
+
+//===----------------------------------------------------------------------===//
+// Resource and latency estimation
+//===----------------------------------------------------------------------===//
+
+// Costs of the operators generated by Vivado HLS for 7-series devices at
+// 100 MHz. Integer operators scale with the bit width, floating-point
+// operators are single-precision cores using DSPs (full DSP implementation).
+static const size_t DSP_WIDTH_A = 25, DSP_WIDTH_B = 18;
+static const size_t INT_MUL_LATENCY = 3;
+static const size_t FLOAT_ADD_DSP = 2, FLOAT_ADD_LUT = 214, FLOAT_ADD_FF = 227;
+static const size_t FLOAT_ADD_LATENCY = 4;
+static const size_t FLOAT_MUL_DSP = 3, FLOAT_MUL_LUT = 128, FLOAT_MUL_FF = 143;
+static const size_t FLOAT_MUL_LATENCY = 3;
+static const size_t FLOAT_DIV_LUT = 800, FLOAT_DIV_FF = 1400;
+static const size_t FLOAT_DIV_LATENCY = 16;
+// calls of math functions, e.g. sqrt or exp
+static const size_t SPECIAL_DSP = 7, SPECIAL_LUT = 1500, SPECIAL_FF = 2000;
+static const size_t SPECIAL_LATENCY = 20;
+// streams of at most this depth are implemented in shift registers
+static const size_t SRL_FIFO_DEPTH = 32;
+// memory banks of the bins of histograms, see HIPACC_BINNING_BANKS
+static const size_t BINNING_BANKS = 2;
+// LUTs per DSP and BRAM18K block of a Zynq-7020, see getKernelCost
+static const size_t DSP_LUT_WEIGHT = 242, BRAM_LUT_WEIGHT = 190;
+
+
+static size_t divUp(size_t a, size_t b) {
+  return (a + b - 1) / b;
+}
+
+
+template<class T>
+static void printResources(std::ostringstream &os, T &est) {
+  os << "\"bram18k\": " << est.bram << ", \"dsp\": " << est.dsp
+     << ", \"ff\": " << est.ff << ", \"lut\": " << est.lut;
+}
+
+
+// Number of BRAM18K blocks of a memory with depth words of width bits, using
+// the best of the aspect ratios of the block.
+static size_t getNumBRAMs(size_t depth, size_t width) {
+  static const size_t widths[] = { 1, 2, 4, 9, 18, 36 };
+  static const size_t depths[] = { 16384, 8192, 4096, 2048, 1024, 512 };
+  size_t num = divUp(width, 36) * divUp(depth, 512);
+  for (size_t i = 0; i < sizeof(widths)/sizeof(widths[0]); ++i) {
+    num = std::min(num, divUp(width, widths[i]) * divUp(depth, depths[i]));
+  }
+  return num;
+}
+
+
+// Bit width of a type as printed for Vivado, e.g. ap_int<12>
+static size_t getTypeStrWidth(std::string type) {
+  int width = 0;
+  size_t pos = type.find('<');
+  if (pos != std::string::npos &&
+      sscanf(type.c_str() + pos, "<%d", &width) == 1) {
+    return width;
+  }
+  if (type.find("char") != std::string::npos) return 8;
+  if (type.find("short") != std::string::npos) return 16;
+  if (type.find("long") != std::string::npos ||
+      type.find("double") != std::string::npos) return 64;
+  return 32;
+}
+
+
+// Bit width of the elements of the stream of s, considering narrowed types
+size_t HostDataDeps::getStreamWidth(Space *s) {
+  Image *img = s->getImage();
+  size_t width;
+  if (fixedPointFormat_.count(s)) {
+    width = fixedPointFormat_[s].getWidth();
+  } else if (integerRange_.count(s)) {
+    width = std::min((size_t)IntegerFormat::get(integerRange_[s]).width,
+                     img->getTypeWidth());
+  } else {
+    width = img->getTypeWidth();
+  }
+  return width * compilerOptions.getPixelsPerThread();
+}
+
+
+void HostDataDeps::setKernelOperations(std::string kernelName,
+    OperationCount ops, OperationCount lambdaOps, bool floatOps) {
+  KernelCost cost = { ops, lambdaOps, floatOps };
+  kernelCost_[kernelName] = cost;
+}
+
+
+// Resources of the operators executing ops on pixels of the given bit width,
+// shared by ii iterations and replicated for ppt pixels per thread. Returns
+// the latency of the operator chain.
+size_t HostDataDeps::estimateOperators(OperationCount ops, bool floatOps,
+    size_t bits, size_t ppt, size_t ii, ResourceEstimate &est) {
+  size_t addOps = ops.ops > ops.mulOps + ops.divOps ?
+    ops.ops - ops.mulOps - ops.divOps : 0;
+
+  size_t adders = divUp(addOps * ppt, ii);
+  size_t muls = divUp(ops.mulOps * ppt, ii);
+  size_t divs = divUp(ops.divOps * ppt, ii);
+  size_t specials = divUp(ops.specialOps * ppt, ii);
+  est.dsp += specials * SPECIAL_DSP;
+  est.lut += specials * SPECIAL_LUT;
+  est.ff += specials * SPECIAL_FF;
+  size_t depth = 2 + (ops.specialOps ? SPECIAL_LATENCY : 0);
+  if (floatOps) {
+    est.dsp += adders * FLOAT_ADD_DSP + muls * FLOAT_MUL_DSP;
+    est.lut += adders * FLOAT_ADD_LUT + muls * FLOAT_MUL_LUT +
+               divs * FLOAT_DIV_LUT;
+    est.ff += adders * FLOAT_ADD_FF + muls * FLOAT_MUL_FF +
+              divs * FLOAT_DIV_FF;
+    depth += (ops.mulOps ? FLOAT_MUL_LATENCY : 0) +
+             (ops.divOps ? FLOAT_DIV_LATENCY : 0) +
+             addOps * FLOAT_ADD_LATENCY;
+  } else {
+    est.dsp += muls * divUp(bits, DSP_WIDTH_A) * divUp(bits, DSP_WIDTH_B);
+    est.lut += adders * bits + divs * bits * bits;
+    est.ff += adders * bits + muls * 2 * bits + divs * bits * bits;
+    depth += (ops.mulOps ? INT_MUL_LATENCY : 0) +
+             (ops.divOps ? bits : 0) +
+             (size_t)std::ceil(std::log2((double)addOps + 1));
+  }
+
+  return depth;
+}
+
+
+// Cost of a kernel with ppt pixels per thread at initiation interval ii
+// according to the operators and window registers of printProcessEstimate,
+// used to select the Vivado configuration before the pipeline is known.
+// Resources are weighted by their share of a Zynq-7020 device (53200 LUTs,
+// 106400 FFs, 220 DSPs, 280 BRAM18Ks) and returned in LUTs.
+size_t HostDataDeps::getKernelCost(OperationCount ops, bool floatOps,
+    size_t bits, size_t ppt, size_t ii) {
+  ResourceEstimate est;
+  estimateOperators(ops, floatOps, bits, ppt, ii, est);
+  est.ff += ppt * bits;
+  return est.lut + est.ff / 2 + est.dsp * DSP_LUT_WEIGHT +
+         est.bram * BRAM_LUT_WEIGHT;
+}
+
+
+// Analytic estimate of the resources and the latency of the processes of
+// hipaccRun, see printEstimate. Operations of lambda functions are executed
+// for each window element, operators are shared by II_TARGET iterations and
+// replicated for each pixel per thread. The pipeline depth is the latency of
+// the operator chain, assuming a multiplication followed by an adder tree for
+// integer and a serial chain of additions for floating-point operations,
+// which Vivado HLS does not reassociate.
+std::string HostDataDeps::printProcessEstimate(Process *proc,
+    ResourceEstimate &est, size_t &depth, std::string indent) {
+  std::ostringstream retVal;
+  est = ResourceEstimate();
+  size_t ppt = compilerOptions.getPixelsPerThread();
+  size_t ii = compilerOptions.getTargetII();
+  size_t level = proc->getOutSpace()->getImage()->getLevel();
+  size_t words = divUp(maxImageWidth_ >> level, ppt);
+
+  std::vector<std::string> inStreams;
+  std::vector<Space*> inSpaces;
+  getFusedInputs(proc, inStreams, inSpaces);
+  size_t width = getStreamWidth(proc->getOutSpace());
+  for (auto it = inSpaces.begin(); it != inSpaces.end(); ++it) {
+    width = std::max(width, getStreamWidth(*it));
+  }
+  size_t bits = width / ppt;
+
+  ProcessInfo *info = getProcessInfo(proc);
+  size_t sizeX = 1, sizeY = 1;
+  if (info && info->local) {
+    sizeX = getWindowSize(info->sizeX, maxWindowSizeX_);
+    sizeY = getWindowSize(info->sizeY, maxWindowSizeY_);
+  }
+
+  // operations of the process and the point operators fused into it
+  std::vector<Process*> procs(1, proc);
+  getFusedProcesses(proc, procs);
+  procs.insert(procs.end(), proc->outputMap.begin(), proc->outputMap.end());
+  OperationCount ops;
+  bool floatOps = false;
+  for (auto it = procs.begin(); it != procs.end(); ++it) {
+    if ((*it)->resample != Interpolate::NO) {
+      // linear filtering of two or four pixels
+      ops.ops += 4;
+      ops.mulOps += 4;
+      continue;
+    }
+    auto cost = kernelCost_.find(getKernelName(*it));
+    if (cost == kernelCost_.end()) {
+      continue;
+    }
+    size_t window = *it == proc ? sizeX * sizeY : 1;
+    ProcessInfo *procInfo = getProcessInfo(*it);
+    if (procInfo && !procInfo->sepCoef.empty()) {
+      // row and column FIR instead of the window
+      ops.ops += 2 * (sizeX + sizeY);
+      ops.mulOps += sizeX + sizeY;
+      bits = std::max(bits, getTypeStrWidth(procInfo->sepType));
+    } else {
+      ops.ops += cost->second.ops.ops + cost->second.lambdaOps.ops * window;
+      ops.mulOps += cost->second.ops.mulOps +
+                    cost->second.lambdaOps.mulOps * window;
+      ops.divOps += cost->second.ops.divOps +
+                    cost->second.lambdaOps.divOps * window;
+      ops.specialOps += cost->second.ops.specialOps +
+                        cost->second.lambdaOps.specialOps * window;
+    }
+    floatOps |= cost->second.floatOps;
+  }
+  depth = estimateOperators(ops, floatOps, bits, ppt, ii, est);
+
+  // line buffer, shared by all readers of a shared space
+  Space *shared = inSpaces.size() == 1 && isSharedSpace(inSpaces.front()) ?
+    inSpaces.front() : nullptr;
+  if (shared && shared->getDstProcesses().front() != proc) {
+    sizeY = 1;
+  } else if (shared) {
+    std::vector<Process*> dst = shared->getDstProcesses();
+    for (auto it = dst.begin(); it != dst.end(); ++it) {
+      sizeY = std::max(sizeY, getWindowSize(getProcessInfo(*it)->sizeY,
+                                      maxWindowSizeY_));
+    }
+  }
+  if (sizeY > 1) {
+    // narrow integer pixels are packed into 32 bit words, see LineBufferPack
+    size_t pack = 1;
+    if (!floatOps && ppt == 1 && bits < 32) {
+      size_t word = 32 / bits;
+      pack = word >= 4 && words >= 4 * 512 ? 4 :
+             word >= 2 && words >= 2 * 512 ? 2 : 1;
+    }
+    est.bram += (sizeY - 1) * getNumBRAMs(divUp(words, pack), width * pack);
+    depth += 1;
+  }
+  // window registers
+  est.ff += sizeY * (sizeX + ppt - 1) * bits;
+  // loop counters and control
+  est.ff += 64;
+  est.lut += 64;
+
+  if (proc->getKernel()->getNumBins()) {
+    est.bram += BINNING_BANKS *
+                getNumBRAMs(proc->getKernel()->getNumBins(), 32);
+  }
+
+  // fill latency until the first result and the operator chain
+  size_t latency = getProcessDelay(proc) * ii + depth;
+
+  retVal << indent << "{ \"kernel\": \"" << proc->getKernel()->getName()
+         << "\", ";
+  if (procs.size() > 1) {
+    retVal << "\"fused\": [";
+    for (size_t i = 1; i < procs.size(); ++i) {
+      retVal << (i > 1 ? ", " : "") << "\""
+             << procs[i]->getKernel()->getName() << "\"";
+    }
+    retVal << "], ";
+  }
+  retVal << "\"window\": [" << sizeX << ", " << sizeY << "], "
+         << "\"pixel_bits\": " << bits << ", "
+         << "\"float\": " << (floatOps ? "true" : "false") << ",\n"
+         << indent << "  \"ops\": " << ops.ops << ", \"mul_ops\": "
+         << ops.mulOps << ", \"div_ops\": " << ops.divOps
+         << ", \"special_ops\": " << ops.specialOps << ",\n"
+         << indent << "  ";
+  printResources(retVal, est);
+  retVal << ",\n" << indent << "  \"pipeline_depth\": " << depth
+         << ", \"latency\": " << latency << " }";
+
+  return retVal.str();
+}
+
+
+// Writes the estimate of hipaccRun as JSON: the resources, pipeline depth and
+// fill latency of each process, the resources of the streams of the dataflow
+// region, and the totals. The latency of hipaccRun is the fill latency along
+// the slowest path plus the initiation interval of a frame (in clock cycles).
+// Requires the processes fused and the stream depths computed by prettyPrint.
+std::string HostDataDeps::printEstimate() {
+  std::ostringstream retVal;
+  size_t ppt = compilerOptions.getPixelsPerThread();
+  size_t ii = compilerOptions.getTargetII();
+  ResourceEstimate total;
+  std::map<Space*, size_t> arrival, pipeline;
+
+  retVal << "{\n";
+  retVal << "  \"target\": { \"ii\": " << ii << ", \"ppt\": " << ppt
+         << ", \"max_width\": " << maxImageWidth_ << ", \"max_height\": "
+         << maxImageHeight_;
+  if (stripWidth_) {
+    retVal << ", \"strip_width\": " << stripWidth_ << ", \"strip_halo\": "
+           << stripHalo_;
+  }
+  if (compilerOptions.useVideoMode()) {
+    retVal << ", \"video\": true";
+  }
+  if (compilerOptions.useTargetThroughput()) {
+    retVal << ", \"clock_mhz\": " << compilerOptions.getTargetClock()
+           << ", \"throughput_mpixels\": "
+           << compilerOptions.getTargetThroughput();
+  }
+  retVal << " },\n";
+  retVal << "  \"kernels\": [\n";
+  bool first = true;
+  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
+    if ((*it)->isSpace() || ((Process*)*it)->fusedInto) {
+      continue;
+    }
+    Process *t = (Process*)*it;
+
+    ResourceEstimate est;
+    size_t depth;
+    retVal << (first ? "" : ",\n") << printProcessEstimate(t, est, depth,
+        "    ");
+    first = false;
+    total += est;
+
+    std::vector<std::string> inStreams;
+    std::vector<Space*> inSpaces;
+    getFusedInputs(t, inStreams, inSpaces);
+    size_t arr = 0, pipe = 0;
+    for (auto it2 = inSpaces.begin(); it2 != inSpaces.end(); ++it2) {
+      arr = std::max(arr, arrival[*it2]);
+      pipe = std::max(pipe, pipeline[*it2]);
+    }
+    Space *out = getFusedOutput(t)->getOutSpace();
+    arrival[out] = arr + getProcessDelay(t) * ii + depth;
+    pipeline[out] = pipe + depth;
+  }
+  retVal << "\n  ],\n";
+
+  // streams between the processes, the streams of the entry are arguments
+  ResourceEstimate streams;
+  size_t numStreams = 0;
+  std::vector<Space*> in = getInputSpaces();
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    if ((*it)->fusedInto) {
+      continue;
+    }
+    std::vector<std::string> inStreams;
+    std::vector<Space*> inSpaces;
+    getFusedInputs(*it, inStreams, inSpaces);
+    for (size_t i = 0; i < inStreams.size(); ++i) {
+      if (findVector(in, inSpaces[i]) &&
+          inStreams[i] == inSpaces[i]->stream) {
+        continue;
+      }
+      size_t depth = streamDepth_.count(inStreams[i]) ?
+        streamDepth_[inStreams[i]] : DEFAULT_STREAM_DEPTH;
+      size_t width = getStreamWidth(inSpaces[i]);
+      if (depth <= SRL_FIFO_DEPTH) {
+        streams.lut += width + 16;
+        streams.ff += width + 16;
+      } else {
+        streams.bram += getNumBRAMs(depth, width);
+        streams.lut += 32;
+        streams.ff += 32;
+      }
+      ++numStreams;
+    }
+  }
+  total += streams;
+  retVal << "  \"streams\": { \"count\": " << numStreams << ", ";
+  printResources(retVal, streams);
+  retVal << " },\n";
+
+  size_t depth = 0, latency = 0;
+  std::vector<Space*> out = getOutputSpaces();
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    depth = std::max(depth, pipeline[*it]);
+    latency = std::max(latency, arrival[*it]);
+  }
+  size_t interval = divUp(maxImageWidth_, ppt) * maxImageHeight_ * ii;
+  if (stripWidth_) {
+    interval *= divUp(maxFrameWidth_, stripWidth_);
+  }
+  retVal << "  \"total\": { ";
+  printResources(retVal, total);
+  retVal << ",\n    \"pipeline_depth\": " << depth << ", \"interval\": "
+         << interval << ", \"latency\": " << latency + interval;
+  if (compilerOptions.useTargetThroughput()) {
+    retVal << ", \"throughput_mpixels\": "
+           << compilerOptions.getTargetClock() * ppt / ii;
+  }
+  retVal << " }\n";
+  retVal << "}\n";
+
+  return retVal.str();
+}
+
+
+std::string HostDataDeps::printEntryDecl(
+    std::map<std::string,std::vector<std::pair<std::string,std::string>>> args) {
+  return getEntrySignature(args, true) + ";\n";
+}
+
 
 std::string HostDataDeps::printEntryCall(
     std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
-    std::string img) {
-  return getEntrySignature(args) + ";\n";
+    std::string img, bool stmt) {
+  if (!stmt) {
+    return getEntrySignature(args, false, img);
+  }
+  return getEntrySignature(args, false, img) + ";\n";
 }
 
 
@@ -773,7 +3024,7 @@ std::string HostDataDeps::getOutputStream(ValueDecl *VD) {
   std::string retVal = "";
   for (auto it = spaces.begin(); it != spaces.end(); it++) {
     Space *s = *it;
-    if (s->getImage()->getName() == img) {
+    if (s->getImage()->getName() == img && !isReducedSpace(s)) {
       retVal = s->stream;
       break;
     }
@@ -794,7 +3045,7 @@ std::string HostDataDeps::getStreamDecl(ValueDecl *VD) {
   std::string retVal = "";
   for (auto it = spaces.begin(); it != spaces.end(); it++) {
     Space *s = *it;
-    if (s->getImage()->getName() == img) {
+    if (s->getImage()->getName() == img && !isReducedSpace(s)) {
       retVal = "hls::stream<" + getTypeStr(s) + " > " + s->stream + ";";
       break;
     }
@@ -804,6 +3055,327 @@ std::string HostDataDeps::getStreamDecl(ValueDecl *VD) {
 }
 
 
+size_t HostDataDeps::getNumOutputStreams(std::string kernelName) {
+  size_t retVal = 0;
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    if ("cc" + proc->getKernel()->getName() + "Kernel" != kernelName) {
+      continue;
+    }
+    size_t num = writesStreamCopies(proc) ?
+        proc->getOutSpace()->getDstProcesses().size() : 1;
+    assert((retVal == 0 || retVal == num) &&
+           "Kernel executed with different numbers of consumers");
+    retVal = num;
+  }
+
+  return retVal ? retVal : 1;
+}
+
+
+std::string HostDataDeps::getReduceResult(std::string kernelName) {
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    if (getKernelName(proc) == kernelName &&
+        proc->getKernel()->hasReduceFunction() &&
+        isReducedSpace(proc->getOutSpace())) {
+      return "_red" + proc->getKernel()->getName();
+    }
+  }
+
+  return "";
+}
+
+
+std::string HostDataDeps::getBinningResult(std::string kernelName) {
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    if (getKernelName(proc) == kernelName &&
+        proc->getKernel()->getNumBins() &&
+        isReducedSpace(proc->getOutSpace())) {
+      return "_bin" + proc->getKernel()->getName();
+    }
+  }
+
+  return "";
+}
+
+
+std::string HostDataDeps::printReduceResultDecls(std::string indent) {
+  std::string retVal;
+  std::vector<Space*> out = getOutputSpaces();
+  for (auto it = out.begin(); it != out.end(); ++it) {
+    if (!isReducedSpace(*it)) {
+      continue;
+    }
+    Kernel *kernel = (*it)->getSrcProcess()->getKernel();
+    if (kernel->getNumBins()) {
+      retVal += "std::vector<uint> _bin" + kernel->getName() + "(" +
+                std::to_string(kernel->getNumBins()) + ");\n" + indent;
+    } else {
+      retVal += getTypeStr(*it) + " _red" + kernel->getName() + ";\n" +
+                indent;
+    }
+  }
+
+  return retVal;
+}
+
+
+void HostDataDeps::setProcessInfo(std::string kernelName, bool local,
+    bool vect, std::string sizeX, std::string sizeY, std::string border,
+    std::string inType, std::string outType, std::string sepCoef,
+    std::string sepType) {
+  ProcessInfo info = { local, vect, sizeX, sizeY, border, inType, outType,
+                       sepCoef, sepType };
+  processInfo_[kernelName] = info;
+}
+
+
+size_t HostDataDeps::getNumProcesses(Kernel *kernel) {
+  size_t num = 0;
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    if ((*it)->getKernel() == kernel) {
+      ++num;
+    }
+  }
+  return num;
+}
+
+
+bool HostDataDeps::isPyramidImage(Image *image) {
+  for (auto it = pyrMap_.begin(); it != pyrMap_.end(); ++it) {
+    if (it->second->getImage(0) == image) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Streams between kernels executed once on scalar images may be narrowed
+// unless read with a constant border: floating-point streams are converted to
+// fixed-point, integer streams use the narrowest ap_int/ap_uint type holding
+// the kernel results. Their type is
+// declared in hipacc_run.cc once the ranges of all kernel results are known,
+// see printStreamTypes.
+bool HostDataDeps::isNarrowedSpace(Space *s) {
+  Process *src = s->getSrcProcess();
+  if (compilerOptions.getPixelsPerThread() > 1 || !src ||
+      src->resample != Interpolate::NO ||
+      src->getKernel()->hasReduceFunction() ||
+      src->getKernel()->getNumBins() ||
+      getNumProcesses(src->getKernel()) != 1 ||
+      s->getDstProcesses().empty() ||
+      s->getImage()->getLevel() != 0 || isPyramidImage(s->getImage())) {
+    return false;
+  }
+  if (!s->getImage()->isIntegerType() &&
+      !(s->getImage()->isFloatType() && compilerOptions.useFixedPoint())) {
+    return false;
+  }
+
+  std::vector<Process*> dst = s->getDstProcesses();
+  for (auto it = dst.begin(); it != dst.end(); ++it) {
+    if ((*it)->resample != Interpolate::NO ||
+        getNumProcesses((*it)->getKernel()) != 1) {
+      return false;
+    }
+    // BORDER_FILL_VALUE is outside of the range of the producer's results
+    std::vector<Accessor*> accs = (*it)->getKernel()->getAccessors();
+    std::vector<Space*> in = (*it)->getInSpaces();
+    for (size_t i = 0; i < accs.size() && i < in.size(); ++i) {
+      if (in[i] == s && accs[i]->getBoundaryMode() == Boundary::CONSTANT) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+// space read by the accessor of a kernel executed once
+HostDataDeps::Space *HostDataDeps::getAccessorSpace(std::string kernelName,
+    std::string accName) {
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    Process *proc = *it;
+    if (getKernelName(proc) != kernelName ||
+        getNumProcesses(proc->getKernel()) != 1) {
+      continue;
+    }
+    std::vector<Accessor*> accs = proc->getKernel()->getAccessors();
+    std::vector<Space*> in = proc->getInSpaces();
+    for (size_t i = 0; i < accs.size() && i < in.size(); ++i) {
+      if (accs[i]->getName() == accName) {
+        return in[i];
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+
+// A stream is narrowed if the range of the results of its producer is known.
+// Processes reading multiple streams require the same type for all of them:
+// either all are fixed-point, using the widest format, all are integer, using
+// the union of their ranges, or all keep the type of their image.
+void HostDataDeps::resolveStreamTypes() {
+  fixedPointFormat_.clear();
+  integerRange_.clear();
+  for (auto it = spaces_.begin(); it != spaces_.end(); ++it) {
+    Space *s = *it;
+    if (!isNarrowedSpace(s) ||
+        !outputRange_.count(getKernelName(s->getSrcProcess()))) {
+      continue;
+    }
+    std::pair<double, double> range =
+      outputRange_[getKernelName(s->getSrcProcess())];
+    if (s->getImage()->isIntegerType()) {
+      integerRange_[s] = ValueRange(range.first, range.second);
+      continue;
+    }
+    // the kernel result deviates by up to half the error bound, rounding to
+    // the stream format by up to the other half
+    fixedPointFormat_[s] = FixedPointFormat::get(
+        std::max(std::fabs(range.first), std::fabs(range.second)),
+        compilerOptions.getFixedPointError() / 2);
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+      std::vector<Space*> in = (*it)->getInSpaces();
+      if (in.size() < 2) {
+        continue;
+      }
+
+      bool fixed = true, integer = true;
+      FixedPointFormat format(1, 0);
+      ValueRange range = integerRange_.count(in.front()) ?
+        integerRange_[in.front()] : ValueRange();
+      for (auto it2 = in.begin(); it2 != in.end(); ++it2) {
+        if (!fixedPointFormat_.count(*it2)) {
+          fixed = false;
+        } else {
+          format.intBits = std::max(format.intBits,
+              fixedPointFormat_[*it2].intBits);
+          format.fracBits = std::max(format.fracBits,
+              fixedPointFormat_[*it2].fracBits);
+        }
+        if (!integerRange_.count(*it2)) {
+          integer = false;
+        } else {
+          range.lo = std::min(range.lo, integerRange_[*it2].lo);
+          range.hi = std::max(range.hi, integerRange_[*it2].hi);
+        }
+      }
+
+      for (auto it2 = in.begin(); it2 != in.end(); ++it2) {
+        if (fixed) {
+          if (fixedPointFormat_[*it2].intBits != format.intBits ||
+              fixedPointFormat_[*it2].fracBits != format.fracBits) {
+            fixedPointFormat_[*it2] = format;
+            changed = true;
+          }
+        } else if (integer) {
+          if (integerRange_[*it2].lo != range.lo ||
+              integerRange_[*it2].hi != range.hi) {
+            integerRange_[*it2] = range;
+            changed = true;
+          }
+        } else {
+          changed |= fixedPointFormat_.erase(*it2) > 0;
+          changed |= integerRange_.erase(*it2) > 0;
+        }
+      }
+    }
+  }
+}
+
+
+std::string HostDataDeps::getResolvedTypeStr(Space *s) {
+  if (fixedPointFormat_.count(s)) {
+    return fixedPointFormat_[s].getTypeStr();
+  }
+  if (integerRange_.count(s)) {
+    IntegerFormat format = IntegerFormat::get(integerRange_[s]);
+    if ((size_t)format.width < s->getImage()->getTypeWidth()) {
+      return format.getTypeStr();
+    }
+  }
+  return s->getTypeStr(compilerOptions.getPixelsPerThread());
+}
+
+
+std::string HostDataDeps::getInputTypeStr(std::string kernelName,
+    std::string accName, HipaccImage *img, size_t ppt) {
+  Space *s = getAccessorSpace(kernelName, accName);
+  if (s && isNarrowedSpace(s)) {
+    return getTypeStr(s);
+  }
+  return ASTNode::createVivadoTypeStr(img, ppt);
+}
+
+
+std::string HostDataDeps::getOutputTypeStr(std::string kernelName,
+    HipaccImage *img, size_t ppt) {
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    if (getKernelName(*it) == kernelName &&
+        isNarrowedSpace((*it)->getOutSpace())) {
+      return getTypeStr((*it)->getOutSpace());
+    }
+  }
+  return ASTNode::createVivadoTypeStr(img, ppt);
+}
+
+
+bool HostDataDeps::isNarrowedInput(std::string kernelName,
+    std::string accName) {
+  Space *s = getAccessorSpace(kernelName, accName);
+  return s && isNarrowedSpace(s);
+}
+
+
+// range of the values read by an accessor, known if the producing kernel was
+// rewritten before
+bool HostDataDeps::getInputRange(std::string kernelName,
+    std::string accName, double &lo, double &hi) {
+  Space *s = getAccessorSpace(kernelName, accName);
+  if (!s || !isNarrowedSpace(s)) {
+    return false;
+  }
+  std::string srcName = getKernelName(s->getSrcProcess());
+  if (!outputRange_.count(srcName)) {
+    return false;
+  }
+  lo = outputRange_[srcName].first;
+  hi = outputRange_[srcName].second;
+  return true;
+}
+
+
+void HostDataDeps::setOutputRange(std::string kernelName, double lo,
+    double hi) {
+  outputRange_[kernelName] = std::make_pair(lo, hi);
+}
+
+
+std::string HostDataDeps::printStreamTypes() {
+  std::ostringstream retVal;
+  resolveStreamTypes();
+  for (auto it = spaces_.begin(); it != spaces_.end(); ++it) {
+    if (isNarrowedSpace(*it)) {
+      retVal << "typedef " << getResolvedTypeStr(*it) << " "
+             << getTypeStr(*it) << ";\n";
+    }
+  }
+  return retVal.str();
+}
+
+
 const bool HostDataDeps::DEBUG =
 #ifdef PRINT_DEBUG
     true;
@@ -67,11 +67,12 @@ class KernelStatsImpl {
     unsigned DiagIDUnsupportedBO, DiagIDUnsupportedUO,
              DiagIDUnsupportedCSCE, DiagIDUnsupportedTerm,
              DiagIDImageAccess, DiagIDMemIncons;
-    unsigned num_ops, num_sops;
+    unsigned num_ops, num_sops, num_mul_ops, num_div_ops;
     unsigned num_img_loads, num_img_stores;
     unsigned num_mask_loads, num_mask_stores;
     VectorInfo curStmtVectorize;
     bool inLambdaFunction;
+    OperationCount lambdaOps;
 
     void runOnBlock(const CFGBlock *block);
     void runOnAllBlocks();
@@ -100,6 +101,8 @@ class KernelStatsImpl {
             "Pre/post-increment/decrement not supported to assure memory consistency on GPUs: %0.")),
       num_ops(0),
       num_sops(0),
+      num_mul_ops(0),
+      num_div_ops(0),
       num_img_loads(0),
       num_img_stores(0),
       num_mask_loads(0),
@@ -298,6 +301,22 @@ KernelType KernelStatistics::getKernelType() {
 }
 
 
+OperationCount KernelStatistics::getOperations() {
+  KernelStatsImpl &KS = getImpl(impl);
+  OperationCount count;
+  count.ops = KS.num_ops - KS.lambdaOps.ops;
+  count.mulOps = KS.num_mul_ops - KS.lambdaOps.mulOps;
+  count.divOps = KS.num_div_ops - KS.lambdaOps.divOps;
+  count.specialOps = KS.num_sops - KS.lambdaOps.specialOps;
+  return count;
+}
+
+
+OperationCount KernelStatistics::getLambdaOperations() {
+  return getImpl(impl).lambdaOps;
+}
+
+
 MemoryPattern TransferFunctions::checkStride(Expr *EX, Expr *EY) {
   bool stride_x=true, stride_y=true;
 
@@ -470,6 +489,21 @@ bool TransferFunctions::checkImageAccess(Expr *E, MemoryAccess mem_acc) {
 void TransferFunctions::VisitBinaryOperator(BinaryOperator *E) {
   DeclRefExpr *DRE = nullptr;
 
+  switch (E->getOpcode()) {
+    case BO_Mul:
+    case BO_MulAssign:
+      KS.num_mul_ops++;
+      break;
+    case BO_Div:
+    case BO_Rem:
+    case BO_DivAssign:
+    case BO_RemAssign:
+      KS.num_div_ops++;
+      break;
+    default:
+      break;
+  }
+
   switch (E->getOpcode()) {
     case BO_PtrMemD:
     case BO_PtrMemI:
@@ -703,11 +737,20 @@ void TransferFunctions::VisitLambdaExpr(LambdaExpr *E) {
   AC.getCFG()->viewCFG(KS.Ctx.getLangOpts());
   #endif
 
+  // operations of nested lambda functions are counted by the outermost one
+  bool nested = KS.inLambdaFunction;
+  unsigned ops = KS.num_ops, sops = KS.num_sops, mul_ops = KS.num_mul_ops,
+           div_ops = KS.num_div_ops;
   KS.inLambdaFunction = true;
   auto POV = AC.getAnalysis<PostOrderCFGView>();
   for (auto block : *POV)
     KS.runOnBlock(block);
-  KS.inLambdaFunction = false;
+  KS.inLambdaFunction = nested;
+  if (nested) return;
+  KS.lambdaOps.ops += KS.num_ops - ops;
+  KS.lambdaOps.mulOps += KS.num_mul_ops - mul_ops;
+  KS.lambdaOps.divOps += KS.num_div_ops - div_ops;
+  KS.lambdaOps.specialOps += KS.num_sops - sops;
 }
 
 void TransferFunctions::VisitReturnStmt(ReturnStmt *S) {
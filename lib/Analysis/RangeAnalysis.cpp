@@ -0,0 +1,814 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+//===--- RangeAnalysis.cpp - Value ranges and fixed-point formats ---------===//
+//
+// This file implements an interval analysis of translated kernel bodies. It
+// computes the range of the values of the kernel result and of its local
+// variables, and bounds the error of evaluating all floating-point
+// computations in a fixed-point format.
+//
+// Variables assigned within loops are assumed to take any value of their
+// type, loops over floating-point variables are not supported.
+//
+// Each floating-point operation is assumed to round its result to the
+// fixed-point format. Vivado HLS computes intermediate results at full
+// precision and rounds only on assignment, hence the bound is conservative.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hipacc/Analysis/RangeAnalysis.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace clang;
+using namespace hipacc;
+
+// widest fixed-point format kernels are converted to, the significand of a
+// double, so that the C simulation computing through doubles is exact (see
+// runtime/vivado_sim/ap_fixed.h)
+static const int MAX_FIXED_POINT_WIDTH = 53;
+
+
+double ValueRange::getMaxAbs() const {
+  return std::max(std::fabs(lo), std::fabs(hi)) + err;
+}
+
+
+static ValueRange hull(const ValueRange &a, const ValueRange &b) {
+  return ValueRange(std::min(a.lo, b.lo), std::max(a.hi, b.hi),
+      std::max(a.err, b.err));
+}
+
+
+std::string FixedPointFormat::getTypeStr() const {
+  std::ostringstream type;
+  type << "ap_fixed<" << getWidth() << "," << intBits << ",AP_RND>";
+  return type.str();
+}
+
+
+FixedPointFormat FixedPointFormat::get(double maxAbs, double maxError) {
+  int fracBits = getFracBits(maxError);
+  return FixedPointFormat(getIntBits(maxAbs + std::ldexp(1.0, -fracBits-1)),
+      fracBits);
+}
+
+
+// integer bits including the sign bit
+int FixedPointFormat::getIntBits(double maxAbs) {
+  if (maxAbs < 1) {
+    return 1;
+  }
+  return (int)std::floor(std::log2(maxAbs)) + 2;
+}
+
+
+// rounding to the nearest value has an error of half a unit in the last place
+int FixedPointFormat::getFracBits(double maxError) {
+  int fracBits = 0;
+  while (std::ldexp(1.0, -fracBits-1) > maxError) {
+    ++fracBits;
+  }
+  return fracBits;
+}
+
+
+std::string IntegerFormat::getTypeStr() const {
+  std::ostringstream type;
+  type << (isSigned ? "ap_int<" : "ap_uint<") << width << ">";
+  return type.str();
+}
+
+
+IntegerFormat IntegerFormat::get(const ValueRange &range) {
+  double lo = std::floor(range.lo - range.err);
+  double hi = std::ceil(range.hi + range.err);
+  if (lo < 0) {
+    int width = 1;
+    while (-std::ldexp(1.0, width-1) > lo || std::ldexp(1.0, width-1)-1 < hi) {
+      ++width;
+    }
+    return IntegerFormat(width, true);
+  }
+  int width = 1;
+  while (std::ldexp(1.0, width)-1 < hi) {
+    ++width;
+  }
+  return IntegerFormat(width, false);
+}
+
+
+void RangeAnalysis::addInput(const ValueDecl *VD, double lo, double hi,
+    bool rounded) {
+  inputs_[VD] = ValueRange(lo, hi);
+  rounded_[VD] = rounded;
+}
+
+
+// inputs are read as parameter, as window element getWindowAt(wnd, x, y), or
+// as array element
+const ValueDecl *RangeAnalysis::getInput(Expr *E) {
+  E = E->IgnoreParenImpCasts();
+  if (CallExpr *CE = dyn_cast<CallExpr>(E)) {
+    FunctionDecl *FD = CE->getDirectCallee();
+    if (!FD || FD->getNameAsString() != "getWindowAt" || !CE->getNumArgs()) {
+      return nullptr;
+    }
+    E = CE->getArg(0)->IgnoreParenImpCasts();
+  }
+  while (ArraySubscriptExpr *ASE = dyn_cast<ArraySubscriptExpr>(E)) {
+    E = ASE->getBase()->IgnoreParenImpCasts();
+  }
+  if (DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(E)) {
+    if (inputs_.count(DRE->getDecl())) {
+      return DRE->getDecl();
+    }
+  }
+  return nullptr;
+}
+
+
+ValueRange RangeAnalysis::unsupported() {
+  supported_ = false;
+  return ValueRange();
+}
+
+
+void RangeAnalysis::noteValue(const ValueRange &val) {
+  usesFloat_ = true;
+  maxAbs_ = std::max(maxAbs_, val.getMaxAbs());
+}
+
+
+// result of an arithmetic operation, rounded to the fixed-point format for
+// floating-point types and wrapped around for integer types
+ValueRange RangeAnalysis::roundValue(ValueRange val, QualType QT) {
+  if (!std::isfinite(val.lo) || !std::isfinite(val.hi) ||
+      !std::isfinite(val.err)) {
+    return unsupported();
+  }
+  if (QT->isRealFloatingType()) {
+    val.err += round_;
+    noteValue(val);
+    return val;
+  }
+  ValueRange range = getTypeRange(QT);
+  if (val.lo - val.err < range.lo || val.hi + val.err > range.hi) {
+    // wrap around
+    wraps_ = true;
+    return range;
+  }
+  return val;
+}
+
+
+bool RangeAnalysis::getTypeRange(ASTContext &Ctx, QualType QT,
+    ValueRange &range) {
+  if (QT->isBooleanType()) {
+    range = ValueRange(0, 1);
+    return true;
+  }
+  if (!QT->isIntegralOrEnumerationType()) {
+    return false;
+  }
+  int bits = (int)Ctx.getTypeSize(QT);
+  if (QT->isSignedIntegerOrEnumerationType()) {
+    range = ValueRange(-std::ldexp(1.0, bits-1), std::ldexp(1.0, bits-1) - 1);
+  } else {
+    range = ValueRange(0, std::ldexp(1.0, bits) - 1);
+  }
+  return true;
+}
+
+
+ValueRange RangeAnalysis::getTypeRange(QualType QT) {
+  ValueRange range;
+  if (!getTypeRange(Ctx, QT, range)) {
+    return unsupported();
+  }
+  return range;
+}
+
+
+ValueRange RangeAnalysis::convertValue(ValueRange val, QualType from,
+    QualType to) {
+  if (to->isRealFloatingType()) {
+    // integers are exact in the fixed-point format
+    noteValue(val);
+    return val;
+  }
+  if (to->isBooleanType()) {
+    return ValueRange(0, 1);
+  }
+  if (!to->isIntegralOrEnumerationType()) {
+    return unsupported();
+  }
+
+  ValueRange range = getTypeRange(to);
+  if (from->isRealFloatingType()) {
+    // truncation may change by one if the computed value crosses an integer
+    val.lo = std::trunc(val.lo);
+    val.hi = std::trunc(val.hi);
+    val.err = val.err > 0 ? std::floor(val.err) + 1 : 0;
+  }
+  if (val.lo - val.err < range.lo || val.hi + val.err > range.hi) {
+    // wrap around
+    return range;
+  }
+  return val;
+}
+
+
+ValueRange RangeAnalysis::readInput(Expr *E) {
+  const ValueDecl *VD = getInput(E);
+  if (!VD) {
+    return unsupported();
+  }
+  ValueRange val = inputs_[VD];
+  if (rounded_[VD]) {
+    val.err = round_;
+    noteValue(val);
+  }
+  return val;
+}
+
+
+void RangeAnalysis::writeVar(const ValueDecl *VD, const ValueRange &val) {
+  vars_[VD] = val;
+  auto it = hulls_.find(VD);
+  if (it == hulls_.end()) {
+    hulls_[VD] = val;
+  } else {
+    it->second = hull(it->second, val);
+  }
+}
+
+
+void RangeAnalysis::writeResult(const ValueRange &val) {
+  result_ = hasResult_ ? hull(result_, val) : val;
+  hasResult_ = true;
+}
+
+
+// variables assigned within S may take any value of their type
+void RangeAnalysis::havoc(Stmt *S) {
+  if (!S) {
+    return;
+  }
+  Expr *var = nullptr;
+  if (BinaryOperator *BO = dyn_cast<BinaryOperator>(S)) {
+    if (BO->isAssignmentOp()) {
+      var = BO->getLHS();
+    }
+  } else if (UnaryOperator *UO = dyn_cast<UnaryOperator>(S)) {
+    if (UO->isIncrementDecrementOp()) {
+      var = UO->getSubExpr();
+    }
+  }
+  if (var) {
+    if (DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(var->IgnoreParenImpCasts())) {
+      if (vars_.count(DRE->getDecl())) {
+        writeVar(DRE->getDecl(), getTypeRange(DRE->getType()));
+      }
+    }
+  }
+  for (auto it = S->child_begin(); it != S->child_end(); ++it) {
+    havoc(*it);
+  }
+}
+
+
+// removes the variables declared within a nested scope
+static void leaveScope(llvm::DenseMap<const ValueDecl *, ValueRange> &vars,
+    const llvm::DenseMap<const ValueDecl *, ValueRange> &outer) {
+  llvm::SmallVector<const ValueDecl *, 8> inner;
+  for (auto it = vars.begin(); it != vars.end(); ++it) {
+    if (!outer.count(it->first)) {
+      inner.push_back(it->first);
+    }
+  }
+  for (auto VD : inner) {
+    vars.erase(VD);
+  }
+}
+
+
+// stores to an element of an output array
+static const ValueDecl *getOutput(Expr *E,
+    const llvm::SmallPtrSet<const ValueDecl *, 4> &outputs) {
+  E = E->IgnoreParenImpCasts();
+  if (!isa<ArraySubscriptExpr>(E)) {
+    return nullptr;
+  }
+  while (ArraySubscriptExpr *ASE = dyn_cast<ArraySubscriptExpr>(E)) {
+    E = ASE->getBase()->IgnoreParenImpCasts();
+  }
+  if (DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(E)) {
+    if (outputs.count(DRE->getDecl())) {
+      return DRE->getDecl();
+    }
+  }
+  return nullptr;
+}
+
+
+ValueRange RangeAnalysis::visitBinary(BinaryOperatorKind op, ValueRange a,
+    ValueRange b, QualType QT) {
+  bool isFloat = QT->isRealFloatingType();
+  switch (op) {
+    default:
+      return unsupported();
+    case BO_Add:
+      return roundValue(ValueRange(a.lo + b.lo, a.hi + b.hi, a.err + b.err),
+          QT);
+    case BO_Sub:
+      return roundValue(ValueRange(a.lo - b.hi, a.hi - b.lo, a.err + b.err),
+          QT);
+    case BO_Mul: {
+      double p[4] = { a.lo*b.lo, a.lo*b.hi, a.hi*b.lo, a.hi*b.hi };
+      double absA = std::max(std::fabs(a.lo), std::fabs(a.hi));
+      double absB = std::max(std::fabs(b.lo), std::fabs(b.hi));
+      return roundValue(ValueRange(*std::min_element(p, p+4),
+            *std::max_element(p, p+4),
+            absA*b.err + absB*a.err + a.err*b.err), QT);
+    }
+    case BO_Div: {
+      // the computed divisor must not contain zero
+      if (b.lo - b.err <= 0 && b.hi + b.err >= 0) {
+        return unsupported();
+      }
+      if (!isFloat && (a.err > 0 || b.err > 0)) {
+        return unsupported();
+      }
+      double q[4] = { a.lo/b.lo, a.lo/b.hi, a.hi/b.lo, a.hi/b.hi };
+      ValueRange res(*std::min_element(q, q+4), *std::max_element(q, q+4));
+      if (!isFloat) {
+        res.lo = std::trunc(res.lo);
+        res.hi = std::trunc(res.hi);
+        return res;
+      }
+      double minB = std::min(std::fabs(b.lo), std::fabs(b.hi));
+      // the quotient is truncated to the fixed-point format
+      res.err = (a.err + res.getMaxAbs()*b.err) / (minB - b.err) + round_;
+      return roundValue(res, QT);
+    }
+    case BO_Rem: {
+      if (isFloat || a.err > 0 || b.err > 0) {
+        return unsupported();
+      }
+      double m = std::max(std::fabs(b.lo), std::fabs(b.hi)) - 1;
+      if (a.lo >= 0) {
+        return ValueRange(0, std::min(m, a.hi));
+      }
+      return ValueRange(-m, m);
+    }
+    case BO_And:
+      if (a.err > 0 || b.err > 0) {
+        return unsupported();
+      }
+      if (a.lo >= 0 && b.lo >= 0) {
+        return ValueRange(0, std::min(a.hi, b.hi));
+      }
+      return getTypeRange(QT);
+    case BO_Shr:
+      if (a.err > 0 || b.err > 0) {
+        return unsupported();
+      }
+      if (b.lo >= 0) {
+        // negative values grow and positive values shrink with the shift
+        // amount, consider both bounds of each operand
+        int lo = (int)b.lo, hi = (int)std::min(b.hi, 64.0);
+        double v[] = { std::ldexp(a.lo, -lo), std::ldexp(a.lo, -hi),
+                       std::ldexp(a.hi, -lo), std::ldexp(a.hi, -hi) };
+        return ValueRange(std::floor(*std::min_element(v, v + 4)),
+            std::floor(*std::max_element(v, v + 4)));
+      }
+      return getTypeRange(QT);
+    case BO_Shl:
+      widthDependent_ = true;
+      if (a.err > 0 || b.err > 0) {
+        return unsupported();
+      }
+      return getTypeRange(QT);
+    case BO_Or:
+    case BO_Xor:
+      if (a.err > 0 || b.err > 0) {
+        return unsupported();
+      }
+      return getTypeRange(QT);
+  }
+}
+
+
+ValueRange RangeAnalysis::visitExpr(Expr *E) {
+  if (!E || !supported_) {
+    return unsupported();
+  }
+  E = E->IgnoreParens();
+
+  if (IntegerLiteral *IL = dyn_cast<IntegerLiteral>(E)) {
+    double val = IL->getType()->isSignedIntegerType() ?
+      (double)IL->getValue().getSExtValue() :
+      (double)IL->getValue().getZExtValue();
+    return ValueRange(val, val);
+  }
+  if (CharacterLiteral *CL = dyn_cast<CharacterLiteral>(E)) {
+    return ValueRange(CL->getValue(), CL->getValue());
+  }
+  if (CXXBoolLiteralExpr *BL = dyn_cast<CXXBoolLiteralExpr>(E)) {
+    return ValueRange(BL->getValue(), BL->getValue());
+  }
+  if (FloatingLiteral *FL = dyn_cast<FloatingLiteral>(E)) {
+    double val = FL->getValueAsApproximateDouble();
+    double fixed = std::ldexp(std::floor(std::ldexp(val, fracBits_) + 0.5),
+        -fracBits_);
+    ValueRange res(val, val, std::fabs(val - fixed));
+    noteValue(res);
+    return res;
+  }
+
+  if (CastExpr *CE = dyn_cast<CastExpr>(E)) {
+    ValueRange val = visitExpr(CE->getSubExpr());
+    switch (CE->getCastKind()) {
+      default:
+        return unsupported();
+      case CK_LValueToRValue:
+      case CK_NoOp:
+        return val;
+      case CK_IntegralToFloating:
+      case CK_FloatingCast:
+      case CK_FloatingToIntegral:
+      case CK_IntegralCast:
+      case CK_IntegralToBoolean:
+      case CK_FloatingToBoolean:
+        return convertValue(val, CE->getSubExpr()->getType(), CE->getType());
+    }
+  }
+
+  // reads of inputs, after conversions of the values read
+  if (getInput(E)) {
+    return readInput(E);
+  }
+
+  if (DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(E)) {
+    if (vars_.count(DRE->getDecl())) {
+      return vars_[DRE->getDecl()];
+    }
+    if (EnumConstantDecl *ECD = dyn_cast<EnumConstantDecl>(DRE->getDecl())) {
+      double val = (double)ECD->getInitVal().getSExtValue();
+      return ValueRange(val, val);
+    }
+    return unsupported();
+  }
+
+  if (UnaryOperator *UO = dyn_cast<UnaryOperator>(E)) {
+    ValueRange val = visitExpr(UO->getSubExpr());
+    switch (UO->getOpcode()) {
+      default:
+        return unsupported();
+      case UO_Plus:
+        return val;
+      case UO_Minus:
+        return ValueRange(-val.hi, -val.lo, val.err);
+      case UO_LNot:
+        return ValueRange(0, 1);
+      case UO_Not:
+        widthDependent_ = true;
+        return getTypeRange(UO->getType());
+      case UO_PreInc:
+      case UO_PostInc:
+      case UO_PreDec:
+      case UO_PostDec: {
+        DeclRefExpr *DRE =
+          dyn_cast<DeclRefExpr>(UO->getSubExpr()->IgnoreParenImpCasts());
+        if (!DRE || !vars_.count(DRE->getDecl())) {
+          return unsupported();
+        }
+        double step = UO->isIncrementOp() ? 1 : -1;
+        ValueRange res(val.lo + step, val.hi + step, val.err);
+        res = convertValue(res, UO->getType(), UO->getType());
+        writeVar(DRE->getDecl(), res);
+        return UO->isPrefix() ? res : val;
+      }
+    }
+  }
+
+  if (BinaryOperator *BO = dyn_cast<BinaryOperator>(E)) {
+    if (BO->isAssignmentOp()) {
+      if (getOutput(BO->getLHS(), outputs_)) {
+        if (BO->getOpcode() != BO_Assign) {
+          return unsupported();
+        }
+        // the right-hand side is converted to the element type
+        ValueRange val = visitExpr(BO->getRHS());
+        writeResult(val);
+        return val;
+      }
+      DeclRefExpr *DRE =
+        dyn_cast<DeclRefExpr>(BO->getLHS()->IgnoreParenImpCasts());
+      if (!DRE || !vars_.count(DRE->getDecl())) {
+        return unsupported();
+      }
+      ValueRange val = visitExpr(BO->getRHS());
+      if (CompoundAssignOperator *CAO = dyn_cast<CompoundAssignOperator>(BO)) {
+        QualType QT = CAO->getComputationResultType();
+        ValueRange lhs = convertValue(vars_[DRE->getDecl()],
+            BO->getLHS()->getType(), CAO->getComputationLHSType());
+        val = visitBinary(BinaryOperator::getOpForCompoundAssignment(
+              BO->getOpcode()), lhs, val, QT);
+        val = convertValue(val, QT, BO->getType());
+      }
+      writeVar(DRE->getDecl(), val);
+      return val;
+    }
+
+    ValueRange lhs = visitExpr(BO->getLHS());
+    ValueRange rhs = visitExpr(BO->getRHS());
+    if (BO->getOpcode() == BO_Comma) {
+      return rhs;
+    }
+    if (BO->isComparisonOp() || BO->isLogicalOp()) {
+      return ValueRange(0, 1);
+    }
+    return visitBinary(BO->getOpcode(), lhs, rhs, BO->getType());
+  }
+
+  if (ConditionalOperator *CO = dyn_cast<ConditionalOperator>(E)) {
+    widthDependent_ = true;
+    visitExpr(CO->getCond());
+    return hull(visitExpr(CO->getTrueExpr()), visitExpr(CO->getFalseExpr()));
+  }
+
+  return unsupported();
+}
+
+
+void RangeAnalysis::visitStmt(Stmt *S) {
+  if (!S || !supported_) {
+    return;
+  }
+
+  if (CompoundStmt *CS = dyn_cast<CompoundStmt>(S)) {
+    for (auto it = CS->body_begin(); it != CS->body_end(); ++it) {
+      visitStmt(*it);
+    }
+    return;
+  }
+
+  if (DeclStmt *DS = dyn_cast<DeclStmt>(S)) {
+    for (auto it = DS->decl_begin(); it != DS->decl_end(); ++it) {
+      VarDecl *VD = dyn_cast<VarDecl>(*it);
+      if (!VD) {
+        continue;
+      }
+      QualType QT = VD->getType();
+      if (!QT->isRealFloatingType() && !QT->isIntegralOrEnumerationType()) {
+        unsupported();
+        return;
+      }
+      if (VD->getInit()) {
+        writeVar(VD, visitExpr(VD->getInit()));
+      } else {
+        vars_[VD] = ValueRange();
+      }
+    }
+    return;
+  }
+
+  if (IfStmt *IS = dyn_cast<IfStmt>(S)) {
+    if (IS->getConditionVariable()) {
+      unsupported();
+      return;
+    }
+    visitExpr(IS->getCond());
+
+    // join the variables of both branches that are still in scope
+    llvm::DenseMap<const ValueDecl *, ValueRange> vars = vars_;
+    visitStmt(IS->getThen());
+    llvm::DenseMap<const ValueDecl *, ValueRange> thenVars = vars_;
+    vars_ = vars;
+    visitStmt(IS->getElse());
+    for (auto it = vars.begin(); it != vars.end(); ++it) {
+      vars_[it->first] = hull(thenVars[it->first], vars_[it->first]);
+    }
+    for (auto it = thenVars.begin(); it != thenVars.end(); ++it) {
+      if (!vars.count(it->first)) {
+        vars_.erase(it->first);
+      }
+    }
+    return;
+  }
+
+  if (ForStmt *FS = dyn_cast<ForStmt>(S)) {
+    if (FS->getConditionVariable()) {
+      unsupported();
+      return;
+    }
+    visitStmt(FS->getInit());
+    llvm::DenseMap<const ValueDecl *, ValueRange> vars = vars_;
+    havoc(FS->getCond());
+    havoc(FS->getInc());
+    havoc(FS->getBody());
+    if (FS->getCond()) {
+      visitExpr(FS->getCond());
+    }
+    visitStmt(FS->getBody());
+    if (FS->getInc()) {
+      visitExpr(FS->getInc());
+    }
+    // the loop may not be executed or be left at any iteration
+    leaveScope(vars_, vars);
+    havoc(FS->getCond());
+    havoc(FS->getInc());
+    havoc(FS->getBody());
+    return;
+  }
+
+  if (WhileStmt *WS = dyn_cast<WhileStmt>(S)) {
+    if (WS->getConditionVariable()) {
+      unsupported();
+      return;
+    }
+    llvm::DenseMap<const ValueDecl *, ValueRange> vars = vars_;
+    havoc(WS->getCond());
+    havoc(WS->getBody());
+    visitExpr(WS->getCond());
+    visitStmt(WS->getBody());
+    leaveScope(vars_, vars);
+    havoc(WS->getCond());
+    havoc(WS->getBody());
+    return;
+  }
+
+  if (DoStmt *DS = dyn_cast<DoStmt>(S)) {
+    llvm::DenseMap<const ValueDecl *, ValueRange> vars = vars_;
+    havoc(DS->getBody());
+    havoc(DS->getCond());
+    visitStmt(DS->getBody());
+    visitExpr(DS->getCond());
+    leaveScope(vars_, vars);
+    havoc(DS->getBody());
+    havoc(DS->getCond());
+    return;
+  }
+
+  if (ReturnStmt *RS = dyn_cast<ReturnStmt>(S)) {
+    writeResult(visitExpr(RS->getRetValue()));
+    return;
+  }
+
+  if (isa<NullStmt>(S) || isa<BreakStmt>(S) || isa<ContinueStmt>(S)) {
+    return;
+  }
+
+  if (Expr *E = dyn_cast<Expr>(S)) {
+    visitExpr(E);
+    return;
+  }
+
+  // jumps and switches are not supported
+  unsupported();
+}
+
+
+bool RangeAnalysis::analyze(Stmt *body, int fracBits) {
+  fracBits_ = fracBits;
+  round_ = std::ldexp(1.0, -fracBits-1);
+  maxAbs_ = 0;
+  supported_ = true;
+  usesFloat_ = false;
+  widthDependent_ = false;
+  wraps_ = false;
+  hasResult_ = false;
+  result_ = ValueRange();
+  vars_.clear();
+  hulls_.clear();
+
+  visitStmt(body);
+
+  return supported_;
+}
+
+
+bool RangeAnalysis::getVarRange(const ValueDecl *VD, ValueRange &range) {
+  auto it = hulls_.find(VD);
+  if (it == hulls_.end()) {
+    return false;
+  }
+  range = it->second;
+  return true;
+}
+
+
+bool RangeAnalysis::computeFormat(Stmt *body, double maxError,
+    FixedPointFormat &format, ValueRange &result) {
+  for (int fracBits = 0; fracBits < MAX_FIXED_POINT_WIDTH; ++fracBits) {
+    if (!analyze(body, fracBits) || !hasResult_) {
+      return false;
+    }
+    if (result_.err <= maxError) {
+      format = FixedPointFormat(FixedPointFormat::getIntBits(maxAbs_),
+          fracBits);
+      result = result_;
+      return format.getWidth() <= MAX_FIXED_POINT_WIDTH;
+    }
+  }
+
+  return false;
+}
+
+
+// The row FIR accumulates the products of the input pixels and the row
+// coefficients, the column FIR those of the row results and the column
+// coefficients. Each product and each sum is rounded to the accumulator.
+bool RangeAnalysis::computeSeparableFormat(ValueRange in, bool rounded,
+    ArrayRef<double> rowCoef, ArrayRef<double> colCoef, double maxError,
+    FixedPointFormat &format) {
+  auto accumulate = [] (ArrayRef<double> coef, double absIn, double errIn,
+      int fracBits, double &abs) -> double {
+    double round = std::ldexp(1.0, -fracBits-1);
+    double err = 0;
+    abs = 0;
+    for (auto c : coef) {
+      double fixed = std::ldexp(std::floor(std::ldexp(c, fracBits) + 0.5),
+          -fracBits);
+      double errCoef = std::fabs(c - fixed);
+      err += absIn*errCoef + std::fabs(c)*errIn + errCoef*errIn + 2*round;
+      abs += std::fabs(c)*absIn;
+      abs = std::max(abs, std::fabs(c));
+    }
+    return err;
+  };
+
+  double absIn = std::max(std::fabs(in.lo), std::fabs(in.hi));
+  for (int fracBits = 0; fracBits < MAX_FIXED_POINT_WIDTH; ++fracBits) {
+    double errIn = rounded ? std::ldexp(1.0, -fracBits-1) : 0;
+    double absRow, absCol;
+    double errRow = accumulate(rowCoef, absIn, errIn, fracBits, absRow);
+    double errCol = accumulate(colCoef, absRow, errRow, fracBits, absCol);
+    if (errCol <= maxError) {
+      double maxAbs = std::max(std::max(absIn + errIn, absRow + errRow),
+          absCol + errCol);
+      format = FixedPointFormat(FixedPointFormat::getIntBits(maxAbs),
+          fracBits);
+      return format.getWidth() <= MAX_FIXED_POINT_WIDTH;
+    }
+  }
+
+  return false;
+}
+
+
+// The partial sums of each FIR lie between the sum of the negative and the sum
+// of the positive products of its inputs and coefficients.
+void RangeAnalysis::computeSeparableRange(ValueRange in,
+    ArrayRef<double> rowCoef, ArrayRef<double> colCoef, ValueRange &acc,
+    ValueRange &result) {
+  acc = in;
+  auto accumulate = [&acc] (ArrayRef<double> coef, ValueRange in)
+      -> ValueRange {
+    ValueRange sum, partial;
+    for (auto c : coef) {
+      double lo = std::min(c*in.lo, c*in.hi);
+      double hi = std::max(c*in.lo, c*in.hi);
+      sum.lo += lo;
+      sum.hi += hi;
+      partial.lo += std::min(lo, 0.0);
+      partial.hi += std::max(hi, 0.0);
+    }
+    acc = hull(acc, partial);
+    return sum;
+  };
+
+  result = accumulate(colCoef, accumulate(rowCoef, in));
+}
+
+// vim: set ts=2 sw=2 sts=2 et ai:
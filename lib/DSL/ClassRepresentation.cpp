@@ -34,6 +34,8 @@
 #include "hipacc/DSL/ClassRepresentation.h"
 
 #include <llvm/Support/Format.h>
+#include <cmath>
+#include <cstdlib>
 
 #ifdef USE_JIT_ESTIMATE
 #include <cuda_occupancy.h>
@@ -226,6 +228,78 @@ void HipaccBoundaryCondition::setConstVal(APValue &val, ASTContext &Ctx) {
 }
 
 
+bool HipaccMask::getSeparableCoefficients(ASTContext &Ctx,
+    SmallVectorImpl<double> &row, SmallVectorImpl<double> &col) {
+  if (!isConstant() || isDomain() || size_x < 2 || size_y < 2) return false;
+
+  bool isIntegral = getType()->isIntegerType();
+
+  // evaluate mask coefficients
+  std::vector<double> values(size_x*size_y);
+  size_t px = 0, py = 0;
+  for (size_t y=0; y<size_y; ++y) {
+    for (size_t x=0; x<size_x; ++x) {
+      Expr::EvalResult val;
+      if (!getInitExpr(x, y)->EvaluateAsRValue(val, Ctx)) return false;
+      double v = 0;
+      if (val.Val.isInt()) {
+        v = val.Val.getInt().getSExtValue();
+      } else if (val.Val.isFloat()) {
+        bool losesInfo;
+        llvm::APFloat f = val.Val.getFloat();
+        f.convert(llvm::APFloat::IEEEdouble, llvm::APFloat::rmNearestTiesToEven,
+            &losesInfo);
+        v = f.convertToDouble();
+      } else {
+        return false;
+      }
+      values[y*size_x + x] = v;
+      if (std::abs(v) > std::abs(values[py*size_x + px])) {
+        px = x;
+        py = y;
+      }
+    }
+  }
+
+  double pivot = values[py*size_x + px];
+  if (pivot == 0) return false;
+
+  // row vector is the line containing the pivot, integer masks are kept
+  // integral by dividing out the greatest common divisor of that line
+  long long div = 0;
+  if (isIntegral) {
+    for (size_t x=0; x<size_x; ++x) {
+      long long a = std::llabs((long long)values[py*size_x + x]), b = div;
+      while (b) { long long t = a % b; a = b; b = t; }
+      div = a;
+    }
+    if (pivot < 0) div = -div;
+  }
+
+  row.clear();
+  col.clear();
+  for (size_t x=0; x<size_x; ++x) {
+    double v = values[py*size_x + x];
+    row.push_back(isIntegral ? v / div : v / pivot);
+  }
+  for (size_t y=0; y<size_y; ++y) {
+    double v = values[y*size_x + px];
+    col.push_back(isIntegral ? v / row[px] : v);
+    if (isIntegral && (long long)v % (long long)row[px]) return false;
+  }
+
+  // check that the mask is the outer product of column and row
+  double eps = isIntegral ? 0 : std::abs(pivot) * 1e-6;
+  for (size_t y=0; y<size_y; ++y) {
+    for (size_t x=0; x<size_x; ++x) {
+      if (std::abs(col[y]*row[x] - values[y*size_x + x]) > eps) return false;
+    }
+  }
+
+  return true;
+}
+
+
 void HipaccKernel::calcSizes() {
   for (auto map : imgMap) {
     // only Accessors with proper border handling mode
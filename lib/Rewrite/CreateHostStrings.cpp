@@ -134,6 +134,14 @@ void CreateHostStrings::writeKernelCompilation(HipaccKernel *K,
         writeCLCompilation(K->getFileName(), K->getReduceName(),
             device.getCLIncludes(), resultStr, "1D");
       }
+      if (K->getKernelClass()->getBinningFunction()) {
+        resultStr += indent;
+        writeCLCompilation(K->getFileName(), K->getBinningName(),
+            device.getCLIncludes(), resultStr, "2D");
+        resultStr += indent;
+        writeCLCompilation(K->getFileName(), K->getBinningName(),
+            device.getCLIncludes(), resultStr, "1D");
+      }
       break;
   }
 }
@@ -1007,6 +1015,41 @@ void CreateHostStrings::writeReduceCall(HipaccKernelClass *KC, HipaccKernel *K,
 }
 
 
+void CreateHostStrings::writeBinningCall(HipaccKernel *K, std::string numBins,
+    std::string &resultStr) {
+  std::string typeStr(K->getIterationSpace()->getImage()->getTypeStr());
+
+  switch (options.getTargetLang()) {
+    case Language::C99:
+      // private bins per thread
+      resultStr += "hipaccApplyBinning<" + typeStr + ">(";
+      resultStr += K->getBinningName() + ", ";
+      resultStr += K->getIterationSpace()->getName() + ", ";
+      resultStr += numBins + ")";
+      break;
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      // sub-histograms in local memory
+      resultStr += "hipaccApplyBinning(";
+      resultStr += K->getBinningName() + "2D, ";
+      resultStr += K->getBinningName() + "1D, ";
+      resultStr += K->getIterationSpace()->getName() + ", ";
+      resultStr += numBins + ", ";
+      resultStr += std::to_string(K->getNumThreadsReduce()) + ", ";
+      resultStr += std::to_string(K->getPixelsPerThreadReduce()) + ")";
+      break;
+    case Language::Vivado:
+    case Language::CUDA:
+    case Language::Renderscript:
+    case Language::Filterscript:
+      assert(false && "Histograms are computed within the Vivado entry "
+                      "function and not supported for CUDA and Renderscript");
+      break;
+  }
+}
+
+
 void CreateHostStrings::writeInterpolationDefinition(HipaccKernel *K,
     HipaccAccessor *Acc, std::string function_name, std::string type_suffix,
     Interpolate ip_mode, Boundary bh_mode, std::string &resultStr) {
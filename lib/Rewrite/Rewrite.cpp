@@ -43,6 +43,7 @@
 #include "hipacc/DSL/CompilerKnownClasses.h"
 #include "hipacc/Rewrite/CreateHostStrings.h"
 #include "hipacc/Analysis/HostDataDeps.h"
+#include "hipacc/Analysis/RangeAnalysis.h"
 
 #include <clang/AST/ASTConsumer.h>
 #include <clang/AST/RecursiveASTVisitor.h>
@@ -53,6 +54,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <cfloat>
+#include <cmath>
+
 using namespace clang;
 using namespace hipacc;
 using namespace ASTNode;
@@ -151,9 +155,17 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
     void setKernelConfiguration(HipaccKernelClass *KC, HipaccKernel *K);
     void printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
         PrintingPolicy Policy, llvm::raw_ostream *OS);
+    void printBinningFunction(HipaccKernelClass *KC, HipaccKernel *K,
+        PrintingPolicy Policy, llvm::raw_ostream *OS);
     void printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
         HipaccKernel *K, std::string file, bool emitHints);
     void createVivadoEntry();
+    void selectVivadoConfiguration();
+    bool isSeparableConvolution(HipaccKernelClass *KC, HipaccKernel *K,
+        HipaccMask *&Mask, QualType &AccType);
+    bool getInputRange(HipaccKernel *K, HipaccAccessor *Acc,
+        ValueRange &range, bool &rounded);
+    std::string narrowKernelTypes(FunctionDecl *D, HipaccKernel *K);
 
     enum VivadoParam {
       None = 0,
@@ -166,7 +178,8 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
       Entry = 7
     };
 
-    Boundary vivadoBM = Boundary::UNDEFINED;
+    std::string vivadoBorderValue;
+    bool vivadoEntryCalled = false;
     size_t maxWindowSizeX = 1;
     size_t maxWindowSizeY = 1;
     size_t maxImageWidth = 1;
@@ -385,6 +398,11 @@ void Rewrite::HandleTranslationUnit(ASTContext &Context) {
     initStr += "\n" + stringCreator.getIndent();
   }
 
+  // reduced values and histograms returned by the Vivado entry function
+  if (compilerOptions.emitVivado()) {
+    initStr += dataDeps->printReduceResultDecls(stringCreator.getIndent());
+  }
+
   // write Mask transfers to Symbol in CUDA
   if (compilerOptions.emitCUDA()) {
     for (auto map : MaskDeclMap) {
@@ -435,7 +453,8 @@ void Rewrite::HandleTranslationUnit(ASTContext &Context) {
     auto mask = map.second;
     std::string releaseStr;
 
-    if (!compilerOptions.emitCUDA() && !mask->isConstant()) {
+    if (!compilerOptions.emitCUDA() && !compilerOptions.emitVivado() &&
+        !mask->isConstant()) {
       stringCreator.writeMemoryRelease(mask, releaseStr);
       TextRewriter.InsertTextBefore(S->getLocStart(), releaseStr);
     }
@@ -642,7 +661,7 @@ bool Rewrite::VisitCXXRecordDecl(CXXRecordDecl *D) {
       }
     }
 
-    // search for kernel and reduce functions
+    // search for kernel, reduce, and binning functions
     for (auto method : D->methods()) {
       // kernel function
       if (method->getNameAsString() == "kernel") {
@@ -655,6 +674,12 @@ bool Rewrite::VisitCXXRecordDecl(CXXRecordDecl *D) {
         KC->setReduceFunction(method);
         continue;
       }
+
+      // binning function
+      if (method->getNameAsString() == "binning") {
+        KC->setBinningFunction(method);
+        continue;
+      }
     }
   }
 
@@ -763,15 +788,30 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
             init_str, newStr);
 
         if (compilerOptions.emitVivado()) {
+          // images written within a traversal are read and written through
+          // different streams, e.g. the top level of a pyramid
+          std::vector<std::string> streams;
           std::string stream = dataDeps->getInputStream(VD);
-          if (stream.empty()) {
-            stream = dataDeps->getOutputStream(VD);
+          if (!stream.empty()) {
+            streams.push_back(stream);
+          }
+          stream = dataDeps->getOutputStream(VD);
+          if (!stream.empty()) {
+            streams.push_back(stream);
           }
-          if (stream.empty()) {
+          if (streams.empty()) {
             // image is only temporary (not output or input), skip declaration
             newStr = "";
-          } else {
-            newStr += "hls::stream<";
+          }
+          for (auto it = streams.begin(); it != streams.end(); ++it) {
+            // frame buffers modeling the memory ports of the entry function
+            if (compilerOptions.useMemoryPorts()) {
+              newStr += "HipaccMemoryPort<";
+            } else if (compilerOptions.useVideoMode()) {
+              newStr += "hls::stream<HipaccVideo<";
+            } else {
+              newStr += "hls::stream<";
+            }
 
             if (isVector || compilerOptions.getPixelsPerThread() > 1) {
               std::stringstream TSS;
@@ -790,7 +830,16 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
               newStr += QT.getAsString();
             }
 
-            newStr += "> " + stream + ";";
+            if (compilerOptions.useMemoryPorts()) {
+              std::stringstream VSS;
+              VSS << compilerOptions.getPixelsPerThread();
+              newStr += ", " + VSS.str() + "> " + *it + "(" + Img->getName() +
+                        ");";
+            } else if (compilerOptions.useVideoMode()) {
+              newStr += "> > " + *it + ";";
+            } else {
+              newStr += "> " + *it + ";";
+            }
           }
         }
 
@@ -1052,6 +1101,12 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
         assert(BC && "Expected BoundaryCondition, Image or Pyramid call as "
                      "first argument to Accessor.");
 
+        // Vivado: streams of other pyramid levels are resampled to the size
+        // of the iteration space within the entry function
+        if (compilerOptions.emitVivado()) {
+          mode = Interpolate::NO;
+        }
+
         Acc = new HipaccAccessor(VD, BC, mode, roi_args == 4);
 
         std::string newStr;
@@ -1307,7 +1362,16 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
         HipaccMask *Buf = Domain ? Domain : Mask;
 
         std::string newStr;
-        if (!Buf->isConstant() && !compilerOptions.emitCUDA()) {
+        if (!Buf->isConstant() && compilerOptions.emitVivado()) {
+          // coefficients are passed from the host array to the entry function
+          if (Buf->hasCopyMask()) {
+            unsigned DiagIDCopyMask =
+              Diags.getCustomDiagID(DiagnosticsEngine::Error,
+                  "Domain %0 created from non-constant Mask not supported "
+                  "for Vivado.");
+            Diags.Report(VD->getLocation(), DiagIDCopyMask) << VD->getName();
+          }
+        } else if (!Buf->isConstant() && !compilerOptions.emitCUDA()) {
           // create Buffer for Mask
           stringCreator.writeMemoryAllocationConstant(Buf, newStr);
 
@@ -1441,6 +1505,136 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
 }
 
 
+// Pyramids and accessors with an interpolation mode read other pyramid levels
+// through resampling processes, which support a single pixel per thread only
+static bool usesResampling(Stmt *S, CompilerKnownClasses &compilerClasses) {
+  if (!S) {
+    return false;
+  }
+  if (DeclStmt *DS = dyn_cast<DeclStmt>(S)) {
+    for (auto it = DS->decl_begin(); it != DS->decl_end(); ++it) {
+      VarDecl *VD = dyn_cast<VarDecl>(*it);
+      if (VD && compilerClasses.isTypeOfTemplateClass(VD->getType(),
+                                                     compilerClasses.Pyramid)) {
+        return true;
+      }
+    }
+  }
+  if (DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (DRE->getDecl()->getNameAsString() == "traverse") {
+      return true;
+    }
+    EnumConstantDecl *ECD = dyn_cast<EnumConstantDecl>(DRE->getDecl());
+    if (ECD && ECD->getType().getAsString() == "enum hipacc::Interpolate" &&
+        ECD->getInitVal() != 0) {
+      return true;
+    }
+  }
+  for (auto it = S->child_begin(); it != S->child_end(); ++it) {
+    if (usesResampling(*it, compilerClasses)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Chooses pixels per thread and II of the Vivado pipeline reaching the target
+// throughput at the target clock, i.e. PPT/II >= throughput/clock. Among the
+// feasible configurations the cheapest one according to the resource
+// estimate of the kernels is selected, see HostDataDeps::getKernelCost.
+// Operations of lambda functions are weighted for a 3x3 window. Fixed-point
+// conversion and narrowed streams require a single pixel per thread: their
+// savings are not known before the kernels are analyzed, hence ties prefer
+// fewer pixels per thread and -fixed-point restricts the search to PPT=1, as
+// do pyramids and interpolated accessors.
+// Both options apply to all kernels of the pipeline (HIPACC_PPT,
+// HIPACC_II_TARGET).
+void Rewrite::selectVivadoConfiguration() {
+  static const int MAX_PPT = 16, MAX_II = 16;
+  static const unsigned LAMBDA_WEIGHT = 9;
+
+  double pixelsPerCycle = compilerOptions.getTargetThroughput() /
+                          compilerOptions.getTargetClock();
+  bool vectorizable = !compilerOptions.useFixedPoint() &&
+                      !usesResampling(mainFD->getBody(), compilerClasses);
+  struct KernelOps {
+    OperationCount ops;
+    bool floatOps;
+    size_t bits;
+  };
+  std::vector<KernelOps> kernels;
+  for (auto it=KernelClassDeclMap.begin(), ei=KernelClassDeclMap.end();
+       it!=ei; ++it) {
+    HipaccKernelClass *KC = it->second;
+    if (!KC->getKernelFunction()) {
+      continue;
+    }
+    // reductions and histograms are computed on scalar streams only
+    if (KC->getReduceFunction() || KC->getBinningFunction()) {
+      vectorizable = false;
+    }
+    OperationCount body = KC->getKernelStatistics().getOperations();
+    OperationCount lambda = KC->getKernelStatistics().getLambdaOperations();
+    KernelOps k;
+    k.ops.ops = std::max(1u, body.ops + lambda.ops * LAMBDA_WEIGHT);
+    k.ops.mulOps = body.mulOps + lambda.mulOps * LAMBDA_WEIGHT;
+    k.ops.divOps = body.divOps + lambda.divOps * LAMBDA_WEIGHT;
+    k.ops.specialOps = body.specialOps + lambda.specialOps * LAMBDA_WEIGHT;
+    k.floatOps = false;
+    k.bits = 0;
+    // pixel types of the images, the full width before narrowing
+    for (auto member : KC->getMembers()) {
+      if (std::find(KC->getImgFields().begin(), KC->getImgFields().end(),
+                    member.field) == KC->getImgFields().end()) {
+        continue;
+      }
+      k.floatOps |= !compilerOptions.useFixedPoint() &&
+                    member.type->hasFloatingRepresentation();
+      k.bits = std::max(k.bits, (size_t)Context.getTypeSize(member.type));
+    }
+    kernels.push_back(k);
+  }
+
+  int ppt = 0, ii = 0;
+  size_t cost = 0;
+  for (int p = 1; p <= (vectorizable ? MAX_PPT : 1); p *= 2) {
+    for (int i = 1; i <= MAX_II; ++i) {
+      if ((double)p / i < pixelsPerCycle) {
+        break;
+      }
+      size_t c = 0;
+      for (auto it = kernels.begin(); it != kernels.end(); ++it) {
+        c += HostDataDeps::getKernelCost(it->ops, it->floatOps, it->bits, p,
+                                         i);
+      }
+      if (!ppt || c < cost) {
+        ppt = p;
+        ii = i;
+        cost = c;
+      }
+    }
+  }
+
+  if (!ppt) {
+    unsigned DiagIDThroughput = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Throughput of %0 Mpixel/s not reachable at %1 MHz for Vivado, "
+        "requires %2 pixels per cycle.");
+    std::ostringstream throughput, clock, pixels;
+    throughput << compilerOptions.getTargetThroughput();
+    clock << compilerOptions.getTargetClock();
+    pixels << pixelsPerCycle;
+    Diags.Report(DiagIDThroughput) << throughput.str() << clock.str()
+                                   << pixels.str();
+    exit(EXIT_FAILURE);
+  }
+
+  // the selected configuration is reported in the resource estimate
+  compilerOptions.setPixelsPerThread(ppt);
+  compilerOptions.setTargetII(ii);
+}
+
+
 void Rewrite::createVivadoEntry() {
   llvm::raw_ostream *OS = &llvm::errs();
   std::ostringstream file;
@@ -1461,17 +1655,27 @@ void Rewrite::createVivadoEntry() {
       compilerOptions.getPixelsPerThread();
   }
 
+  // line buffers are sized for the strips when strip-mining
+  dataDeps->setMaxSizes(maxImageWidth, maxImageHeight, maxWindowSizeX,
+      maxWindowSizeY);
+
   OS = new llvm::raw_fd_ostream(fd, false);
-  *OS << "#define HIPACC_MAX_WIDTH     " << maxImageWidth << "\n";
+  *OS << "#define HIPACC_MAX_WIDTH     " << dataDeps->getMaxLineWidth() << "\n";
   *OS << "#define HIPACC_MAX_HEIGHT    " << maxImageHeight << "\n";
   *OS << "#define HIPACC_WINDOW_SIZE_X " << maxWindowSizeX << "\n";
   *OS << "#define HIPACC_WINDOW_SIZE_Y " << maxWindowSizeY << "\n";
-  *OS << "#define BORDER_FILL_VALUE    0\n";
+  *OS << "#define BORDER_FILL_VALUE    "
+      << (vivadoBorderValue.empty() ? "0" : vivadoBorderValue) << "\n";
   *OS << "#define HIPACC_II_TARGET     " << compilerOptions.getTargetII() << "\n";
   *OS << "#define HIPACC_PPT           " << compilerOptions.getPixelsPerThread() << "\n";
+  if (compilerOptions.useStrips()) {
+    *OS << "#define HIPACC_STRIP_WIDTH   " << dataDeps->getStripWidth() << "\n";
+    *OS << "#define HIPACC_STRIP_HALO    " << dataDeps->getStripHalo() << "\n";
+  }
   *OS << "\n";
   *OS << "#include \"hipacc_vivado_types.hpp\"\n";
   *OS << "#include \"hipacc_vivado_filter.hpp\"\n\n";
+  *OS << dataDeps->printStreamTypes() << "\n";
 
   for (auto it=KernelDeclMap.begin(), ei=KernelDeclMap.end(); it!=ei; ++it) {
     *OS << "#include \"" << it->second->getFileName() << ".cc\"\n";
@@ -1482,6 +1686,22 @@ void Rewrite::createVivadoEntry() {
   OS->flush();
   fsync(fd);
   close(fd);
+
+  // estimated resources and latency of hipaccRun
+  file.str("hipacc_run_estimate.json");
+  while ((fd = open(file.str().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0664)) < 0) {
+    if (errno != EINTR) {
+      std::string errorInfo("Error opening output file '" + file.str() + "'");
+      perror(errorInfo.c_str());
+    }
+  }
+
+  OS = new llvm::raw_fd_ostream(fd, false);
+  *OS << dataDeps->printEstimate();
+
+  OS->flush();
+  fsync(fd);
+  close(fd);
 }
 
 
@@ -1492,6 +1712,10 @@ bool Rewrite::VisitFunctionDecl(FunctionDecl *D) {
     mainFD = D;
 
     if (compilerOptions.emitVivado()) {
+      // all kernel classes are known before main
+      if (compilerOptions.useTargetThroughput()) {
+        selectVivadoConfiguration();
+      }
       AnalysisDeclContext AC(0, mainFD);
       dataDeps = HostDataDeps::parse(Context, AC, compilerClasses,
           compilerOptions);
@@ -1820,8 +2044,11 @@ bool Rewrite::VisitBinaryOperator(BinaryOperator *E) {
             typeCast = "(" + getStdIntFromBitWidth(
                   info.elementCount * info.elementWidth) + "*)";
           }
-          // call entry function, which creates current output
-          newStr = dataDeps->printEntryCall(entryArguments, Img->getName());
+          // call entry function, which creates all outputs
+          if (!vivadoEntryCalled) {
+            newStr = dataDeps->printEntryCall(entryArguments, Img->getName());
+            vivadoEntryCalled = true;
+          }
           // TODO: find better solution than embedding stream in mem string
           stringCreator.writeMemoryTransfer(Img,
               stream + ", " + typeCast + DS.str(), DEVICE_TO_HOST, newStr);
@@ -1854,8 +2081,9 @@ bool Rewrite::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
   //    Image width, height, and stride -> kernel parameters
   // b) convert data() calls
   //    float *out = img.data();
-  // c) convert reduced_data() calls
+  // c) convert reduced_data() and binned_data() calls
   //    float min = MinReduction.reduced_data();
+  //    std::vector<uint> hist = Histogram.binned_data(256);
   // d) convert width()/height() calls
 
   if (auto DRE =
@@ -1885,8 +2113,9 @@ bool Rewrite::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
         stringCreator.writeKernelCall(K->getKernelName(), K->getKernelClass(),
             K, newStr);
 
-        // create reduce call string
-        if (K->getKernelClass()->getReduceFunction()) {
+        // create reduce call string, Vivado reduces within the entry function
+        if (K->getKernelClass()->getReduceFunction() &&
+            !compilerOptions.emitVivado()) {
           newStr += "\n" + stringCreator.getIndent();
           stringCreator.writeReductionDeclaration(K, newStr);
           stringCreator.writeReduceCall(K->getKernelClass(), K, newStr);
@@ -1912,10 +2141,48 @@ bool Rewrite::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
         // match for supported member calls
         if (ME->getMemberNameInfo().getAsString() == "reduced_data") {
           HipaccKernel *K = KernelDeclMap[DRE->getDecl()];
+          std::string reduceStr = K->getReduceStr();
+
+          if (compilerOptions.emitVivado()) {
+            // the reduced value is returned by the entry function, call it
+            // here unless this was done for an output image before
+            reduceStr = dataDeps->getReduceResult(K->getKernelName());
+            if (!vivadoEntryCalled) {
+              reduceStr = "(" + dataDeps->printEntryCall(entryArguments, "",
+                  false) + ", " + reduceStr + ")";
+              vivadoEntryCalled = true;
+            }
+          }
+
+          // replace member function invocation
+          SourceRange range(E->getLocStart(), E->getLocEnd());
+          TextRewriter.ReplaceText(range, reduceStr);
+
+          return true;
+        }
+
+        if (ME->getMemberNameInfo().getAsString() == "binned_data") {
+          HipaccKernel *K = KernelDeclMap[DRE->getDecl()];
+          std::string binStr;
+
+          if (compilerOptions.emitVivado()) {
+            // the histogram is returned by the entry function, call it here
+            // unless this was done before
+            binStr = dataDeps->getBinningResult(K->getKernelName());
+            if (!vivadoEntryCalled) {
+              binStr = "(" + dataDeps->printEntryCall(entryArguments, "",
+                  false) + ", " + binStr + ")";
+              vivadoEntryCalled = true;
+            }
+          } else {
+            // compute histogram of the output image
+            stringCreator.writeBinningCall(K, convertToString(E->getArg(0)),
+                binStr);
+          }
 
           // replace member function invocation
           SourceRange range(E->getLocStart(), E->getLocEnd());
-          TextRewriter.ReplaceText(range, K->getReduceStr());
+          TextRewriter.ReplaceText(range, binStr);
 
           return true;
         }
@@ -2169,7 +2436,7 @@ void Rewrite::printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
   FunctionDecl *fun = KC->getReduceFunction();
 
   // preprocessor defines
-  if (!compilerOptions.exploreConfig()) {
+  if (!compilerOptions.exploreConfig() && !compilerOptions.emitVivado()) {
     *OS << "#define BS " << K->getNumThreadsReduce() << "\n"
         << "#define PPT " << K->getPixelsPerThreadReduce() << "\n";
   }
@@ -2324,6 +2591,566 @@ void Rewrite::printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
 }
 
 
+void Rewrite::printBinningFunction(HipaccKernelClass *KC, HipaccKernel *K,
+    PrintingPolicy Policy, llvm::raw_ostream *OS) {
+  FunctionDecl *fun = KC->getBinningFunction();
+
+  switch (compilerOptions.getTargetLang()) {
+    case Language::Vivado:
+    case Language::C99: break;
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      if (compilerOptions.useTextureMemory() &&
+          compilerOptions.getTextureType()==Texture::Array2D) {
+        *OS << "#define USE_ARRAY_2D\n";
+      }
+      *OS << "#include \"hipacc_cl_bin.hpp\"\n\n";
+      break;
+    case Language::CUDA:
+    case Language::Renderscript:
+    case Language::Filterscript: {
+      unsigned DiagIDBinning = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+          "Histograms are only supported for C99, OpenCL, and Vivado "
+          "(kernel %0).");
+      Diags.Report(DiagIDBinning) << K->getKernelName();
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // write binning function
+  *OS << "inline " << fun->getReturnType().getAsString() << " "
+      << K->getBinningName() << "(";
+  size_t comma = 0;
+  for (auto param : fun->params()) {
+    std::string Name(param->getNameAsString());
+    QualType T = param->getType();
+    if (comma++) *OS << ", ";
+    T.getAsStringInternal(Name, Policy);
+    *OS << Name;
+  }
+  *OS << ") ";
+
+  // print function body
+  fun->getBody()->printPretty(*OS, 0, Policy, 0);
+
+  // instantiate histogram
+  switch (compilerOptions.getTargetLang()) {
+    default: break;
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      // sub-histograms in local memory
+      *OS << "BINNING_CL_2D(" << K->getBinningName() << "2D, "
+          << K->getIterationSpace()->getImage()->getTypeStr() << ", "
+          << K->getBinningName() << ", "
+          << K->getIterationSpace()->getImage()->getImageReadFunction()
+          << ")\n";
+      // sum up sub-histograms
+      *OS << "BINNING_CL_1D(" << K->getBinningName() << "1D)\n";
+      *OS << "#include \"hipacc_undef.hpp\"\n";
+      break;
+  }
+
+  *OS << "\n";
+}
+
+
+// check whether the kernel computes nothing but a single convolution, e.g.
+// output() = convolve(M, Reduce::SUM, [&] () { return M() * Input(M); });
+bool Rewrite::isSeparableConvolution(HipaccKernelClass *KC, HipaccKernel *K,
+    HipaccMask *&Mask, QualType &AccType) {
+  if (KC->getMaskFields().size() != 1 || KC->getImgFields().size() != 2) {
+    return false;
+  }
+
+  // match convolve(M, Reduce::SUM, [&] () { return M() * Acc(M); })
+  auto getConvolution = [&] (Expr *E) -> HipaccMask * {
+    auto MCE = dyn_cast<CXXMemberCallExpr>(E->IgnoreParenCasts());
+    if (!MCE || !MCE->getDirectCallee() || MCE->getNumArgs() != 3 ||
+        !MCE->getDirectCallee()->getName().equals("convolve")) {
+      return nullptr;
+    }
+
+    auto ME = dyn_cast<MemberExpr>(MCE->getArg(0)->IgnoreImpCasts());
+    if (!ME || !isa<FieldDecl>(ME->getMemberDecl())) return nullptr;
+    ValueDecl *maskFD = ME->getMemberDecl();
+    HipaccMask *M = K->getMaskFromMapping(cast<FieldDecl>(maskFD));
+    if (!M) return nullptr;
+
+    llvm::APSInt mode;
+    if (!MCE->getArg(1)->EvaluateAsInt(mode, Context) ||
+        mode.getZExtValue() != static_cast<std::underlying_type<Reduce>::type>(
+          Reduce::SUM)) {
+      return nullptr;
+    }
+
+    auto MTE = dyn_cast<MaterializeTemporaryExpr>(MCE->getArg(2));
+    if (!MTE) return nullptr;
+    auto LE = dyn_cast<LambdaExpr>(MTE->GetTemporaryExpr()->IgnoreImpCasts());
+    if (!LE) return nullptr;
+    auto CS = dyn_cast<CompoundStmt>(LE->getBody());
+    if (!CS || CS->size() != 1) return nullptr;
+    auto RS = dyn_cast<ReturnStmt>(CS->body_front());
+    if (!RS || !RS->getRetValue()) return nullptr;
+    auto BO = dyn_cast<BinaryOperator>(RS->getRetValue()->IgnoreParenImpCasts());
+    if (!BO || BO->getOpcode() != BO_Mul) return nullptr;
+
+    bool hasMask = false, hasAcc = false;
+    for (auto operand : { BO->getLHS(), BO->getRHS() }) {
+      auto OCE = dyn_cast<CXXOperatorCallExpr>(operand->IgnoreParenCasts());
+      if (!OCE) return nullptr;
+      auto OME = dyn_cast<MemberExpr>(OCE->getArg(0)->IgnoreImpCasts());
+      if (!OME || !isa<FieldDecl>(OME->getMemberDecl())) return nullptr;
+      FieldDecl *FD = cast<FieldDecl>(OME->getMemberDecl());
+
+      if (OCE->getNumArgs() == 1 && FD == maskFD) {
+        hasMask = true;
+      } else if (OCE->getNumArgs() == 2 && K->getImgFromMapping(FD)) {
+        auto AME = dyn_cast<MemberExpr>(OCE->getArg(1)->IgnoreImpCasts());
+        if (!AME || AME->getMemberDecl() != maskFD) return nullptr;
+        hasAcc = true;
+      } else {
+        return nullptr;
+      }
+    }
+    if (!hasMask || !hasAcc) return nullptr;
+
+    AccType = LE->getCallOperator()->getReturnType();
+    return M;
+  };
+
+  // variables holding zero or the convolution result
+  std::set<VarDecl *> zeroVars, convVars;
+  auto isZero = [&] (Expr *E) -> bool {
+    Expr::EvalResult val;
+    if (!E->EvaluateAsRValue(val, Context)) return false;
+    return (val.Val.isInt() && val.Val.getInt() == 0) ||
+           (val.Val.isFloat() && val.Val.getFloat().isZero());
+  };
+  auto isConv = [&] (Expr *E) -> bool {
+    if (auto DRE = dyn_cast<DeclRefExpr>(E->IgnoreParenCasts())) {
+      auto VD = dyn_cast<VarDecl>(DRE->getDecl());
+      return VD && convVars.count(VD);
+    }
+    // only a single convolution is supported
+    if (Mask) return false;
+    Mask = getConvolution(E);
+    return Mask != nullptr;
+  };
+  auto isAccType = [&] (VarDecl *VD) -> bool {
+    return VD->getType().getCanonicalType().getUnqualifiedType() ==
+           AccType.getCanonicalType().getUnqualifiedType();
+  };
+
+  auto CS = dyn_cast<CompoundStmt>(KC->getKernelFunction()->getBody());
+  if (!CS) return false;
+
+  Mask = nullptr;
+  bool written = false;
+  for (auto S : CS->body()) {
+    // writing the output has to be the last statement
+    if (written) return false;
+
+    // T sum = 0; or T sum = convolve(...);
+    if (auto DS = dyn_cast<DeclStmt>(S)) {
+      if (!DS->isSingleDecl()) return false;
+      auto VD = dyn_cast<VarDecl>(DS->getSingleDecl());
+      if (!VD) return false;
+      if (!VD->hasInit() || isZero(VD->getInit())) {
+        zeroVars.insert(VD);
+      } else if (isConv(VD->getInit()) && isAccType(VD)) {
+        convVars.insert(VD);
+      } else {
+        return false;
+      }
+      continue;
+    }
+
+    auto BO = dyn_cast<BinaryOperator>(S);
+    if (!BO) return false;
+
+    // output() = sum; or output() = convolve(...);
+    if (auto MCE = dyn_cast<CXXMemberCallExpr>(
+          BO->getLHS()->IgnoreParenImpCasts())) {
+      if (BO->getOpcode() != BO_Assign || !MCE->getDirectCallee() ||
+          !MCE->getDirectCallee()->getName().equals("output") ||
+          !isConv(BO->getRHS())) {
+        return false;
+      }
+      written = true;
+      continue;
+    }
+
+    // sum = convolve(...); or sum += convolve(...); with sum being zero
+    auto DRE = dyn_cast<DeclRefExpr>(BO->getLHS()->IgnoreParenImpCasts());
+    auto VD = DRE ? dyn_cast<VarDecl>(DRE->getDecl()) : nullptr;
+    if (!VD) return false;
+    if ((BO->getOpcode() == BO_Assign ||
+         (BO->getOpcode() == BO_AddAssign && zeroVars.count(VD))) &&
+        isConv(BO->getRHS()) && isAccType(VD)) {
+      zeroVars.erase(VD);
+      convVars.insert(VD);
+      continue;
+    }
+    return false;
+  }
+
+  return written && Mask;
+}
+
+
+// Range of the pixels read by an accessor: the range of the result of the
+// kernel producing a narrowed stream, or else the full range of integer pixel
+// types. Converting floating-point pixels to a fixed-point format rounds.
+bool Rewrite::getInputRange(HipaccKernel *K, HipaccAccessor *Acc,
+    ValueRange &range, bool &rounded) {
+  QualType QT = Acc->getImage()->getType();
+  rounded = QT->isRealFloatingType();
+  if (compilerOptions.emitVivado() &&
+      dataDeps->getInputRange(K->getKernelName(), Acc->getName(), range.lo,
+        range.hi)) {
+    return true;
+  }
+  return RangeAnalysis::getTypeRange(Context, QT, range);
+}
+
+
+static Expr *createFixedPointCast(ASTContext &Ctx, QualType T, CastKind Kind,
+    Expr *E) {
+  Expr *val = E->IgnoreImpCasts();
+  if (!isa<DeclRefExpr>(val) && !isa<ArraySubscriptExpr>(val) &&
+      !isa<CallExpr>(val) && !isa<ParenExpr>(val) &&
+      !isa<FloatingLiteral>(val) && !isa<IntegerLiteral>(val)) {
+    E = createParenExpr(Ctx, E);
+  }
+  return createCStyleCastExpr(Ctx, T, Kind, E, nullptr,
+      Ctx.getTrivialTypeSourceInfo(T));
+}
+
+
+// Converts the floating-point variables, literals, and casts of a kernel body
+// to the fixed-point type FixedTy and makes conversions to integers explicit.
+// Reads of fixed-point streams are converted to FixedTy, or to their
+// floating-point type if the kernel is not converted. Reads of narrowed
+// integer streams are converted to their integer type.
+static Stmt *convertFixedPointStmt(ASTContext &Ctx, RangeAnalysis &RA,
+    llvm::SmallPtrSetImpl<const ValueDecl *> &inputs, Stmt *S,
+    QualType FixedTy, QualType RetTy, bool converted) {
+  auto convert = [&] (Expr *E) -> Expr * {
+    return cast_or_null<Expr>(convertFixedPointStmt(Ctx, RA, inputs, E,
+          FixedTy, RetTy, converted));
+  };
+
+  if (!S) {
+    return S;
+  }
+
+  if (Expr *E = dyn_cast<Expr>(S)) {
+    Expr *read = E->IgnoreParens();
+    if (ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(read)) {
+      if (ICE->getCastKind() == CK_LValueToRValue) {
+        read = ICE->getSubExpr()->IgnoreParens();
+      }
+    }
+    if (isa<DeclRefExpr>(read) || isa<ArraySubscriptExpr>(read) ||
+        isa<CallExpr>(read)) {
+      const ValueDecl *VD = RA.getInput(read);
+      if (VD && inputs.count(VD)) {
+        if (E->getType()->isRealFloatingType()) {
+          return createFixedPointCast(Ctx, converted ? FixedTy : E->getType(),
+              CK_NoOp, E);
+        }
+        if (E->getType()->isIntegerType()) {
+          return createFixedPointCast(Ctx, E->getType(), CK_NoOp, E);
+        }
+      }
+    }
+
+    if (converted) {
+      if (isa<FloatingLiteral>(E)) {
+        return createFixedPointCast(Ctx, FixedTy, CK_NoOp, E);
+      }
+      if (CStyleCastExpr *CSCE = dyn_cast<CStyleCastExpr>(E)) {
+        if (CSCE->getType()->isRealFloatingType()) {
+          return createFixedPointCast(Ctx, FixedTy, CSCE->getCastKind(),
+              convert(CSCE->getSubExpr()));
+        }
+      }
+      if (ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(E)) {
+        if (ICE->getCastKind() == CK_FloatingToIntegral ||
+            ICE->getCastKind() == CK_FloatingToBoolean) {
+          return createFixedPointCast(Ctx, ICE->getType(), ICE->getCastKind(),
+              convert(ICE->getSubExpr()));
+        }
+      }
+    }
+  }
+
+  if (DeclStmt *DS = dyn_cast<DeclStmt>(S)) {
+    for (auto it = DS->decl_begin(); it != DS->decl_end(); ++it) {
+      VarDecl *VD = dyn_cast<VarDecl>(*it);
+      if (!VD) {
+        continue;
+      }
+      if (converted && VD->getType()->isRealFloatingType()) {
+        QualType QT = Ctx.getQualifiedType(FixedTy,
+            VD->getType().getQualifiers());
+        VD->setType(QT);
+        VD->setTypeSourceInfo(Ctx.getTrivialTypeSourceInfo(QT));
+      }
+      if (VD->getInit()) {
+        VD->setInit(convert(VD->getInit()));
+      }
+    }
+    return S;
+  }
+
+  if (ReturnStmt *RS = dyn_cast<ReturnStmt>(S)) {
+    Expr *val = RS->getRetValue();
+    if (val) {
+      bool isFloat = val->getType()->isRealFloatingType();
+      val = convert(val);
+      if (converted && isFloat) {
+        val = createFixedPointCast(Ctx, RetTy, CK_NoOp, val);
+      }
+      RS->setRetValue(val);
+    }
+    return S;
+  }
+
+  for (auto it = S->child_begin(); it != S->child_end(); ++it) {
+    *it = convertFixedPointStmt(Ctx, RA, inputs, *it, FixedTy, RetTy,
+        converted);
+  }
+
+  return S;
+}
+
+
+// integer variables declared within a kernel body
+static void getLocalVars(Stmt *S, SmallVectorImpl<VarDecl *> &vars) {
+  if (!S) {
+    return;
+  }
+  if (DeclStmt *DS = dyn_cast<DeclStmt>(S)) {
+    for (auto it = DS->decl_begin(); it != DS->decl_end(); ++it) {
+      VarDecl *VD = dyn_cast<VarDecl>(*it);
+      if (VD && VD->getType()->isIntegerType() &&
+          !VD->getType()->isBooleanType()) {
+        vars.push_back(VD);
+      }
+    }
+  }
+  for (auto it = S->child_begin(); it != S->child_end(); ++it) {
+    getLocalVars(*it, vars);
+  }
+}
+
+
+static void setVarType(ASTContext &Ctx, VarDecl *VD, QualType QT) {
+  QT = Ctx.getQualifiedType(QT, VD->getType().getQualifiers());
+  VD->setType(QT);
+  VD->setTypeSourceInfo(Ctx.getTrivialTypeSourceInfo(QT));
+}
+
+
+// Floating-point operations round their result with a relative error of at
+// most 2^-24. The absolute rounding error of a fixed-point format is at least
+// as large if its fractional bits fit the magnitude of all values.
+static bool analyzeFloatingPoint(RangeAnalysis &RA, Stmt *body) {
+  for (int fracBits = 23; fracBits > -FLT_MAX_EXP; --fracBits) {
+    if (!RA.analyze(body, fracBits)) {
+      return false;
+    }
+    if (std::ldexp(RA.getMaxAbs(), -24) <= std::ldexp(1.0, -fracBits-1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Narrows the types of a kernel using the ranges of the values of its inputs.
+//
+// Vivado kernels computing floating-point values are converted to the
+// smallest fixed-point format that keeps the error of the kernel result below
+// half the error bound set by -fixed-point, the other half is left for
+// rounding the result to the format of the output stream. The kernel is
+// converted as a whole if the ranges of all inputs are known, otherwise it
+// keeps floating-point types. The range of integer kernel results selects the
+// type of the output stream. Integer variables use the narrowest ap_int type
+// if the kernel computes no floating-point values, uses no operators
+// depending on the width of their operands, and computes no values wrapping
+// around.
+//
+// C99 kernels use the narrowest C integer type promoting to int for their
+// int variables, packing more of them into a vector register. Returns the
+// typedef of the fixed-point format.
+std::string Rewrite::narrowKernelTypes(FunctionDecl *D, HipaccKernel *K) {
+  bool vivado = compilerOptions.emitVivado();
+  RangeAnalysis RA(Context);
+  llvm::SmallPtrSet<const ValueDecl *, 16> inputs;
+  bool known = true;
+
+  size_t num_arg = 0;
+  for (auto param : D->params()) {
+    FieldDecl *FD = K->getDeviceArgFields()[num_arg++];
+    if (HipaccMask *Mask = K->getMaskFromMapping(FD)) {
+      // constant masks are propagated as literals, runtime-loaded
+      // coefficients may take any value of their type
+      if (!Mask->isConstant()) {
+        ValueRange range;
+        if (RangeAnalysis::getTypeRange(Context, Mask->getType(), range)) {
+          RA.addInput(param, range.lo, range.hi, false);
+        } else {
+          RA.addInput(param, -FLT_MAX, FLT_MAX, false);
+          known = false;
+        }
+      }
+      continue;
+    }
+
+    HipaccAccessor *Acc = K->getImgFromMapping(FD);
+    if (Acc) {
+      if (Acc->isIterationSpace()) {
+        // C99 kernels store their result to the iteration space
+        RA.addOutput(param);
+        continue;
+      }
+      ValueRange range;
+      bool rounded;
+      if (getInputRange(K, Acc, range, rounded)) {
+        RA.addInput(param, range.lo, range.hi, rounded);
+      } else {
+        // the producer keeps floating-point types
+        RA.addInput(param, -FLT_MAX, FLT_MAX, true);
+        known = false;
+      }
+      if (vivado &&
+          dataDeps->isNarrowedInput(K->getKernelName(), Acc->getName())) {
+        inputs.insert(param);
+      }
+      continue;
+    }
+
+    ValueRange range;
+    if (RangeAnalysis::getTypeRange(Context, param->getType(), range)) {
+      RA.addInput(param, range.lo, range.hi, false);
+    } else {
+      // floating-point scalar parameters have unknown ranges
+      RA.addInput(param, -FLT_MAX, FLT_MAX, false);
+      known = false;
+    }
+  }
+
+  HipaccImage *out = K->getIterationSpace()->getImage();
+  bool vect = isa<VectorType>(out->getType().getCanonicalType().getTypePtr());
+
+  if (!vivado) {
+    SmallVector<VarDecl *, 16> vars;
+    getLocalVars(D->getBody(), vars);
+    if (vect || vars.empty() || !analyzeFloatingPoint(RA, D->getBody())) {
+      return "";
+    }
+
+    // only int variables are narrowed: short and signed char are promoted
+    // back to int, so all expressions keep their type and value
+    QualType types[] = { Context.SignedCharTy, Context.ShortTy };
+    for (auto VD : vars) {
+      ValueRange range, typeRange;
+      if (!Context.hasSameUnqualifiedType(VD->getType(), Context.IntTy) ||
+          !RA.getVarRange(VD, range)) {
+        continue;
+      }
+      for (auto QT : types) {
+        RangeAnalysis::getTypeRange(Context, QT, typeRange);
+        if (typeRange.lo <= range.lo - range.err &&
+            range.hi + range.err <= typeRange.hi) {
+          setVarType(Context, VD, QT);
+          break;
+        }
+      }
+    }
+    return "";
+  }
+
+  QualType RetTy = out->getType();
+  std::string retType = dataDeps->getOutputTypeStr(K->getKernelName(), out, 1);
+  if (retType != createVivadoTypeStr(out, 1)) {
+    TypedefDecl *TD = TypedefDecl::Create(Context,
+        Context.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+        &Context.Idents.get(retType), Context.getTrivialTypeSourceInfo(RetTy));
+    RetTy = Context.getTypedefType(TD);
+  }
+
+  std::string fixedType = K->getKernelName() + "Fixed";
+  TypedefDecl *TD = TypedefDecl::Create(Context,
+      Context.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+      &Context.Idents.get(fixedType),
+      Context.getTrivialTypeSourceInfo(Context.FloatTy));
+  QualType FixedTy = Context.getTypedefType(TD);
+
+  FixedPointFormat format;
+  ValueRange result;
+  bool converted = compilerOptions.useFixedPoint() && known && !vect &&
+    RA.computeFormat(D->getBody(), compilerOptions.getFixedPointError() / 2,
+        format, result) && RA.usesFloat();
+  bool analyzed = converted || (!vect &&
+      analyzeFloatingPoint(RA, D->getBody()));
+
+  if (analyzed && RA.hasResult() && out->getType()->isIntegerType()) {
+    result = RA.getResult();
+    dataDeps->setOutputRange(K->getKernelName(),
+        std::floor(result.lo - result.err), std::ceil(result.hi + result.err));
+  }
+
+  if (analyzed && !RA.usesFloat() && !RA.usesWidthDependentOps() &&
+      !RA.usesWrappingOps()) {
+    SmallVector<VarDecl *, 16> vars;
+    getLocalVars(D->getBody(), vars);
+    for (auto VD : vars) {
+      ValueRange range;
+      if (!RA.getVarRange(VD, range)) {
+        continue;
+      }
+      // signed types avoid mixing signed and unsigned operands
+      IntegerFormat format = IntegerFormat::get(range);
+      if (!format.isSigned) {
+        format = IntegerFormat(format.width + 1, true);
+      }
+      if ((uint64_t)format.width < Context.getTypeSize(VD->getType())) {
+        TypedefDecl *TD = TypedefDecl::Create(Context,
+            Context.getTranslationUnitDecl(), SourceLocation(),
+            SourceLocation(), &Context.Idents.get(format.getTypeStr()),
+            Context.getTrivialTypeSourceInfo(VD->getType()));
+        setVarType(Context, VD, Context.getTypedefType(TD));
+      }
+    }
+  }
+
+  if (!converted && inputs.empty()) {
+    return "";
+  }
+  convertFixedPointStmt(Context, RA, inputs, D->getBody(), FixedTy, RetTy,
+      converted);
+  if (!converted) {
+    return "";
+  }
+
+  if (out->getType()->isRealFloatingType()) {
+    dataDeps->setOutputRange(K->getKernelName(), result.lo - result.err,
+        result.hi + result.err);
+  }
+
+  std::ostringstream typeDef;
+  typeDef << "// result in [" << result.lo << ", " << result.hi
+          << "], error at most " << result.err << "\n"
+          << "typedef " << format.getTypeStr() << " " << fixedType << ";\n\n";
+  return typeDef.str();
+}
+
+
 void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
     HipaccKernel *K, std::string file, bool emitHints) {
   PrintingPolicy Policy = Context.getPrintingPolicy();
@@ -2637,6 +3464,8 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
   // write kernel name and qualifiers
   switch (compilerOptions.getTargetLang()) {
     case Language::C99:
+      narrowKernelTypes(D, K);
+      break;
     case Language::Renderscript:
       break;
     case Language::CUDA:
@@ -2667,6 +3496,7 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
       }
       break;
     case Language::Vivado:
+      *OS << narrowKernelTypes(D, K);
       *OS << "struct " << K->getKernelName() << "Kernel {\n";
       printKernelArguments(D, KC, K, Policy, OS, Rewrite::Member);
       *OS << "\n";
@@ -2675,8 +3505,8 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
       *OS << ") {\n";
       printKernelArguments(D, KC, K, Policy, OS, Rewrite::CTorBody);
       *OS << "  }\n\n";
-      *OS << "  " <<
-        createVivadoTypeStr(K->getIterationSpace()->getImage(), 1);
+      *OS << "  " << dataDeps->getOutputTypeStr(K->getKernelName(),
+          K->getIterationSpace()->getImage(), 1);
       *OS << " operator()(";
       printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelDecl);
       *OS << ") ";
@@ -2709,53 +3539,253 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
     *OS << "};\n\n";
     *OS << "void " << K->getKernelName() << "(";
     printKernelArguments(D, KC, K, Policy, OS, Rewrite::Entry);
-    *OS << ", int IS_width, int IS_height) {\n"
-        << "    struct " << K->getKernelName() << "Kernel kernel";
-    printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelInit);
-    *OS << ";\n";
+    *OS << ", int IS_width, int IS_height) {\n";
 
+    // border handling is a template parameter of the process functions
+    std::string borderPadding;
     if (KC->getMaskFields().size() > 0) {
-      *OS << "    process";
-      if (KC->getImgFields().size() > 2) {
-        *OS << "MISO";
+      Boundary mode = Boundary::UNDEFINED;
+      for (auto img : KC->getImgFields()) {
+        HipaccAccessor *Acc = K->getImgFromMapping(img);
+        if (!Acc || Acc->isIterationSpace()) continue;
+        if (mode != Boundary::UNDEFINED && mode != Acc->getBoundaryMode()) {
+          unsigned DiagIDMode = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+              "All Accessors of kernel %0 must use the same BoundaryMode for "
+              "Vivado.");
+          Diags.Report(DiagIDMode) << K->getKernelName();
+          exit(EXIT_FAILURE);
+        }
+        mode = Acc->getBoundaryMode();
+        if (mode == Boundary::CONSTANT) {
+          if (isa<VectorType>(Acc->getImage()->getType()
+                .getCanonicalType().getTypePtr())) {
+            unsigned DiagIDVector = Diags.getCustomDiagID(
+                DiagnosticsEngine::Error,
+                "Boundary::CONSTANT is only supported for scalar pixels for "
+                "Vivado (kernel %0).");
+            Diags.Report(DiagIDVector) << K->getKernelName();
+            exit(EXIT_FAILURE);
+          }
+          // BORDER_FILL_VALUE is shared by all processes of the pipeline
+          std::string value = convertToString(Acc->getConstExpr());
+          if (!vivadoBorderValue.empty() && vivadoBorderValue != value) {
+            unsigned DiagIDValue = Diags.getCustomDiagID(
+                DiagnosticsEngine::Error,
+                "Boundary::CONSTANT of kernel %0 uses value %1, but all "
+                "constant BoundaryConditions must use the same value for "
+                "Vivado (%2).");
+            Diags.Report(DiagIDValue) << K->getKernelName() << value
+                                      << vivadoBorderValue;
+            exit(EXIT_FAILURE);
+          }
+          vivadoBorderValue = value;
+        }
       }
-    } else {
-      *OS << "    processPixels";
-      if (KC->getImgFields().size() > 2) {
-        *OS << KC->getImgFields().size()-1;
-      }
-    }
-    if (compilerOptions.getPixelsPerThread() > 1 ||
-        isa<VectorType>(K->getVivadoAccessor()->getImage()->getType().getCanonicalType().getTypePtr())) {
-      *OS << "VECT";
-      if (K->getVivadoAccessor()->getImage()->getType()->isRealFloatingType()) {
-        *OS << "F";
-      }
-    }
-    *OS << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT";
-    *OS << "," << vivadoSizeX << "," << vivadoSizeY;
-    if (compilerOptions.getPixelsPerThread() > 1 ||
-        isa<VectorType>(K->getVivadoAccessor()->getImage()->getType().getCanonicalType().getTypePtr())) {
-      *OS << ",HIPACC_PPT";
-      *OS << "," << K->getVivadoAccessor()->getImage()->getTypeStr() << " ";
-    }
-    *OS << ">(";
-    printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelCall);
-    *OS << ", Output"
-        << ", IS_width"
-        << ", IS_height"
-        << ", kernel";
-    if (KC->getMaskFields().size() > 0) {
-      switch (vivadoBM) {
-        case clang::hipacc::Boundary::CLAMP:
-          *OS << ", BorderPadding::BORDER_CLAMP";
+      switch (mode) {
+        case Boundary::UNDEFINED:
+          borderPadding = ",BorderPadding::BORDER_UNDEFINED";
           break;
-        case clang::hipacc::Boundary::MIRROR:
-          *OS << ", BorderPadding::BORDER_MIRROR";
+        case Boundary::CLAMP:
+          borderPadding = ",BorderPadding::BORDER_CLAMP";
           break;
-        default:
-          assert(false && "Chosen BoundaryCondition not supported for Vivado");
+        case Boundary::MIRROR:
+          borderPadding = ",BorderPadding::BORDER_MIRROR";
+          break;
+        case Boundary::CONSTANT:
+          borderPadding = ",BorderPadding::BORDER_CONST";
           break;
+        case Boundary::REPEAT: {
+          // wrapping around requires pixels of the opposite image border that
+          // have not been streamed in yet
+          unsigned DiagIDRepeat = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+              "Boundary::REPEAT is not supported for Vivado (kernel %0).");
+          Diags.Report(DiagIDRepeat) << K->getKernelName();
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+
+    // results read by several kernels are written to one stream per consumer
+    size_t numOut = dataDeps->getNumOutputStreams(K->getKernelName());
+    size_t numIn = KC->getImgFields().size()-1;
+    bool vect = compilerOptions.getPixelsPerThread() > 1 ||
+      isa<VectorType>(K->getVivadoAccessor()->getImage()->getType()
+          .getCanonicalType().getTypePtr());
+    if (vect && (KC->getReduceFunction() || KC->getBinningFunction())) {
+      // global operators accumulate a single pixel per clock cycle
+      unsigned DiagIDVect = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+          "%0 of kernel %1 with vector pixels or multiple pixels per thread "
+          "are not supported for Vivado.");
+      Diags.Report(DiagIDVect)
+        << (KC->getReduceFunction() ? "Reductions" : "Histograms")
+        << K->getKernelName();
+      exit(EXIT_FAILURE);
+    }
+
+    // rank-1 constant masks are applied as row FIR followed by column FIR
+    HipaccMask *sepMask = nullptr;
+    QualType sepType;
+    SmallVector<double, 16> rowCoef, colCoef;
+    bool separable = !vect && numOut == 1 &&
+      isSeparableConvolution(KC, K, sepMask, sepType) &&
+      sepMask->getSeparableCoefficients(Context, rowCoef, colCoef);
+
+    // the accumulator and coefficients of kernels converted to fixed-point
+    // use the format bounding the error of the result, integer accumulators
+    // the narrowest type holding all partial sums
+    std::string sepTypeStr = separable ? sepType.getAsString() : "";
+    std::string coefTypeStr = separable ? sepMask->getTypeStr() : "";
+    QualType outType = K->getIterationSpace()->getImage()->getType();
+    ValueRange sepIn;
+    bool sepRounded;
+    FixedPointFormat sepFormat;
+    if (separable && sepType->isIntegerType() &&
+        sepMask->getType()->isIntegerType() &&
+        getInputRange(K, K->getVivadoAccessor(), sepIn, sepRounded) &&
+        !sepRounded) {
+      ValueRange sepAcc, sepOut, outRange;
+      RangeAnalysis::computeSeparableRange(sepIn, rowCoef, colCoef, sepAcc,
+          sepOut);
+      IntegerFormat accFormat = IntegerFormat::get(sepAcc);
+      if ((uint64_t)accFormat.width < Context.getTypeSize(sepType)) {
+        sepTypeStr = accFormat.getTypeStr();
+      }
+      if (RangeAnalysis::getTypeRange(Context, outType, outRange) &&
+          outRange.lo <= sepOut.lo && sepOut.hi <= outRange.hi) {
+        dataDeps->setOutputRange(K->getKernelName(), sepOut.lo, sepOut.hi);
+      }
+    } else if (separable && compilerOptions.useFixedPoint() &&
+        sepMask->getType()->isRealFloatingType() &&
+        outType->isRealFloatingType() &&
+        getInputRange(K, K->getVivadoAccessor(), sepIn, sepRounded) &&
+        RangeAnalysis::computeSeparableFormat(sepIn, sepRounded, rowCoef,
+          colCoef, compilerOptions.getFixedPointError() / 2, sepFormat)) {
+      sepTypeStr = coefTypeStr = sepFormat.getTypeStr();
+      double rowSum = 0, colSum = 0;
+      for (auto c : rowCoef) rowSum += std::fabs(c);
+      for (auto c : colCoef) colSum += std::fabs(c);
+      double absOut = std::max(std::fabs(sepIn.lo), std::fabs(sepIn.hi)) *
+        rowSum * colSum + compilerOptions.getFixedPointError() / 2;
+      dataDeps->setOutputRange(K->getKernelName(), -absOut, absOut);
+    }
+
+    std::ostringstream sepCoef;
+    if (separable) {
+      auto printCoef = [&] (std::string name, SmallVectorImpl<double> &coef) {
+        sepCoef << "    static const " << coefTypeStr << " " << name
+                << "[" << coef.size() << "] = { ";
+        for (size_t i=0; i<coef.size(); ++i) {
+          if (i) sepCoef << ", ";
+          if (sepMask->getType()->isIntegerType()) {
+            sepCoef << (long long)coef[i];
+          } else {
+            std::ostringstream val;
+            val.precision(9);
+            val << std::showpoint << coef[i];
+            sepCoef << val.str();
+            if (sepMask->getType()->isSpecificBuiltinType(BuiltinType::Float)) {
+              sepCoef << "f";
+            }
+          }
+        }
+        sepCoef << " };\n";
+      };
+      printCoef("rowCoef", rowCoef);
+      printCoef("colCoef", colCoef);
+    }
+
+    // template parameters for processes with fused point operators, see
+    // HostDataDeps::fuseProcesses()
+    bool local = KC->getMaskFields().size() > 0;
+    dataDeps->setProcessInfo(K->getKernelName(), local, vect,
+        local ? vivadoSizeX : "1", local ? vivadoSizeY : "1",
+        local ? borderPadding.substr(1) : "",
+        dataDeps->getInputTypeStr(K->getKernelName(),
+          K->getVivadoAccessor()->getName(), K->getVivadoAccessor()->getImage(),
+          1),
+        dataDeps->getOutputTypeStr(K->getKernelName(),
+          K->getIterationSpace()->getImage(), 1),
+        sepCoef.str(), sepTypeStr);
+
+    // operations for the resource estimate, computed in floating-point unless
+    // converted to fixed-point
+    bool floatOps = !compilerOptions.useFixedPoint() &&
+      (outType->hasFloatingRepresentation() ||
+       K->getVivadoAccessor()->getImage()->getType()
+         ->hasFloatingRepresentation());
+    dataDeps->setKernelOperations(K->getKernelName(),
+        KC->getKernelStatistics().getOperations(),
+        KC->getKernelStatistics().getLambdaOperations(), floatOps);
+
+    if (separable) {
+      *OS << sepCoef.str();
+      *OS << "    processSeparable<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,"
+          << "HIPACC_MAX_HEIGHT," << sepMask->getSizeX() << ","
+          << sepMask->getSizeY() << borderPadding << ","
+          << sepTypeStr << ">(";
+      printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelCall);
+      *OS << ", Output"
+          << ", IS_width"
+          << ", IS_height"
+          << ", rowCoef"
+          << ", colCoef";
+    } else {
+      *OS << "    struct " << K->getKernelName() << "Kernel kernel";
+      printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelInit);
+      *OS << ";\n";
+
+      if (!vect && (numIn > 1 || numOut > 1)) {
+        // any number of input and output streams in a single process
+        if (KC->getMaskFields().size() > 0) {
+          *OS << "    processMIMO";
+        } else {
+          *OS << "    processPixelsMIMO";
+        }
+        *OS << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT";
+        *OS << "," << vivadoSizeX << "," << vivadoSizeY << borderPadding;
+        *OS << "," << numOut
+            << "," << dataDeps->getInputTypeStr(K->getKernelName(),
+                  K->getVivadoAccessor()->getName(),
+                  K->getVivadoAccessor()->getImage(), 1)
+            << "," << dataDeps->getOutputTypeStr(K->getKernelName(),
+                  K->getIterationSpace()->getImage(), 1)
+            << ">(IS_width, IS_height, kernel";
+        for (size_t i=0; i<numOut; ++i) {
+          *OS << ", Output";
+          if (i) *OS << i;
+        }
+        *OS << ", ";
+        printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelCall);
+      } else {
+        if (KC->getMaskFields().size() > 0) {
+          *OS << "    process";
+          if (numIn > 1) {
+            *OS << "MISO";
+          }
+        } else {
+          *OS << "    processPixels";
+          if (numIn > 1) {
+            *OS << numIn;
+          }
+        }
+        if (vect) {
+          *OS << "VECT";
+          if (K->getVivadoAccessor()->getImage()->getType()->isRealFloatingType()) {
+            *OS << "F";
+          }
+        }
+        *OS << "<HIPACC_II_TARGET,HIPACC_MAX_WIDTH,HIPACC_MAX_HEIGHT";
+        *OS << "," << vivadoSizeX << "," << vivadoSizeY << borderPadding;
+        if (vect) {
+          *OS << ",HIPACC_PPT";
+          *OS << "," << K->getVivadoAccessor()->getImage()->getTypeStr() << " ";
+        }
+        *OS << ">(";
+        printKernelArguments(D, KC, K, Policy, OS, Rewrite::KernelCall);
+        *OS << ", Output"
+            << ", IS_width"
+            << ", IS_height"
+            << ", kernel";
       }
     }
     *OS << ");\n}\n";
@@ -2765,6 +3795,9 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
   if (KC->getReduceFunction()) {
     printReductionFunction(KC, K, Policy, OS);
   }
+  if (KC->getBinningFunction()) {
+    printBinningFunction(KC, K, Policy, OS);
+  }
 
   *OS << "#endif //" + ifdef + "\n";
   *OS << "\n";
@@ -2799,11 +3832,15 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
   // print output stream once for Vivado only
   if (compilerOptions.emitVivado() &&
       vivadoParam == Rewrite::VivadoParam::Entry) {
-    std::string typeStr =
-      createVivadoTypeStr(K->getIterationSpace()->getImage(),
-          compilerOptions.getPixelsPerThread());
-    *OS << "hls::stream<" << typeStr << " > &Output";
-    comma++;
+    std::string typeStr = dataDeps->getOutputTypeStr(K->getKernelName(),
+        K->getIterationSpace()->getImage(),
+        compilerOptions.getPixelsPerThread());
+    size_t numOut = dataDeps->getNumOutputStreams(K->getKernelName());
+    for (size_t i=0; i<numOut; ++i) {
+      if (comma++) *OS << ", ";
+      *OS << "hls::stream<" << typeStr << " > &Output";
+      if (i) *OS << i;
+    }
   }
 
   for (auto param : D->params()) {
@@ -2834,15 +3871,14 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
     // check if we have a Mask or Domain
     HipaccMask *Mask = K->getMaskFromMapping(FD);
     if (Mask) {
+      if (compilerOptions.emitVivado() &&
+          vivadoParam == Rewrite::VivadoParam::KernelDecl) {
+        // Union of all mask/domain regions
+        maskSizeX = max(maskSizeX, Mask->getSizeXStr());
+        maskSizeY = max(maskSizeY, Mask->getSizeYStr());
+        hasMask = true;
+      }
       if (Mask->isConstant()) {
-        if (compilerOptions.emitVivado()) {
-          if (vivadoParam == Rewrite::VivadoParam::KernelDecl) {
-            // Union of all mask/domain regions
-            maskSizeX = max(maskSizeX, Mask->getSizeXStr());
-            maskSizeY = max(maskSizeY, Mask->getSizeYStr());
-            hasMask = true;
-          }
-        }
         continue;
       }
       switch (compilerOptions.getTargetLang()) {
@@ -2869,9 +3905,58 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
         case Language::Filterscript:
           // mask/domain is declared as static memory
           break;
-        case Language::Vivado:
-          assert(Mask->isConstant() && "Only constant mask are allowed for Vivado");
-          break;
+        case Language::Vivado: {
+          // coefficients are passed to the entry function and latched into
+          // registers of the kernel functor once per frame. The copy from the
+          // AXI4-Lite register file takes several cycles and is not atomic:
+          // the host may only write coefficients while the core is idle, in
+          // video mode between the last line of a frame and the start of the
+          // next one, when hipaccReadVideo latches them
+          // (see HostDataDeps::printVideoEntry)
+          std::string extents = "[" + Mask->getSizeYStr() + "][" +
+                                Mask->getSizeXStr() + "]";
+          switch (vivadoParam) {
+            case Rewrite::VivadoParam::Member:
+              *OS << "  " << Mask->getTypeStr() << " " << Name << extents
+                  << ";\n";
+              break;
+            case Rewrite::VivadoParam::CTorHead:
+              if (comma++) *OS << ", ";
+              *OS << "const " << Mask->getTypeStr() << " " << Name << "_in"
+                  << extents;
+              break;
+            case Rewrite::VivadoParam::CTorBody:
+              *OS << "#pragma HLS array_partition variable=" << Name
+                  << " complete dim=0\n"
+                  << "    for (int y = 0; y < " << Mask->getSizeYStr()
+                  << "; ++y) {\n"
+                  << "      for (int x = 0; x < " << Mask->getSizeXStr()
+                  << "; ++x) {\n"
+                  << "#pragma HLS pipeline\n"
+                  << "        " << Name << "[y][x] = " << Name
+                  << "_in[y][x];\n"
+                  << "      }\n"
+                  << "    }\n";
+              break;
+            case Rewrite::VivadoParam::KernelInit:
+              if (comma++) *OS << ", ";
+              else *OS << "(";
+              *OS << Name;
+              break;
+            case Rewrite::VivadoParam::Entry:
+              entryArguments[K->getKernelName()].push_back(
+                std::pair<std::string,std::string>("const " +
+                  Mask->getTypeStr() + " " + extents,
+                  Mask->getHostMemName()));
+              if (comma++) *OS << ", ";
+              *OS << "const " << Mask->getTypeStr() << " " << Name << extents;
+              break;
+            default:
+              /* nothing to do */
+              break;
+          }
+        }
+        break;
       }
       continue;
     }
@@ -2933,23 +4018,24 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
               case Rewrite::VivadoParam::KernelDecl:
                 accs.push_back( {
                     Name,
-                    (compilerOptions.getPixelsPerThread() > 1 || true /*vector type*/ ?
+                    (compilerOptions.getPixelsPerThread() > 1 ||
+                     isa<VectorType>(Acc->getImage()->getType()
+                       .getCanonicalType().getTypePtr()) ?
                       Acc->getImage()->getTypeStr() :
-                      createVivadoTypeStr(Acc->getImage(), 1))
+                      dataDeps->getInputTypeStr(K->getKernelName(),
+                        Acc->getName(), Acc->getImage(), 1))
                 } );
               break;
               case Rewrite::VivadoParam::Entry:
                 if (comma++) *OS << ", ";
-                *OS << "hls::stream<" << createVivadoTypeStr(Acc->getImage(),
+                *OS << "hls::stream<" << dataDeps->getInputTypeStr(
+                    K->getKernelName(), Acc->getName(), Acc->getImage(),
                     compilerOptions.getPixelsPerThread()) << " > &"
                     << Name;
               break;
               case Rewrite::VivadoParam::KernelCall:
                 if (comma++) *OS << ", ";
                 *OS << Name;
-                assert((vivadoBM == Boundary::UNDEFINED || vivadoBM == Acc->getBoundaryMode()) &&
-                  "All Accessors must use same BoundaryMode for Vivado");
-                vivadoBM = Acc->getBoundaryMode();
               break;
               default:
                 /* nothing to do */
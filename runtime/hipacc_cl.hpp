@@ -995,6 +995,81 @@ T hipaccApplyReduction(cl_kernel kernel2D, cl_kernel kernel1D, HipaccImage &img,
 }
 
 
+// Compute histogram of an image (region) using sub-histograms in local memory
+// and return the bins
+std::vector<unsigned int> hipaccApplyBinning(cl_kernel kernel2D, cl_kernel
+        kernel1D, HipaccAccessor &acc, unsigned int num_bins, unsigned int
+        max_threads, unsigned int pixels_per_thread) {
+    HipaccContext &Ctx = HipaccContext::getInstance();
+    cl_mem_flags flags = CL_MEM_READ_WRITE;
+    cl_int err = CL_SUCCESS;
+    cl_mem hists;   // GPU memory for sub-histograms
+    cl_mem output;  // GPU memory for histogram
+    std::vector<unsigned int> bins(num_bins);   // host result
+
+    // first step: one sub-histogram per work-group of pixels_per_thread rows
+    size_t local_work_size[2];
+    local_work_size[0] = max_threads;
+    local_work_size[1] = 1;
+    size_t global_work_size[2];
+    unsigned int num_hists = (acc.height + pixels_per_thread - 1) / pixels_per_thread;
+    global_work_size[0] = num_hists*local_work_size[0];
+    global_work_size[1] = 1;
+
+    hists = clCreateBuffer(Ctx.get_contexts()[0], flags, sizeof(unsigned int)*num_hists*num_bins, NULL, &err);
+    checkErr(err, "clCreateBuffer()");
+    output = clCreateBuffer(Ctx.get_contexts()[0], flags, sizeof(unsigned int)*num_bins, NULL, &err);
+    checkErr(err, "clCreateBuffer()");
+
+    unsigned int offset_x = acc.offset_x;
+    unsigned int offset_y = acc.offset_y;
+    unsigned int is_width = acc.width;
+    unsigned int is_height = acc.height;
+    hipaccSetKernelArg(kernel2D, 0, sizeof(cl_mem), &acc.img.mem);
+    hipaccSetKernelArg(kernel2D, 1, sizeof(cl_mem), &hists);
+    hipaccSetKernelArg(kernel2D, 2, sizeof(unsigned int), &acc.img.stride);
+    hipaccSetKernelArg(kernel2D, 3, sizeof(unsigned int), &offset_x);
+    hipaccSetKernelArg(kernel2D, 4, sizeof(unsigned int), &offset_y);
+    hipaccSetKernelArg(kernel2D, 5, sizeof(unsigned int), &is_width);
+    hipaccSetKernelArg(kernel2D, 6, sizeof(unsigned int), &is_height);
+    hipaccSetKernelArg(kernel2D, 7, sizeof(unsigned int), &num_bins);
+    hipaccSetKernelArg(kernel2D, 8, sizeof(unsigned int), &pixels_per_thread);
+    hipaccSetKernelArg(kernel2D, 9, sizeof(unsigned int)*num_bins, (void *)NULL);
+
+    hipaccEnqueueKernel(kernel2D, global_work_size, local_work_size);
+
+
+    // second step: sum up sub-histograms on GPU, one thread per bin
+    global_work_size[0] = (int)ceilf((float)(num_bins)/local_work_size[0])*local_work_size[0];
+
+    hipaccSetKernelArg(kernel1D, 0, sizeof(cl_mem), &hists);
+    hipaccSetKernelArg(kernel1D, 1, sizeof(cl_mem), &output);
+    hipaccSetKernelArg(kernel1D, 2, sizeof(unsigned int), &num_hists);
+    hipaccSetKernelArg(kernel1D, 3, sizeof(unsigned int), &num_bins);
+
+    hipaccEnqueueKernel(kernel1D, global_work_size, local_work_size);
+
+    // get histogram
+    err = clEnqueueReadBuffer(Ctx.get_command_queues()[0], output, CL_FALSE, 0, sizeof(unsigned int)*num_bins, bins.data(), 0, NULL, NULL);
+    err |= clFinish(Ctx.get_command_queues()[0]);
+    checkErr(err, "clEnqueueReadBuffer()");
+
+    err = clReleaseMemObject(hists);
+    err |= clReleaseMemObject(output);
+    checkErr(err, "clReleaseMemObject()");
+
+    return bins;
+}
+// Compute histogram of an image and return the bins
+std::vector<unsigned int> hipaccApplyBinning(cl_kernel kernel2D, cl_kernel
+        kernel1D, HipaccImage &img, unsigned int num_bins, unsigned int
+        max_threads, unsigned int pixels_per_thread) {
+    HipaccAccessor acc(img);
+    return hipaccApplyBinning(kernel2D, kernel1D, acc, num_bins, max_threads,
+            pixels_per_thread);
+}
+
+
 // Perform exploration of global reduction and return result
 template<typename T>
 T hipaccApplyReductionExploration(std::string filename, std::string kernel2D,
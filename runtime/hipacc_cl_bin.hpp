@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//#ifndef __HIPACC_CL_BIN_HPP__
+//#define __HIPACC_CL_BIN_HPP__
+
+#ifdef USE_ARRAY_2D
+#define BIN_READ(INPUT, X, Y, STRIDE, METHOD) METHOD(INPUT, bin_sampler, (int2)(X, Y)).x
+#define BIN_INPUT_PARM(DATA_TYPE, INPUT_NAME) __read_only image2d_t INPUT_NAME
+#else
+#define BIN_READ(INPUT, X, Y, STRIDE, METHOD) INPUT[(X) + (Y)*STRIDE]
+#define BIN_INPUT_PARM(DATA_TYPE, INPUT_NAME) __global DATA_TYPE *INPUT_NAME
+#endif
+
+
+// step 1:
+// each work-group bins ppt rows of the image (region) into a sub-histogram in
+// local memory and stores the sub-histogram to linear memory
+__constant sampler_t bin_sampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_NONE | CLK_FILTER_NEAREST;
+#define BINNING_CL_2D(NAME, DATA_TYPE, BINNING, IMG_ACC) \
+__kernel void NAME( \
+        BIN_INPUT_PARM(DATA_TYPE, input), __global uint *output, \
+        const unsigned int stride, const unsigned int offset_x, \
+        const unsigned int offset_y, const unsigned int is_width, \
+        const unsigned int is_height, const unsigned int num_bins, \
+        const unsigned int ppt, __local uint *sbins) { \
+    const unsigned int gid_y = ppt * get_group_id(0); \
+    const unsigned int tid = get_local_id(0); \
+ \
+    for (unsigned int i=tid; i < num_bins; i += get_local_size(0)) { \
+        sbins[i] = 0; \
+    } \
+ \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+ \
+    for (unsigned int y=gid_y; y < gid_y + ppt && y < is_height; ++y) { \
+        for (unsigned int x=tid; x < is_width; x += get_local_size(0)) { \
+            uint bin = BINNING(BIN_READ(input, x + offset_x, y + offset_y, stride, IMG_ACC), num_bins); \
+            if (bin < num_bins) { \
+                atomic_inc(&sbins[bin]); \
+            } \
+        } \
+    } \
+ \
+    barrier(CLK_LOCAL_MEM_FENCE); \
+ \
+    for (unsigned int i=tid; i < num_bins; i += get_local_size(0)) { \
+        output[get_group_id(0)*num_bins + i] = sbins[i]; \
+    } \
+}
+
+
+// step 2:
+// sum up the sub-histograms, one bin per thread
+#define BINNING_CL_1D(NAME) \
+__kernel void NAME(__global const uint *input, __global uint *output, \
+        const unsigned int num_hists, const unsigned int num_bins) { \
+    const unsigned int bin = get_global_id(0); \
+ \
+    if (bin < num_bins) { \
+        uint sum = 0; \
+        for (unsigned int i=0; i < num_hists; ++i) { \
+            sum += input[i*num_bins + bin]; \
+        } \
+        output[bin] = sum; \
+    } \
+}
+
+//#endif  // __HIPACC_CL_BIN_HPP__
+
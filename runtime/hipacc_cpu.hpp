@@ -33,6 +33,7 @@
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "hipacc_base.hpp"
 
@@ -174,5 +175,51 @@ void hipaccCopyMemoryRegion(const HipaccAccessor &src, const HipaccAccessor &dst
     }
 }
 
+
+// Compute histogram of an image (region) using private bins per thread and
+// return the bins
+template<typename T, typename Binning>
+std::vector<unsigned int> hipaccApplyBinning(Binning binning, HipaccAccessor
+        &acc, unsigned int num_bins) {
+    size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::max((size_t)1, std::min(num_threads, acc.height));
+    size_t rows = (acc.height + num_threads - 1) / num_threads;
+    std::vector<std::vector<unsigned int> > hists(num_threads,
+            std::vector<unsigned int>(num_bins, 0));
+    std::vector<std::thread> threads;
+
+    for (size_t t=0; t<num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            std::vector<unsigned int> &hist = hists[t];
+            T *mem = (T*)acc.img.mem;
+            for (size_t y=t*rows; y<std::min(acc.height, (t+1)*rows); ++y) {
+                T *row = &mem[(y + acc.offset_y)*acc.img.stride + acc.offset_x];
+                for (size_t x=0; x<acc.width; ++x) {
+                    unsigned int bin = binning(row[x], num_bins);
+                    if (bin < num_bins) ++hist[bin];
+                }
+            }
+        }));
+    }
+
+    // merge private bins
+    std::vector<unsigned int> bins(num_bins, 0);
+    for (size_t t=0; t<num_threads; ++t) {
+        threads[t].join();
+        for (size_t i=0; i<num_bins; ++i) {
+            bins[i] += hists[t][i];
+        }
+    }
+
+    return bins;
+}
+// Compute histogram of an image and return the bins
+template<typename T, typename Binning>
+std::vector<unsigned int> hipaccApplyBinning(Binning binning, HipaccImage &img,
+        unsigned int num_bins) {
+    HipaccAccessor acc(img);
+    return hipaccApplyBinning<T>(binning, acc, num_bins);
+}
+
 #endif  // __HIPACC_CPU_HPP__
 
@@ -40,3 +40,8 @@
 #undef USE_OFFSETS
 #undef USE_ARRAY_2D
 
+// undef macros defined for histograms
+#undef BINNING_CL_2D
+#undef BINNING_CL_1D
+#undef BIN_READ
+#undef BIN_INPUT_PARM
@@ -28,10 +28,14 @@
 
 #include <string.h>
 #include <iostream>
+#include <vector>
 
 #include <hls_stream.h>
 #include <ap_int.h>
 
+// defined before the packed vector types of hipacc_base.hpp, so that the
+// layout matches the one seen by hipaccRun
+#include "hipacc_vivado_video.hpp"
 #include "hipacc_base.hpp"
 
 class HipaccContext : public HipaccContextBase {
@@ -71,6 +75,14 @@ HipaccImage hipaccCreateMemory(T *host_mem, int width, int height) {
 }
 
 
+// Create image to store size information of a pyramid level, its pixels are
+// only streamed within hipaccRun
+template<typename T>
+HipaccImage hipaccCreatePyramidImage(HipaccImage &/*base*/, size_t width, size_t height) {
+    return hipaccCreateMemory<T>((T *)NULL, width, height);
+}
+
+
 // Release image
 void hipaccReleaseMemory(HipaccImage &img) {
     HipaccContext &Ctx = HipaccContext::getInstance();
@@ -121,33 +133,108 @@ void hipaccReadMemory(hls::stream<T1> &s, T2 *host_mem, HipaccImage &img) {
 }
 
 
+// Bulk packing of frames into words of BW bits holding VECT pixels of type T2,
+// e.g. uint (representing uchar4) in ap_uint<32>. Each lane stores its pixel in
+// reversed bit order, as read by the kernels through reversed ranges. Lanes
+// are combined in 64 bit chunks, so that each word is assigned with one range
+// per chunk, and only the last word of a row is padded.
+template<int BW, typename T2>
+struct HipaccPacking {
+    enum { VECT = BW/8/sizeof(T2), LANE = BW/VECT,
+           CHUNK = BW < 64 ? BW : 64, LANES = CHUNK/LANE };
+
+    static uint64_t reverse(uint64_t val) {
+        val = ((val >> 1) & 0x5555555555555555ULL) | ((val & 0x5555555555555555ULL) << 1);
+        val = ((val >> 2) & 0x3333333333333333ULL) | ((val & 0x3333333333333333ULL) << 2);
+        val = ((val >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((val & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        val = ((val >> 8) & 0x00FF00FF00FF00FFULL) | ((val & 0x00FF00FF00FF00FFULL) << 8);
+        val = ((val >> 16) & 0x0000FFFF0000FFFFULL) | ((val & 0x0000FFFF0000FFFFULL) << 16);
+        val = (val >> 32) | (val << 32);
+        return val >> (64 - LANE);
+    }
+
+    // pixels are transferred by their bit pattern, floats as read by i2f()
+    static uint64_t pack(T2 pixel) {
+        uint64_t bits = 0;
+        memcpy(&bits, &pixel, sizeof(T2));
+        return reverse(bits);
+    }
+
+    static T2 unpack(uint64_t bits) {
+        T2 pixel;
+        bits = reverse(bits);
+        memcpy(&pixel, &bits, sizeof(T2));
+        return pixel;
+    }
+
+    static size_t rowWords(size_t width) { return (width + VECT - 1) / VECT; }
+
+    // pack one row of width pixels into rowWords(width) words
+    static void packRow(ap_uint<BW> *words, const T2 *row, size_t width) {
+        for (size_t x=0, w=0; x<width; x+=VECT, ++w) {
+            size_t lanes = width - x < VECT ? width - x : VECT;
+            ap_uint<BW> data = 0;
+            for (size_t c=0; c*LANES<lanes; ++c) {
+                uint64_t chunk = 0;
+                for (size_t l=0; l<LANES && c*LANES+l<lanes; ++l) {
+                    chunk |= pack(row[x + c*LANES + l]) << (l*LANE);
+                }
+                data.range(c*CHUNK + CHUNK-1, c*CHUNK) = chunk;
+            }
+            words[w] = data;
+        }
+    }
+
+    static void unpackRow(T2 *row, const ap_uint<BW> *words, size_t width) {
+        const uint64_t mask = LANE < 64 ? (1ULL << LANE) - 1 : ~0ULL;
+        for (size_t x=0, w=0; x<width; x+=VECT, ++w) {
+            size_t lanes = width - x < VECT ? width - x : VECT;
+            for (size_t c=0; c*LANES<lanes; ++c) {
+                uint64_t chunk = words[w].range(c*CHUNK + CHUNK-1, c*CHUNK);
+                for (size_t l=0; l<LANES && c*LANES+l<lanes; ++l) {
+                    row[x + c*LANES + l] = unpack((chunk >> (l*LANE)) & mask);
+                }
+            }
+        }
+    }
+};
+
+
+// Pack frame into a caller-provided buffer of height rows of packed words
+template<int BW, typename T2>
+size_t hipaccPackMemory(HipaccImage &img, ap_uint<BW> *words, const T2 *host_mem) {
+    typedef HipaccPacking<BW, T2> Packing;
+    size_t row_words = Packing::rowWords(img.width);
+    for (size_t y=0; y<img.height; ++y) {
+        Packing::packRow(words + y*row_words, host_mem + y*img.width, img.width);
+    }
+    return img.height * row_words;
+}
+
+
+// Unpack frame from a caller-provided buffer of height rows of packed words
+template<int BW, typename T2>
+void hipaccUnpackMemory(HipaccImage &img, T2 *host_mem, const ap_uint<BW> *words) {
+    typedef HipaccPacking<BW, T2> Packing;
+    size_t row_words = Packing::rowWords(img.width);
+    for (size_t y=0; y<img.height; ++y) {
+        Packing::unpackRow(host_mem + y*img.width, words + y*row_words, img.width);
+    }
+}
+
+
 // Write to stream
 // T1 is ap_uint<32>
 // T2 is uint (representing uchar4)
 template<int BW, typename T2>
 void hipaccWriteMemory(HipaccImage &img, hls::stream<ap_uint<BW> > &s, T2 *host_mem) {
-    int width = img.width;
-    int height = img.height;
-    int vect = BW/8/sizeof(T2);
-
-    for (size_t y=0; y<height; ++y) {
-        for (size_t x=0; x<width; x+=vect) {
-            size_t i = (y*width)+x;
-            ap_uint<BW> data;
-            if (vect > 1) {
-                for (size_t v=0; v<vect; ++v) {
-                    if (x+v >= width) {
-                        // padding
-                        data(v*BW/vect, ((v+1)*BW/vect)-1) = (T2)0;
-                    } else {
-                        data(v*BW/vect, ((v+1)*BW/vect)-1) = host_mem[i+v];
-                    }
-                }
-                s << data;
-            } else {
-                data = host_mem[i];
-                s << hipaccReverseBits<ap_uint<BW> >(data);
-            }
+    typedef HipaccPacking<BW, T2> Packing;
+    std::vector<ap_uint<BW> > row(Packing::rowWords(img.width));
+
+    for (size_t y=0; y<img.height; ++y) {
+        Packing::packRow(row.data(), host_mem + y*img.width, img.width);
+        for (size_t w=0; w<row.size(); ++w) {
+            s << row[w];
         }
     }
 }
@@ -158,28 +245,104 @@ void hipaccWriteMemory(HipaccImage &img, hls::stream<ap_uint<BW> > &s, T2 *host_
 // T2 is uint (representing uchar4)
 template<int BW, typename T2>
 void hipaccReadMemory(hls::stream<ap_uint<BW> > &s, T2 *host_mem, HipaccImage &img) {
-    int width = img.width;
-    int height = img.height;
-    int vect = BW/8/sizeof(T2);
-
-    for (size_t y=0; y<height; ++y) {
-        for (size_t x=0; x<width; x+=vect) {
-            size_t i = (y*width)+x;
-            ap_uint<BW> data;
-            s >> data;
-            if (vect > 1) {
-                ap_uint<BW> temp = data;
-                for (size_t v=0; v<vect; ++v) {
-                    if (x+v < width) {
-                        host_mem[i+v] = temp(v*BW/vect, ((v+1)*BW/vect)-1);
-                    }
-                }
-            } else {
-                ap_uint<BW> temp = hipaccReverseBits<ap_uint<BW> >(data);
-                host_mem[i] = *(T2*)&temp;
-            }
+    typedef HipaccPacking<BW, T2> Packing;
+    std::vector<ap_uint<BW> > row(Packing::rowWords(img.width));
+
+    for (size_t y=0; y<img.height; ++y) {
+        for (size_t w=0; w<row.size(); ++w) {
+            s >> row[w];
+        }
+        Packing::unpackRow(host_mem + y*img.width, row.data(), img.width);
+    }
+}
+
+
+// Frame buffer in host memory, C model of an m_axi port: the frame is stored
+// line by line in words of VECT pixels as transferred by the memory ports of
+// hipaccRun
+template<typename T, int VECT>
+class HipaccMemoryPort {
+    private:
+        std::vector<T> data_;
+
+    public:
+        HipaccMemoryPort(HipaccImage &img) :
+            data_(img.height * ((img.width + VECT - 1) / VECT)) {}
+
+        T *data() { return data_.data(); }
+        size_t size() const { return data_.size(); }
+};
+
+
+// Write to memory port
+template<typename T1, int VECT, typename T2>
+void hipaccWriteMemory(HipaccImage &img, HipaccMemoryPort<T1, VECT> &port, T2 *host_mem) {
+    hls::stream<T1> s;
+    hipaccWriteMemory(img, s, host_mem);
+    for (size_t i=0; i<port.size(); ++i) {
+        s >> port.data()[i];
+    }
+}
+
+
+// Read from memory port
+template<typename T1, int VECT, typename T2>
+void hipaccReadMemory(HipaccMemoryPort<T1, VECT> &port, T2 *host_mem, HipaccImage &img) {
+    hls::stream<T1> s;
+    for (size_t i=0; i<port.size(); ++i) {
+        s << port.data()[i];
+    }
+    hipaccReadMemory(s, host_mem, img);
+}
+
+
+// Write to memory port, packing directly into the frame buffer
+template<int BW, int VECT, typename T2>
+void hipaccWriteMemory(HipaccImage &img, HipaccMemoryPort<ap_uint<BW>, VECT> &port, T2 *host_mem) {
+    hipaccPackMemory(img, port.data(), host_mem);
+}
+
+
+// Read from memory port, unpacking directly from the frame buffer
+template<int BW, int VECT, typename T2>
+void hipaccReadMemory(HipaccMemoryPort<ap_uint<BW>, VECT> &port, T2 *host_mem, HipaccImage &img) {
+    hipaccUnpackMemory(img, host_mem, port.data());
+}
+
+
+// Write frame to video stream, marking the frame start and line ends
+template<typename T1, typename T2>
+void hipaccWriteMemory(HipaccImage &img, hls::stream<HipaccVideo<T1> > &s, T2 *host_mem) {
+    hls::stream<T1> frame;
+    hipaccWriteMemory(img, frame, host_mem);
+    size_t words = frame.size() / img.height;
+    for (size_t y=0; y<img.height; ++y) {
+        for (size_t x=0; x<words; ++x) {
+            HipaccVideo<T1> data;
+            frame >> data.data;
+            data.user = (x == 0 && y == 0);
+            data.last = (x == words - 1);
+            s << data;
+        }
+    }
+}
+
+
+// Read frame from video stream
+template<typename T1, typename T2>
+void hipaccReadMemory(hls::stream<HipaccVideo<T1> > &s, T2 *host_mem, HipaccImage &img) {
+    hls::stream<T1> frame;
+    for (size_t y=0, x=0; y<img.height; ++x) {
+        HipaccVideo<T1> data;
+        s >> data;
+        assert((data.user == 1) == (x == 0 && y == 0) && "Video stream out of sync");
+        frame << data.data;
+        if (data.last) {
+            x = -1;
+            ++y;
         }
     }
+    hipaccReadMemory(frame, host_mem, img);
 }
 
 
@@ -18,9 +18,33 @@
 #include <hls_stream.h>
 #include <assert.h>
 #include <typeinfo>
+#include <limits>
+#include <type_traits>
 #include <iostream>
+#include "hipacc_vivado_video.hpp"
 #define ASSERTION_CHECK
 
+// dataflow region markers of generated code, expanded to threads by the
+// simulation headers in vivado_sim and to plain calls for synthesis
+#ifndef HIPACC_PROCESS
+#define HIPACC_DATAFLOW_BEGIN
+#define HIPACC_PROCESS(...) __VA_ARGS__
+#define HIPACC_DATAFLOW_END
+#define HIPACC_STREAM_DEPTH(s, d) PRAGMA_HLS(HLS stream variable=s depth=d)
+#endif
+
+// number of partial results of streaming reductions, covers the latency of
+// floating point operations at high clock frequencies
+#ifndef HIPACC_REDUCE_LATENCY
+#define HIPACC_REDUCE_LATENCY 8
+#endif
+
+// number of BRAM banks of streaming histograms, covers the read-modify-write
+// latency of the bins
+#ifndef HIPACC_BINNING_BANKS
+#define HIPACC_BINNING_BANKS 2
+#endif
+
 #define RADIUS (KERNEL_SIZE/2)
 #define GROUP_DELAY RADIUS 
 #define SWIN_Y KERNEL_SIZE
@@ -66,15 +90,30 @@ public:
     	BORDER_CONST,
     	BORDER_CLAMP,
     	BORDER_MIRROR,
-    	BORDER_MIRROR_101
+    	BORDER_MIRROR_101,
+    	BORDER_REPEAT,
+    	BORDER_UNDEFINED
     };
 
     typedef void isBorderMode;
 };
 
-int getNewCoords(int i, int kernel, int offset, int col, int width, const enum BorderPadding::values borderPadding)
+// value of pixels outside the image for BORDER_CONST
+#ifndef BORDER_FILL_VALUE
+#define BORDER_FILL_VALUE 0
+#endif
+
+// The border mode is a template parameter, so that only the remapping logic
+// of the selected mode is generated. Window positions outside the image are
+// mapped to -1 for BORDER_CONST. BORDER_REPEAT would require pixels from the
+// opposite border, which have not been streamed yet, and is not supported.
+template<BorderPadding::values BORDER_PADDING>
+int getNewCoords(int i, int kernel, int offset, int col, int width)
 {
 #pragma HLS INLINE
+  if (BORDER_PADDING == BorderPadding::BORDER_UNDEFINED)
+    return i;
+
   if(col >= offset && col < kernel-1){
     int border = kernel-1 - col;
     if(i >= border)
@@ -83,7 +122,7 @@ int getNewCoords(int i, int kernel, int offset, int col, int width, const enum B
       // where is the border of the image in the window?
       // what is the current distance to the border
       int d2b = border - i;
-      switch (borderPadding){
+      switch (BORDER_PADDING){
         case BorderPadding::BORDER_CLAMP:
           return border;
         case BorderPadding::BORDER_MIRROR:
@@ -108,7 +147,7 @@ int getNewCoords(int i, int kernel, int offset, int col, int width, const enum B
     {
       // what is the distance to the border?
       int d2b = i - border;  
-      switch (borderPadding){
+      switch (BORDER_PADDING){
         case BorderPadding::BORDER_CLAMP:
           return border;
         case BorderPadding::BORDER_MIRROR:
@@ -126,6 +165,44 @@ int getNewCoords(int i, int kernel, int offset, int col, int width, const enum B
     return i;
 }
 
+int getNewCoords(int i, int kernel, int offset, int col, int width, const enum BorderPadding::values borderPadding)
+{
+#pragma HLS INLINE
+  switch (borderPadding){
+    case BorderPadding::BORDER_CLAMP:
+      return getNewCoords<BorderPadding::BORDER_CLAMP>(i, kernel, offset, col, width);
+    case BorderPadding::BORDER_MIRROR:
+      return getNewCoords<BorderPadding::BORDER_MIRROR>(i, kernel, offset, col, width);
+    case BorderPadding::BORDER_MIRROR_101:
+      return getNewCoords<BorderPadding::BORDER_MIRROR_101>(i, kernel, offset, col, width);
+    case BorderPadding::BORDER_UNDEFINED:
+      return getNewCoords<BorderPadding::BORDER_UNDEFINED>(i, kernel, offset, col, width);
+    case BorderPadding::BORDER_CONST:
+      default:
+      return getNewCoords<BorderPadding::BORDER_CONST>(i, kernel, offset, col, width);
+  }
+}
+
+// window element after border handling with an explicit fill value, e.g. for
+// windows of intermediate results
+template<BorderPadding::values BORDER_PADDING, typename T>
+T getBorderPixel(const T *line, int pos, const T &fill)
+{
+#pragma HLS INLINE
+  if (BORDER_PADDING == BorderPadding::BORDER_CONST && pos < 0)
+    return fill;
+  return line[pos];
+}
+
+// window element after border handling, positions outside the image are
+// replaced by the fill value for BORDER_CONST
+template<BorderPadding::values BORDER_PADDING, typename T>
+T getBorderPixel(const T *line, int pos)
+{
+#pragma HLS INLINE
+  return getBorderPixel<BORDER_PADDING>(line, pos, (T)BORDER_FILL_VALUE);
+}
+
 #endif
 
 // conversion function for floats stored in integers
@@ -150,6 +227,81 @@ int f2i(float arg)
   return single_cast.i;
 }
 
+//*********************************************************************************************************************
+// LINE BUFFER
+//*********************************************************************************************************************
+// Narrow integer pixels are packed into wide memory words so that the line
+// buffer fills the BRAM word width (36 bit). Packing is only used as long as a
+// line still has at least 512 words, i.e. the depth of a BRAM in 36 bit mode.
+template<typename IN, int MAX_WIDTH>
+struct LineBufferPack {
+  enum {
+    BW    = sizeof(IN)*8,
+    WORD  = (std::numeric_limits<IN>::is_integer && BW < 32) ? 32/BW : 1,
+    value = (WORD >= 4 && MAX_WIDTH >= 4*512) ? 4 :
+            (WORD >= 2 && MAX_WIDTH >= 2*512) ? 2 : 1
+  };
+};
+
+// ROWS lines of MAX_WIDTH pixels stored in packed words
+template<int ROWS, int MAX_WIDTH, typename IN, int PACK = LineBufferPack<IN,MAX_WIDTH>::value>
+struct LineBuffer {
+  enum {
+    BW    = sizeof(IN)*8,
+    WORDS = (MAX_WIDTH+PACK-1)/PACK
+  };
+  typedef ap_uint<BW*PACK> word_t;
+
+  // Returns the pixels of all lines at column col and shifts the lines up by
+  // one, appending in_pixel to the last line. A word is read from memory only
+  // when entering a new group of PACK pixels and then kept in curWord.
+  static void shift(word_t buff[ROWS][WORDS], word_t curWord[ROWS],
+      const int col, const IN in_pixel, IN col_pixels[ROWS])
+  {
+  #pragma HLS INLINE
+    const int w = col / PACK;
+    const int p = col % PACK;
+
+    for (int i = 0; i < ROWS; i++) {
+    #pragma HLS unroll
+      if (p == 0) {
+        curWord[i] = buff[i][w];
+      }
+      col_pixels[i] = (IN)curWord[i].range((p+1)*BW-1, p*BW);
+    }
+    // pixel p of the current word has been read and is replaced right away
+    for (int i = 0; i < ROWS; i++) {
+    #pragma HLS unroll
+      curWord[i].range((p+1)*BW-1, p*BW) = (i < ROWS-1) ?
+        (ap_uint<BW>)col_pixels[i+1] : (ap_uint<BW>)in_pixel;
+      buff[i][w] = curWord[i];
+    }
+  }
+};
+
+// one pixel per entry
+template<int ROWS, int MAX_WIDTH, typename IN>
+struct LineBuffer<ROWS, MAX_WIDTH, IN, 1> {
+  enum {
+    WORDS = MAX_WIDTH
+  };
+  typedef IN word_t;
+
+  static void shift(word_t buff[ROWS][WORDS], word_t curWord[ROWS],
+      const int col, const IN in_pixel, IN col_pixels[ROWS])
+  {
+  #pragma HLS INLINE
+    for (int i = 0; i < ROWS; i++) {
+    #pragma HLS unroll
+      col_pixels[i] = buff[i][col];
+      if (i > 0) {
+        buff[i-1][col] = col_pixels[i];
+      }
+    }
+    buff[ROWS-1][col] = in_pixel;
+  }
+};
+
 //*********************************************************************************************************************
 // LOCAL OPERATORS OLP 
 //*********************************************************************************************************************
@@ -1430,130 +1582,135 @@ void collect16(
 
 
 //*********************************************************************************************************************
-// LOCAL OPERATORS VECTOR
+// POINT VECTOR OPERATORS
+// currently only supports factor 2
 //*********************************************************************************************************************
-struct winPos
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
+void processPixelsVECT(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
 {
-  int win;
-  int pos;
-};
-typedef struct winPos winPos;
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-winPos getWinCoords(int i, int kernel_x, int kernel, int vect, int offset, int col, int width, const enum BorderPadding::values borderPadding)
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
+      const IN val = in_s.read();
+      INT_I temp_i[VECT];
+      INT_O temp_o[VECT]; 
+      OUT out_val;
+      for(int i = 0; i < VECT; i++){
+        #pragma HLS unroll
+        temp_i[i] = val(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp_o[i] = filter(temp_i[i]);
+        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
+      }
+      out_s << out_val;
+    }
+}
+// 2:1
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
+void processPixels2VECT(
+    hls::stream<IN> &in1_s,
+    hls::stream<IN> &in2_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
 {
-#pragma HLS INLINE
-  winPos temp;
-  
-  int win = i/vect;
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-  // this will exhibit problems
-  if(col >= offset && col < kernel-1){
-    int borderWin = kernel_x-1 - col;
-    if(win >= borderWin){
-      //we are fine
-      temp.win = win;
-      temp.pos = i%vect;
-    // else
-    }else{
-      int border = borderWin*vect;
-      int d2b = border-i;
-      int pos = 0;
-      switch (borderPadding){
-        case BorderPadding::BORDER_CLAMP:
-          temp.pos = border%vect;
-          break;
-        case BorderPadding::BORDER_MIRROR:
-          temp.pos = (border + d2b - 1)%vect;
-          break;
-        case BorderPadding::BORDER_MIRROR_101:
-          temp.pos = (border+d2b)%vect;
-          break;
-        case BorderPadding::BORDER_CONST:
-          temp.pos = 0;
-          break;
-          default:
-          temp.pos = 0;
-          break;
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
+      const IN val1 = in1_s.read();
+      const IN val2 = in2_s.read();
+      INT_I temp1_i[VECT];
+      INT_I temp2_i[VECT];
+      INT_O temp_o[VECT]; 
+      OUT out_val;
+      for(int i = 0; i < VECT; i++){
+        #pragma HLS unroll
+        temp1_i[i] = val1(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp2_i[i] = val2(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp_o[i] = filter(temp1_i[i], temp2_i[i]);
+        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
       }
-      temp.win = borderWin+d2b/vect;
+      out_s << out_val;
     }
-  }
-  // we are at the right border
-  else if(col >= width){
-    int overlap = col - (width-1);
-    int border = kernel - overlap - 1;
-    // if we are inside the defined region
-    if(win <= border){
-      //we are fine
-      temp.win = win;
-      temp.pos = i%vect;
+}
+// 3:1
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
+void processPixels3VECT(
+    hls::stream<IN> &in1_s,
+    hls::stream<IN> &in2_s,
+    hls::stream<IN> &in3_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
+      const IN val1 = in1_s.read();
+      const IN val2 = in2_s.read();
+      const IN val3 = in3_s.read();
+      INT_I temp1_i[VECT];
+      INT_I temp2_i[VECT];
+      INT_I temp3_i[VECT];
+      INT_O temp_o[VECT]; 
+      OUT out_val;
+      for(int i = 0; i < VECT; i++){
+        #pragma HLS unroll
+        temp1_i[i] = val1(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp2_i[i] = val2(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp3_i[i] = val3(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
+        temp_o[i] = filter(temp1_i[i], temp2_i[i], temp3_i[i]);
+        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
+      }
+      out_s << out_val;
     }
-    else{
-      border = (border+1)*vect-1;
-      int d2b = i - border;
-      switch (borderPadding){
-        case BorderPadding::BORDER_CLAMP:
-          temp.pos = border%vect;
-          break;
-        case BorderPadding::BORDER_MIRROR:
-          temp.pos = (border - d2b + 1)%vect;
-          break;
-        case BorderPadding::BORDER_MIRROR_101:
-          temp.pos = (border - d2b)%vect;
-          break;
-        case BorderPadding::BORDER_CONST:
-          temp.pos = 0;
-          break;
-          default:
-          temp.pos = 0;
-          break;
-      }
-      temp.win = win-1;
-    }    
-  }else{
-    temp.win = win;
-    temp.pos = i%vect;
-  }
-  return temp;
 }
 
 
+
 //*********************************************************************************************************************
-// VECTOR FLOAT 
+//PYRAMID VECTOR OPERATORS 
+// currently only supports factor 2
 //*********************************************************************************************************************
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT2F(
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT>
+void downsampleVECT(
     hls::stream<IN> &in_s, 
     hls::stream<OUT> &out_s,
     const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    const int &height)
 {
-    assert( width <= MAX_WIDTH); assert( height <= MAX_HEIGHT);
-    assert(VECT==2);
-  
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
+  assert( width <= MAX_WIDTH); assert( height <= MAX_HEIGHT);
   
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-
-  IN in_pixel, out_pixel, temp_lb;
+  IN in_pixel, out_pixel; 
 
-  int row, col, i, j;
+  int row, col, i;
 
   IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
+  for(row = 0; row < height+GROUP_DELAY_Y; ++row){
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
     //std::cout << "ROW: " << row << std::endl;
     IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+    for(col = 0; col < width+GROUP_DELAY_X; ++col){
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
       
@@ -1562,268 +1719,104 @@ void processVECT2F(
       //**********************************************************
       if(col < width & row < height){
         in_s >> in_pixel;
-      }
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width && row < height + GROUP_DELAY_Y)
-      {
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win_tmp[i][j] = win_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords(j,KERNEL_SIZE, SWIN_X, VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 = getWinCoords(j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = i2f(win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1));
-           win2[i][j] = i2f(win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1));
-         }
-       }
-     }
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp1 = filter(win1);
-        INT outp2 = filter(win2);
-        out_pixel(0,WIDTH-1) = f2i(outp1);
-        out_pixel(WIDTH,2*WIDTH-1) = f2i(outp2); 
-        out_s << out_pixel; 
+        if(col%2 == 0 && row%2==0){
+          for(i = 0; i < VECT/2; i++)
+            out_pixel(i*WIDTH,(i+1)*WIDTH-1) = in_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1);
+        }else{
+          for(i = 0; i < VECT/2; i++)
+            out_pixel((i+VECT/2)*WIDTH,(i+VECT/2+1)*WIDTH-1) = in_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1);
+          out_s << out_pixel;
+        }
       }
     }
   }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT4F(
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT>
+void upsampleVECT(
     hls::stream<IN> &in_s, 
     hls::stream<OUT> &out_s,
     const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    const int &height)
 {
-
-  // TODO fix this
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==4);
-  
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
+  assert( width <= MAX_WIDTH); assert( height <= MAX_HEIGHT);
   
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
-
-  IN in_pixel, out_pixel, temp_lb;
+  IN in_pixel, out_pixel; 
 
-  int row, col, i, j;
+  int row, col, i;
 
   IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
+  for(row = 0; row < height+GROUP_DELAY_Y; ++row){
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
     //std::cout << "ROW: " << row << std::endl;
     IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+    for(col = 0; col < width+GROUP_DELAY_X; ++col){
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+      
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
       if(col < width & row < height){
-        in_s >> in_pixel;
+        out_pixel = 0;
+        if(col%2 == 0 && row%2==0){
+          in_s >> in_pixel;  
+          for(i = 0; i < VECT/2; i++)
+             out_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1) = in_pixel(i*WIDTH,(i+1)*WIDTH-1);
+        }else{
+          for(i = 0; i < VECT/2; i++)
+             out_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1) = in_pixel((i+VECT/2)*WIDTH,(i+VECT/2+1)*WIDTH-1);
+        }
+        out_s << in_pixel;
       }
-
-     //**********************************************************
-     // UPDATE THE WINDOW
-     // The line buffer behaves normally
-     //**********************************************************
-     if (col < width && row < height + GROUP_DELAY_Y){
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win_tmp[i][j] = win_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords(j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 = getWinCoords(j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 = getWinCoords(j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 = getWinCoords(j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = i2f(win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1));
-           win2[i][j] = i2f(win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1));
-           win3[i][j] = i2f(win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1));
-           win4[i][j] = i2f(win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1));
-         }
-       }
-     }
-     //**********************************************************
-     // DO CALCULATIONS
-     //**********************************************************
-     if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-     {
-       INT outp1 = filter(win1);
-       INT outp2 = filter(win2);
-       INT outp3 = filter(win3);
-       INT outp4 = filter(win4);
-       out_pixel(0,WIDTH-1)         = f2i(outp1);
-       out_pixel(WIDTH,2*WIDTH-1)   = f2i(outp2); 
-       out_pixel(2*WIDTH,3*WIDTH-1) = f2i(outp3); 
-       out_pixel(3*WIDTH,4*WIDTH-1) = f2i(outp4); 
-       out_s << out_pixel; 
-     }
     }
   }
 }
 
 //*********************************************************************************************************************
-// VECTOR INT 
+// LOCAL OPERATORS
 //*********************************************************************************************************************
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT2(
-    hls::stream<IN> &in_s, 
+// normal processing, one input, one output stream
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename IN, typename OUT, class Filter>
+void process(
+    hls::stream<IN> &in_s,
     hls::stream<OUT> &out_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Filter &filter)
 {
   // TODO fix this
-  //#ifdef ASSERTION_CHECK
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==2);
-  //#endif
-  
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
+    assert( (KERNEL_SIZE_X % 2) == 1 );
+    assert( (KERNEL_SIZE_Y % 2) == 1 );
+  #endif
+
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,IN> LB;
+  typename LB::word_t lineBuff[KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
+  typename LB::word_t lineWord[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord complete
+  IN lineCol[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol complete
+  IN win[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
+  IN win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
 
-  IN in_pixel, out_pixel, temp_lb;
-
-  int row, col, i, j;
+  OUT out_pixel;
+  IN in_pixel;
+  int i, j ,row, col;
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  process_main_loop:
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
@@ -1833,280 +1826,222 @@ void processVECT2(
 
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width & row < height + GROUP_DELAY_Y)
-     {
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win_tmp[i][j] = win_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords(j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 = getWinCoords(j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-         }
-       }
-     }
-      //**********************************************************
-      // DO CALCULATIONS
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
-      }
-    }
+      if (col < width + GDELAY_X & row < height + GDELAY_Y){
+        for(i = 0; i < KERNEL_SIZE_Y; i++){
+        #pragma HLS unroll
+          for(j = 0; j < KERNEL_SIZE_X-1; j++){
+            win_tmp[i][j] = win_tmp[i][j+1];
+          }
+        }
+      }
+
+      //**********************************************************
+      // UPDATE THE LINE BUFFER
+      //**********************************************************
+      if (col < width & row < height+GDELAY_Y){
+        if (KERNEL_SIZE_Y > 1) {
+          LB::shift(lineBuff, lineWord, col, in_pixel, lineCol);
+        }
+        LINE_BUFF_1:
+        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
+        #pragma HLS unroll
+          win_tmp[i][KERNEL_SIZE_X-1] = lineCol[i];
+        }
+        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel;
+      }
+
+      //**********************************************************
+      // HANDLE BORDERS 
+      //**********************************************************
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+          win[i][j] = getBorderPixel<BORDER_PADDING>(win_tmp[i], jx);
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+          win[i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+            (IN)BORDER_FILL_VALUE : win[ix][j];
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
+      //**********************************************************
+      // Do the filtering
+      if (row >= GDELAY_Y && col >= GDELAY_X){
+        out_pixel = filter(win);
+        out_s.write(out_pixel);
+      }
+    }
   }
 }
-  
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT3(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+
+// process one input stream, put result into two output streams
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename IN, typename OUT, class Filter>
+void processSIMO(
+                 hls::stream<IN> &in_s,
+                 hls::stream<OUT> &out1_s,
+                 hls::stream<OUT> &out2_s,
+                 const int &width,
+                 const int &height,
+                 Filter &filter)
 {
-  // TODO fix this
-  #ifdef ASSERTION_CHECK
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==3);
-  #endif
+#ifdef ASSERTION_CHECK
+  assert( width <= MAX_WIDTH ); assert(height <= MAX_HEIGHT);
+  assert( (KERNEL_SIZE_X % 2) == 1 );
+  assert( (KERNEL_SIZE_Y % 2) == 1 );
+#endif
   
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,IN> LB;
+  typename LB::word_t lineBuff[KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
+  typename LB::word_t lineWord[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord complete
+  IN lineCol[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol complete
+  IN win[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
+  IN win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
   
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-
-  IN in_pixel, out_pixel, temp_lb;
-
-  int row, col, i, j;
-
-  IMG_ROWS:
-  for(row = 0; row < height+GROUP_DELAY_Y; row++){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < width+GROUP_DELAY_X; col++){
+  OUT out_pixel;
+  IN in_pixel;
+  int i, j ,row, col;
+  
+  ROW_LOOP:
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    COL_LOOP:
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+    
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
-      if(col < width && row < height){
+      if(col < width & row < height){
         in_s >> in_pixel;
       }
-
+      
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
       //**********************************************************
-      if (col < width && row < height + GROUP_DELAY_Y)
-     {
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win_tmp[i][j] = win_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords(j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 = getWinCoords(j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 = getWinCoords(j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-         }
-       }
-     }
+      if (col < width + GDELAY_X & row < height + GDELAY_Y){
+        for(i = 0; i < KERNEL_SIZE_Y; i++){
+        #pragma HLS unroll
+          for(j = 0; j < KERNEL_SIZE_X-1; j++){
+            win_tmp[i][j] = win_tmp[i][j+1];
+          }
+        }
+      }
+      
+      //**********************************************************
+      // UPDATE THE LINE BUFFER
       //**********************************************************
-      // DO CALCULATIONS
+      if (col < width & row < height+GDELAY_Y){
+        if (KERNEL_SIZE_Y > 1) {
+          LB::shift(lineBuff, lineWord, col, in_pixel, lineCol);
+        }
+        LINE_BUFF_1:
+        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
+        #pragma HLS unroll
+          win_tmp[i][KERNEL_SIZE_X-1] = lineCol[i];
+        }
+        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel;
+      }
+      
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      // HANDLE BORDERS
+      //**********************************************************
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+          win[i][j] = getBorderPixel<BORDER_PADDING>(win_tmp[i], jx);
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+          win[i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+            (IN)BORDER_FILL_VALUE : win[ix][j];
+        }
+      }
+      
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
+      //**********************************************************
+      // Do the filtering
+      if (row >= GDELAY_Y && col >= GDELAY_X){
+        out_pixel = filter(win);
+        out1_s.write(out_pixel);
+        out2_s.write(out_pixel);
       }
     }
   }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processMISOVECT4(
-    hls::stream<IN> &in1_s, 
-    hls::stream<IN> &in2_s, 
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename IN, typename OUT, class Filter>
+void processMISO(
+    hls::stream<IN> &in1_s,
+    hls::stream<IN> &in2_s,
     hls::stream<OUT> &out_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Filter &filter)
 {
   // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==4);
-  
-  IN lineBuff1[SWIN_Y-1][MAX_WIDTH];
+    assert( (KERNEL_SIZE_X % 2) == 1 );
+    assert( (KERNEL_SIZE_Y % 2) == 1 );
+  #endif
+
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,IN> LB;
+  typename LB::word_t lineBuff1[KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff1 dim=1 complete
-  IN win1[SWIN_Y][SWIN_X];
+  typename LB::word_t lineWord1[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord1 complete
+  IN lineCol1[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol1 complete
+  IN win1[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  IN win1_tmp[SWIN_Y][SWIN_X];
+  IN win1_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win1_tmp dim=0 complete
 
-  IN lineBuff2[SWIN_Y-1][MAX_WIDTH];
+  typename LB::word_t lineBuff2[KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff2 dim=1 complete
-  IN win2[SWIN_Y][SWIN_X];
+  typename LB::word_t lineWord2[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord2 complete
+  IN lineCol2[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol2 complete
+  IN win2[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  IN win2_tmp[SWIN_Y][SWIN_X];
+  IN win2_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win2_tmp dim=0 complete
-  
-  INT win1_1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1_1 dim=0 complete
-  INT win1_2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1_2 dim=0 complete
-  INT win1_3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1_3 dim=0 complete
-  INT win1_4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1_4 dim=0 complete
-  
-  INT win2_1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2_1 dim=0 complete
-  INT win2_2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2_2 dim=0 complete
-  INT win2_3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2_3 dim=0 complete
-  INT win2_4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2_4 dim=0 complete
-
-  IN temp_lb;
-  IN in_pixel1, temp_lb1;
-  IN in_pixel2, temp_lb2;
+
   OUT out_pixel;
+  IN in_pixel2;
+  IN in_pixel1;
 
-  int row, col, i, j;
+  int i, j ,row, col;
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  process_main_loop:
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
@@ -2117,1044 +2052,627 @@ void processMISOVECT4(
 
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
       //**********************************************************
-      if (col < width & row < height + GROUP_DELAY_Y)
-     {
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win1_tmp[i][j] = win1_tmp[i][j+1];
-           win2_tmp[i][j] = win2_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win1_tmp[i][SWIN_X-1] = lineBuff1[i][col];
-           win2_tmp[i][SWIN_X-1] = lineBuff2[i][col];
-         } else {
-           temp_lb1 = lineBuff1[i][col];
-           temp_lb2 = lineBuff2[i][col];
-           win1_tmp[i][SWIN_X-1] = temp_lb1;
-           win2_tmp[i][SWIN_X-1] = temp_lb2;
-           lineBuff1[i-1][col] = temp_lb1;
-           lineBuff2[i-1][col] = temp_lb2;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff1[SWIN_Y-2][col] = in_pixel1;
-         lineBuff2[SWIN_Y-2][col] = in_pixel2;
-       }
-       win1_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel1;
-       win2_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel2;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win1[i][j] = win1_tmp[i][jx];
-           win2[i][j] = win2_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win1[i][j] = win1[iy][j];
-            win2[i][j] = win2[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j  ,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j2 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1_1[i][j] = win1[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win1_2[i][j] = win1[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win1_3[i][j] = win1[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win1_4[i][j] = win1[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-           
-           win2_1[i][j] = win2[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2_2[i][j] = win2[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win2_3[i][j] = win2[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win2_4[i][j] = win2[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-         }
-       }
-     }
+      if (col < width + GDELAY_X & row < height + GDELAY_Y){
+        for(i = 0; i < KERNEL_SIZE_Y; i++){
+        #pragma HLS unroll
+          for(j = 0; j < KERNEL_SIZE_X-1; j++){
+            win1_tmp[i][j] = win1_tmp[i][j+1];
+            win2_tmp[i][j] = win2_tmp[i][j+1];
+          }
+        }
+      }
+
       //**********************************************************
-      // DO CALCULATIONS
+      // UPDATE THE LINE BUFFER
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1_1,win2_1);
-        outp[1] = filter(win1_2,win2_2);
-        outp[2] = filter(win1_3,win2_3);
-        outp[3] = filter(win1_4,win2_4);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      if (col < width & row < height+GDELAY_Y){
+        if (KERNEL_SIZE_Y > 1) {
+          LB::shift(lineBuff1, lineWord1, col, in_pixel1, lineCol1);
+          LB::shift(lineBuff2, lineWord2, col, in_pixel2, lineCol2);
+        }
+        LINE_BUFF_1:
+        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
+        #pragma HLS unroll
+          win1_tmp[i][KERNEL_SIZE_X-1] = lineCol1[i];
+          win2_tmp[i][KERNEL_SIZE_X-1] = lineCol2[i];
+        }
+        win1_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel1;
+        win2_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel2;
+      }
+
+      //**********************************************************
+      // HANDLE BORDERS
+      //**********************************************************
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+          win1[i][j] = getBorderPixel<BORDER_PADDING>(win1_tmp[i], jx);
+          win2[i][j] = getBorderPixel<BORDER_PADDING>(win2_tmp[i], jx);
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+          win1[i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+            (IN)BORDER_FILL_VALUE : win1[ix][j];
+          win2[i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+            (IN)BORDER_FILL_VALUE : win2[ix][j];
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
+      //**********************************************************
+      // Do the filtering
+      if (row >= GDELAY_Y && col >= GDELAY_X){
+        out_pixel = filter(win1, win2);
+        out_s.write(out_pixel);
       }
     }
   }
 }
 
+//*********************************************************************************************************************
+// MULTIPLE INPUTS AND OUTPUTS
+//*********************************************************************************************************************
+// compile-time index sequence, expands the windows of all inputs into the
+// arguments of the filter call
+template<int... Is>
+struct IndexSeq {};
 
-  
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT4(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
+template<int N, int... Is>
+struct MakeIndexSeq : MakeIndexSeq<N-1, N-1, Is...> {};
+
+template<int... Is>
+struct MakeIndexSeq<0, Is...> {
+  typedef IndexSeq<Is...> type;
+};
+
+// The stream arguments of processMIMO and processPixelsMIMO are the NUM_OUT
+// output streams followed by the input streams, as in the kernel signature.
+// Stream I is written if it is an output and read into in_pixels otherwise.
+template<int I, int NUM_OUT, typename IN, typename OUT>
+void transferStream(hls::stream<OUT> &s, IN *in_pixels, const OUT &out_pixel,
+    const bool read, const bool write, std::true_type)
+{
+#pragma HLS INLINE
+  if (write) {
+    s << out_pixel;
+  }
+}
+
+template<int I, int NUM_OUT, typename IN, typename OUT>
+void transferStream(hls::stream<IN> &s, IN *in_pixels, const OUT &out_pixel,
+    const bool read, const bool write, std::false_type)
+{
+#pragma HLS INLINE
+  if (read) {
+    s >> in_pixels[I-NUM_OUT];
+  }
+}
+
+template<int I, int NUM_OUT, typename IN, typename OUT>
+void transferStreams(IN *in_pixels, const OUT &out_pixel, const bool read,
+    const bool write)
+{
+}
+
+template<int I, int NUM_OUT, typename IN, typename OUT, typename Stream, typename... Streams>
+void transferStreams(IN *in_pixels, const OUT &out_pixel, const bool read,
+    const bool write, Stream &s, Streams&... streams)
+{
+#pragma HLS INLINE
+  transferStream<I,NUM_OUT>(s, in_pixels, out_pixel, read, write,
+      std::integral_constant<bool, (I < NUM_OUT)>());
+  transferStreams<I+1,NUM_OUT>(in_pixels, out_pixel, read, write, streams...);
+}
+
+template<typename OUT, class Filter, typename WIN, int... Is>
+OUT applyFilter(Filter &filter, WIN &win, IndexSeq<Is...>)
+{
+#pragma HLS INLINE
+  return filter(win[Is]...);
+}
+
+// input map of processes without fused point operators, forwards the pixels
+// read from the input streams
+struct InputIdentity {
+  template<typename IN, int NUM_IN>
+  void operator()(const IN (&raw_pixel)[NUM_IN], IN (&in_pixel)[NUM_IN])
+  {
+  #pragma HLS INLINE
+    for (int n = 0; n < NUM_IN; n++) {
+    #pragma HLS unroll
+      in_pixel[n] = raw_pixel[n];
+    }
+  }
+};
+
+// processing of any number of input streams of type RAW, the result is
+// written to NUM_OUT output streams. The map computes the NUM_IN pixels that
+// enter the line buffers from the pixels read from the streams, this way point
+// operators fused into the process are applied before the windowing.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int NUM_OUT, int NUM_IN, typename RAW, typename IN, typename OUT, class Map, class Filter, typename... Streams>
+void processMappedMIMO(
     const int &width,
     const int &height,
+    Map &map,
     Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Streams&... streams)
 {
+  enum { NUM_RAW = sizeof...(Streams) - NUM_OUT };
+
   // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==4);
-  
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
+    assert( (KERNEL_SIZE_X % 2) == 1 );
+    assert( (KERNEL_SIZE_Y % 2) == 1 );
+    assert( NUM_OUT > 0 && NUM_IN > 0 && NUM_RAW > 0 );
+  #endif
+
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,IN> LB;
+  typename LB::word_t lineBuff[NUM_IN][KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=2 complete
+  typename LB::word_t lineWord[NUM_IN][KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord dim=0 complete
+  IN lineCol[NUM_IN][KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol dim=0 complete
+  IN win[NUM_IN][KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
+  IN win_tmp[NUM_IN][KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
 
-  IN in_pixel, temp_lb;
   OUT out_pixel;
-  int row, col, i, j;
+  RAW raw_pixel[NUM_RAW];
+  #pragma HLS ARRAY_PARTITION variable=raw_pixel complete
+  IN in_pixel[NUM_IN];
+  #pragma HLS ARRAY_PARTITION variable=in_pixel complete
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  int n, i, j;
+
+  process_main_loop:
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
+      if (col < width & row < height){
+        transferStreams<0,NUM_OUT>(raw_pixel, out_pixel, true, false, streams...);
+        map(raw_pixel, in_pixel);
       }
 
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
       //**********************************************************
-      if (col < width & row < height + GROUP_DELAY_Y)
-     {
-       for(i = 0; i < SWIN_Y; i++){
-       #pragma HLS unroll
-         for(j = 0; j < SWIN_X-1; j++){
-           win_tmp[i][j] = win_tmp[i][j+1];
-         }
-       }
-     
-
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-     
-
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j  ,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j2 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win4[i][j] = win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-         }
-       }
-     }
+      if (col < width + GDELAY_X & row < height + GDELAY_Y){
+        for(n = 0; n < NUM_IN; n++){
+        #pragma HLS unroll
+          for(i = 0; i < KERNEL_SIZE_Y; i++){
+          #pragma HLS unroll
+            for(j = 0; j < KERNEL_SIZE_X-1; j++){
+              win_tmp[n][i][j] = win_tmp[n][i][j+1];
+            }
+          }
+        }
+      }
+
       //**********************************************************
-      // DO CALCULATIONS
+      // UPDATE THE LINE BUFFER
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        OUT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        outp[3] = filter(win4);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*O_WIDTH,(i+1)*O_WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      if (col < width & row < height+GDELAY_Y){
+        for(n = 0; n < NUM_IN; n++){
+        #pragma HLS unroll
+          if (KERNEL_SIZE_Y > 1) {
+            LB::shift(lineBuff[n], lineWord[n], col, in_pixel[n], lineCol[n]);
+          }
+          LINE_BUFF_1:
+          for(i = 0; i < KERNEL_SIZE_Y-1; i++){
+          #pragma HLS unroll
+            win_tmp[n][i][KERNEL_SIZE_X-1] = lineCol[n][i];
+          }
+          win_tmp[n][KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel[n];
+        }
+      }
+
+      //**********************************************************
+      // HANDLE BORDERS
+      //**********************************************************
+      for(n = 0; n < NUM_IN; n++){
+        // X-DIRECTION
+        for(i = 0; i < KERNEL_SIZE_Y; i++){
+          for(j = 0; j < KERNEL_SIZE_X; j++){
+            int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+            win[n][i][j] = getBorderPixel<BORDER_PADDING>(win_tmp[n][i], jx);
+          }
+        }
+        // Y-DIRECTION
+        for(i = 0; i < KERNEL_SIZE_Y; i++){
+          for(j = 0; j < KERNEL_SIZE_X; j++){
+            int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+            win[n][i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+              (IN)BORDER_FILL_VALUE : win[n][ix][j];
+          }
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
+      //**********************************************************
+      // Do the filtering
+      if (row >= GDELAY_Y && col >= GDELAY_X){
+        out_pixel = applyFilter<OUT>(filter, win, typename MakeIndexSeq<NUM_IN>::type());
+        transferStreams<0,NUM_OUT>(raw_pixel, out_pixel, false, true, streams...);
       }
     }
   }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT8(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
+// processing of any number of input streams, the result is written to
+// NUM_OUT output streams
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int NUM_OUT, typename IN, typename OUT, class Filter, typename... Streams>
+void processMIMO(
     const int &width,
     const int &height,
     Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Streams&... streams)
+{
+  InputIdentity map;
+  processMappedMIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,NUM_OUT,sizeof...(Streams)-NUM_OUT,IN,IN,OUT>(width, height, map, filter, streams...);
+}
+
+// copies the centered KERNEL_SIZE_Y x KERNEL_SIZE_X part of a larger window
+template<int WIN_SIZE_X, int WIN_SIZE_Y, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN>
+void getSubWindow(IN win[WIN_SIZE_Y][WIN_SIZE_X], IN sub[KERNEL_SIZE_Y][KERNEL_SIZE_X])
+{
+#pragma HLS INLINE
+  for (int i = 0; i < KERNEL_SIZE_Y; i++) {
+  #pragma HLS unroll
+    for (int j = 0; j < KERNEL_SIZE_X; j++) {
+    #pragma HLS unroll
+      sub[i][j] = win[i + (WIN_SIZE_Y-KERNEL_SIZE_Y)/2][j + (WIN_SIZE_X-KERNEL_SIZE_X)/2];
+    }
+  }
+}
+
+// several local operators reading the same stream share a single line buffer
+// sized for the largest window. The filter receives the window and the output
+// streams, extracts the window of each operator using getSubWindow and writes
+// the results itself.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename IN, class Filter, typename... Streams>
+void processShared(
+    const int &width,
+    const int &height,
+    Filter &filter,
+    hls::stream<IN> &in_s,
+    Streams&... out_s)
 {
   // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==8);
- 
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
+    assert( (KERNEL_SIZE_X % 2) == 1 );
+    assert( (KERNEL_SIZE_Y % 2) == 1 );
+  #endif
+
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,IN> LB;
+  typename LB::word_t lineBuff[KERNEL_SIZE_Y-1][LB::WORDS];
   #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
+  typename LB::word_t lineWord[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord complete
+  IN lineCol[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineCol complete
+  IN win[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
+  IN win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
-  INT win5[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win5 dim=0 complete
-  INT win6[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win6 dim=0 complete
-  INT win7[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win7 dim=0 complete
-  INT win8[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win8 dim=0 complete
- 
-  IN in_pixel, temp_lb;
-  OUT out_pixel;
-  int row, col, i, j;
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  IN in_pixel;
+  int i, j;
+
+  process_main_loop:
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
-      if(col < width & row < height){
+      if (col < width & row < height){
         in_s >> in_pixel;
       }
 
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
       //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-        for(i = 0; i < SWIN_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < SWIN_X-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X-1; j++){
+          win_tmp[i][j] = win_tmp[i][j+1];
         }
-      } 
+      }
 
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-     if (col < width & row < height + GROUP_DELAY_Y){
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-      } 
+      //**********************************************************
+      // UPDATE THE LINE BUFFER
+      //**********************************************************
+      if (col < width){
+        if (KERNEL_SIZE_Y > 1) {
+          LB::shift(lineBuff, lineWord, col, in_pixel, lineCol);
+        }
+        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
+          win_tmp[i][KERNEL_SIZE_X-1] = lineCol[i];
+        }
+        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel;
+      }
 
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j5 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+4,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j6 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+5,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j7 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+6,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j8 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+7,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win4[i][j] = win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-           win5[i][j] = win[i][j5.win]((j5.pos)*WIDTH,(j5.pos+1)*WIDTH-1);
-           win6[i][j] = win[i][j6.win]((j6.pos)*WIDTH,(j6.pos+1)*WIDTH-1);
-           win7[i][j] = win[i][j7.win]((j7.pos)*WIDTH,(j7.pos+1)*WIDTH-1);
-           win8[i][j] = win[i][j8.win]((j8.pos)*WIDTH,(j8.pos+1)*WIDTH-1);
-         }
-       }
-     }
       //**********************************************************
-      // DO CALCULATIONS
+      // HANDLE BORDERS
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        OUT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        outp[3] = filter(win4);
-        outp[4] = filter(win5);
-        outp[5] = filter(win6);
-        outp[6] = filter(win7);
-        outp[7] = filter(win8);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*O_WIDTH,(i+1)*O_WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+          win[i][j] = getBorderPixel<BORDER_PADDING>(win_tmp[i], jx);
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE_Y; i++){
+        for(j = 0; j < KERNEL_SIZE_X; j++){
+          int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+          win[i][j] = (BORDER_PADDING == BorderPadding::BORDER_CONST && ix < 0) ?
+            (IN)BORDER_FILL_VALUE : win[ix][j];
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
+      //**********************************************************
+      if (row >= GDELAY_Y && col >= GDELAY_X){
+        filter(win, out_s...);
       }
     }
   }
 }
-  
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT16(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
+
+//*********************************************************************************************************************
+// SEPARABLE LOCAL OPERATORS
+//*********************************************************************************************************************
+// row FIR, filters each line with a horizontal 1 x KERNEL_SIZE_X mask. The
+// pixels read from the RAW input streams are mapped to the filtered pixel, see
+// processMappedMIMO.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, BorderPadding::values BORDER_PADDING, typename INT, typename RAW, typename IN, typename COEF, class Map, typename... Streams>
+void processMappedRowFIR(
+    hls::stream<INT> &out_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    const COEF coef[KERNEL_SIZE_X],
+    Map &map,
+    Streams&... streams)
 {
-  // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==16);
- 
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
-  INT win5[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win5 dim=0 complete
-  INT win6[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win6 dim=0 complete
-  INT win7[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win7 dim=0 complete
-  INT win8[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win8 dim=0 complete
-  INT win9[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win9 dim=0 complete
-  INT win10[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win10 dim=0 complete
-  INT win11[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win11 dim=0 complete
-  INT win12[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win12 dim=0 complete
-  INT win13[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win13 dim=0 complete
-  INT win14[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win14 dim=0 complete
-  INT win15[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win15 dim=0 complete
-  INT win16[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win16 dim=0 complete
-  
-  IN in_pixel, out_pixel, temp_lb;
-
-  int row, col, i, j;
+    assert( (KERNEL_SIZE_X % 2) == 1 );
+  #endif
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  IN win[KERNEL_SIZE_X];
+  #pragma HLS ARRAY_PARTITION variable=win complete
+  IN win_tmp[KERNEL_SIZE_X];
+  #pragma HLS ARRAY_PARTITION variable=win_tmp complete
+
+  RAW raw_pixel[sizeof...(Streams)];
+  #pragma HLS ARRAY_PARTITION variable=raw_pixel complete
+  IN in_pixel[1];
+  INT sum = 0;
+  int j;
+
+  for (int row = 0; row < height; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GDELAY_X; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
 
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-        for(i = 0; i < SWIN_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < SWIN_X-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      } 
+      // get new input and shift the window
+      if (col < width) {
+        transferStreams<0,0>(raw_pixel, sum, true, false, streams...);
+        map(raw_pixel, in_pixel);
+      }
+      for (j = 0; j < KERNEL_SIZE_X-1; j++) {
+        win_tmp[j] = win_tmp[j+1];
+      }
+      win_tmp[KERNEL_SIZE_X-1] = in_pixel[0];
 
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-     if (col < width & row < height + GROUP_DELAY_Y){
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-      } 
+      // handle borders in x-direction
+      for (j = 0; j < KERNEL_SIZE_X; j++) {
+        int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,GDELAY_X,col,width);
+        win[j] = getBorderPixel<BORDER_PADDING>(win_tmp, jx);
+      }
 
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j5 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+4,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j6 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+5,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j7 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+6,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j8 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+7,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j9 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+8,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j10 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+9,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j11 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+10,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j12 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+11,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j13 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+12,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j14 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+13,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j15 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+14,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j16 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+15,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win4[i][j] = win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-           win5[i][j] = win[i][j5.win]((j5.pos)*WIDTH,(j5.pos+1)*WIDTH-1);
-           win6[i][j] = win[i][j6.win]((j6.pos)*WIDTH,(j6.pos+1)*WIDTH-1);
-           win7[i][j] = win[i][j7.win]((j7.pos)*WIDTH,(j7.pos+1)*WIDTH-1);
-           win8[i][j] = win[i][j8.win]((j8.pos)*WIDTH,(j8.pos+1)*WIDTH-1);
-           win9[i][j] = win[i][j9.win]((j9.pos)*WIDTH,(j9.pos+1)*WIDTH-1);
-           win10[i][j] = win[i][j10.win]((j10.pos)*WIDTH,(j10.pos+1)*WIDTH-1);
-           win11[i][j] = win[i][j11.win]((j11.pos)*WIDTH,(j11.pos+1)*WIDTH-1);
-           win12[i][j] = win[i][j12.win]((j12.pos)*WIDTH,(j12.pos+1)*WIDTH-1);
-           win13[i][j] = win[i][j13.win]((j13.pos)*WIDTH,(j13.pos+1)*WIDTH-1);
-           win14[i][j] = win[i][j14.win]((j14.pos)*WIDTH,(j14.pos+1)*WIDTH-1);
-           win15[i][j] = win[i][j15.win]((j15.pos)*WIDTH,(j15.pos+1)*WIDTH-1);
-           win16[i][j] = win[i][j16.win]((j16.pos)*WIDTH,(j16.pos+1)*WIDTH-1);
-         }
-       }
-     }
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        outp[3] = filter(win4);
-        outp[4] = filter(win5);
-        outp[5] = filter(win6);
-        outp[6] = filter(win7);
-        outp[7] = filter(win8);
-        outp[8] = filter(win9);
-        outp[9] = filter(win10);
-        outp[10] = filter(win11);
-        outp[11] = filter(win12);
-        outp[12] = filter(win13);
-        outp[13] = filter(win14);
-        outp[14] = filter(win15);
-        outp[15] = filter(win16);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      if (col >= GDELAY_X) {
+        sum = 0;
+        for (j = 0; j < KERNEL_SIZE_X; j++) {
+          sum += (INT)win[j] * coef[j];
+        }
+        out_s << sum;
       }
     }
   }
 }
 
+// row FIR, filters each line with a horizontal 1 x KERNEL_SIZE_X mask
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, BorderPadding::values BORDER_PADDING, typename INT, typename IN, typename COEF>
+void processRowFIR(
+    hls::stream<IN> &in_s,
+    hls::stream<INT> &out_s,
+    const int &width,
+    const int &height,
+    const COEF coef[KERNEL_SIZE_X])
+{
+  InputIdentity map;
+  processMappedRowFIR<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,BORDER_PADDING,INT,IN,IN>(out_s, width, height, coef, map, in_s);
+}
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT32(
-    hls::stream<IN> &in_s, 
+// column FIR, filters the row FIR results with a vertical KERNEL_SIZE_Y x 1
+// mask using only a single column window. Rows outside the image are replaced
+// by fill for BORDER_CONST, which is the row FIR result of a constant row.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename INT, typename OUT, typename COEF>
+void processColFIR(
+    hls::stream<INT> &in_s,
     hls::stream<OUT> &out_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    const COEF coef[KERNEL_SIZE_Y],
+    const INT &fill)
 {
-  // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==32);
- 
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
-  INT win5[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win5 dim=0 complete
-  INT win6[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win6 dim=0 complete
-  INT win7[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win7 dim=0 complete
-  INT win8[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win8 dim=0 complete
-  INT win9[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win9 dim=0 complete
-  INT win10[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win10 dim=0 complete
-  INT win11[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win11 dim=0 complete
-  INT win12[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win12 dim=0 complete
-  INT win13[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win13 dim=0 complete
-  INT win14[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win14 dim=0 complete
-  INT win15[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win15 dim=0 complete
-  INT win16[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win16 dim=0 complete
-  INT win17[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win17 dim=0 complete
-  INT win18[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win18 dim=0 complete
-  INT win19[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win19 dim=0 complete
-  INT win20[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win20 dim=0 complete
-  INT win21[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win21 dim=0 complete
-  INT win22[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win22 dim=0 complete
-  INT win23[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win23 dim=0 complete
-  INT win24[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win24 dim=0 complete
-  INT win25[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win25 dim=0 complete
-  INT win26[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win26 dim=0 complete
-  INT win27[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win27 dim=0 complete
-  INT win28[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win28 dim=0 complete
-  INT win29[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win29 dim=0 complete
-  INT win30[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win30 dim=0 complete
-  INT win31[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win31 dim=0 complete
-  INT win32[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win32 dim=0 complete
-  
-  IN in_pixel, out_pixel, temp_lb;
-
-  int row, col, i, j;
+    assert( (KERNEL_SIZE_Y % 2) == 1 );
+  #endif
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  typedef LineBuffer<KERNEL_SIZE_Y-1,MAX_WIDTH,INT> LB;
+  typename LB::word_t lineBuff[KERNEL_SIZE_Y-1][LB::WORDS];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
+  typename LB::word_t lineWord[KERNEL_SIZE_Y-1];
+  #pragma HLS ARRAY_PARTITION variable=lineWord complete
+  INT win[KERNEL_SIZE_Y];
+  #pragma HLS ARRAY_PARTITION variable=win complete
+  INT win_tmp[KERNEL_SIZE_Y];
+  #pragma HLS ARRAY_PARTITION variable=win_tmp complete
+
+  INT in_pixel;
+  int i;
+
+  for (int row = 0; row < height + GDELAY_Y; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
+
+      // get new input
+      if (row < height) {
         in_s >> in_pixel;
       }
 
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-        for(i = 0; i < SWIN_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < SWIN_X-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      } 
+      // update the column window and the line buffer
+      LB::shift(lineBuff, lineWord, col, in_pixel, win_tmp);
+      win_tmp[KERNEL_SIZE_Y-1] = in_pixel;
 
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-     if (col < width & row < height + GROUP_DELAY_Y){
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-      } 
+      // handle borders in y-direction
+      for (i = 0; i < KERNEL_SIZE_Y; i++) {
+        int ix = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+        win[i] = getBorderPixel<BORDER_PADDING>(win_tmp, ix, fill);
+      }
 
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j5 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+4,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j6 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+5,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j7 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+6,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j8 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+7,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j9 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+8,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j10 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+9,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j11 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+10,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j12 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+11,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j13 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+12,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j14 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+13,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j15 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+14,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j16 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+15,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j17 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+16,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j18 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+17,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j19 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+18,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j20 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+19,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j21 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+20,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j22 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+21,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j23 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+22,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j24 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+23,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j25 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+24,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j26 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+25,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j27 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+26,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j28 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+27,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j29 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+28,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j30 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+29,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j31 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+10,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j32 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+11,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win4[i][j] = win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-           win5[i][j] = win[i][j5.win]((j5.pos)*WIDTH,(j5.pos+1)*WIDTH-1);
-           win6[i][j] = win[i][j6.win]((j6.pos)*WIDTH,(j6.pos+1)*WIDTH-1);
-           win7[i][j] = win[i][j7.win]((j7.pos)*WIDTH,(j7.pos+1)*WIDTH-1);
-           win8[i][j] = win[i][j8.win]((j8.pos)*WIDTH,(j8.pos+1)*WIDTH-1);
-           win9[i][j] = win[i][j9.win]((j9.pos)*WIDTH,(j9.pos+1)*WIDTH-1);
-           win10[i][j] = win[i][j10.win]((j10.pos)*WIDTH,(j10.pos+1)*WIDTH-1);
-           win11[i][j] = win[i][j11.win]((j11.pos)*WIDTH,(j11.pos+1)*WIDTH-1);
-           win12[i][j] = win[i][j12.win]((j12.pos)*WIDTH,(j12.pos+1)*WIDTH-1);
-           win13[i][j] = win[i][j13.win]((j13.pos)*WIDTH,(j13.pos+1)*WIDTH-1);
-           win14[i][j] = win[i][j14.win]((j14.pos)*WIDTH,(j14.pos+1)*WIDTH-1);
-           win15[i][j] = win[i][j15.win]((j15.pos)*WIDTH,(j15.pos+1)*WIDTH-1);
-           win16[i][j] = win[i][j16.win]((j16.pos)*WIDTH,(j16.pos+1)*WIDTH-1);
-           win17[i][j] = win[i][j17.win]((j17.pos)*WIDTH,(j17.pos+1)*WIDTH-1);
-           win18[i][j] = win[i][j18.win]((j18.pos)*WIDTH,(j18.pos+1)*WIDTH-1);
-           win19[i][j] = win[i][j19.win]((j19.pos)*WIDTH,(j19.pos+1)*WIDTH-1);
-           win20[i][j] = win[i][j20.win]((j20.pos)*WIDTH,(j20.pos+1)*WIDTH-1);
-           win21[i][j] = win[i][j21.win]((j21.pos)*WIDTH,(j21.pos+1)*WIDTH-1);
-           win22[i][j] = win[i][j22.win]((j22.pos)*WIDTH,(j22.pos+1)*WIDTH-1);
-           win23[i][j] = win[i][j23.win]((j23.pos)*WIDTH,(j23.pos+1)*WIDTH-1);
-           win24[i][j] = win[i][j24.win]((j24.pos)*WIDTH,(j24.pos+1)*WIDTH-1);
-           win25[i][j] = win[i][j25.win]((j25.pos)*WIDTH,(j25.pos+1)*WIDTH-1);
-           win26[i][j] = win[i][j26.win]((j26.pos)*WIDTH,(j26.pos+1)*WIDTH-1);
-           win27[i][j] = win[i][j27.win]((j27.pos)*WIDTH,(j27.pos+1)*WIDTH-1);
-           win28[i][j] = win[i][j28.win]((j28.pos)*WIDTH,(j28.pos+1)*WIDTH-1);
-           win29[i][j] = win[i][j29.win]((j29.pos)*WIDTH,(j29.pos+1)*WIDTH-1);
-           win30[i][j] = win[i][j30.win]((j30.pos)*WIDTH,(j30.pos+1)*WIDTH-1);
-           win31[i][j] = win[i][j31.win]((j31.pos)*WIDTH,(j31.pos+1)*WIDTH-1);
-           win32[i][j] = win[i][j32.win]((j32.pos)*WIDTH,(j32.pos+1)*WIDTH-1);
-         }
-       }
-     }
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        outp[3] = filter(win4);
-        outp[4] = filter(win5);
-        outp[5] = filter(win6);
-        outp[6] = filter(win7);
-        outp[7] = filter(win8);
-        outp[8] = filter(win9);
-        outp[9] = filter(win10);
-        outp[10] = filter(win11);
-        outp[11] = filter(win12);
-        outp[12] = filter(win13);
-        outp[13] = filter(win14);
-        outp[14] = filter(win15);
-        outp[15] = filter(win16);
-        outp[16] = filter(win17);
-        outp[17] = filter(win18);
-        outp[18] = filter(win19);
-        outp[19] = filter(win20);
-        outp[20] = filter(win21);
-        outp[21] = filter(win22);
-        outp[22] = filter(win23);
-        outp[23] = filter(win24);
-        outp[24] = filter(win25);
-        outp[25] = filter(win26);
-        outp[26] = filter(win27);
-        outp[27] = filter(win28);
-        outp[28] = filter(win29);
-        outp[29] = filter(win30);
-        outp[30] = filter(win31);
-        outp[31] = filter(win32);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      if (row >= GDELAY_Y) {
+        INT sum = 0;
+        for (i = 0; i < KERNEL_SIZE_Y; i++) {
+          sum += win[i] * coef[i];
+        }
+        out_s << (OUT)sum;
       }
     }
   }
 }
 
+// row FIR result of a row filled with the BORDER_CONST fill value
+template<int KERNEL_SIZE_X, typename INT, typename IN, typename COEF>
+INT getRowFill(const COEF coef[KERNEL_SIZE_X])
+{
+#pragma HLS INLINE
+  INT fill = 0;
+  for (int j = 0; j < KERNEL_SIZE_X; j++) {
+    fill += (INT)(IN)BORDER_FILL_VALUE * coef[j];
+  }
+  return fill;
+}
+
+// separable convolution, row FIR followed by column FIR
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename INT, typename IN, typename OUT, typename COEF>
+void processSeparable(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    const COEF rowCoef[KERNEL_SIZE_X],
+    const COEF colCoef[KERNEL_SIZE_Y])
+{
+  #pragma HLS dataflow
+  hls::stream<INT> row_s;
+
+  processRowFIR<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,BORDER_PADDING,INT>(in_s, row_s, width, height, rowCoef);
+  processColFIR<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_Y,BORDER_PADDING,INT>(row_s, out_s, width, height, colCoef,
+      getRowFill<KERNEL_SIZE_X,INT,IN>(rowCoef));
+}
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
-void processVECT64(
-    hls::stream<IN> &in_s, 
+// separable convolution of the pixels mapped from the RAW input streams, see
+// processMappedMIMO
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, typename INT, typename RAW, typename IN, typename OUT, typename COEF, class Map, typename... Streams>
+void processMappedSeparable(
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    const COEF rowCoef[KERNEL_SIZE_X],
+    const COEF colCoef[KERNEL_SIZE_Y],
+    Map &map,
+    Streams&... streams)
+{
+  #pragma HLS dataflow
+  hls::stream<INT> row_s;
+
+  processMappedRowFIR<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,BORDER_PADDING,INT,RAW,IN>(row_s, width, height, rowCoef, map, streams...);
+  processColFIR<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_Y,BORDER_PADDING,INT>(row_s, out_s, width, height, colCoef,
+      getRowFill<KERNEL_SIZE_X,INT,IN>(rowCoef));
+}
+
+//*********************************************************************************************************************
+// PYRAMID OPERATORS
+//*********************************************************************************************************************
+// downsampling
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void downsample(
+    hls::stream<IN> &in_s,
     hls::stream<OUT> &out_s,
     const int &width,
     const int &height,
+    const int &factor,
     Filter &filter,
     const enum BorderPadding::values borderPadding)
 {
   // TODO fix this
+  #ifdef ASSERTION_CHECK
     assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert(VECT==64);
- 
-  IN lineBuff[SWIN_Y-1][MAX_WIDTH];
+    assert( (KERNEL_SIZE % 2) == 1 );
+  #endif
+
+  IN lineBuff[KERNEL_SIZE-1][MAX_WIDTH];
   #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[SWIN_Y][SWIN_X];
+  IN win[KERNEL_SIZE][KERNEL_SIZE];
   #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[SWIN_Y][SWIN_X];
+  IN win_tmp[KERNEL_SIZE][KERNEL_SIZE];
   #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  INT win1[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  INT win2[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  INT win3[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win3 dim=0 complete
-  INT win4[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win4 dim=0 complete
-  INT win5[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win5 dim=0 complete
-  INT win6[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win6 dim=0 complete
-  INT win7[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win7 dim=0 complete
-  INT win8[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win8 dim=0 complete
-  INT win9[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win9 dim=0 complete
-  INT win10[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win10 dim=0 complete
-  INT win11[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win11 dim=0 complete
-  INT win12[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win12 dim=0 complete
-  INT win13[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win13 dim=0 complete
-  INT win14[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win14 dim=0 complete
-  INT win15[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win15 dim=0 complete
-  INT win16[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win16 dim=0 complete
-  INT win17[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win17 dim=0 complete
-  INT win18[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win18 dim=0 complete
-  INT win19[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win19 dim=0 complete
-  INT win20[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win20 dim=0 complete
-  INT win21[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win21 dim=0 complete
-  INT win22[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win22 dim=0 complete
-  INT win23[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win23 dim=0 complete
-  INT win24[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win24 dim=0 complete
-  INT win25[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win25 dim=0 complete
-  INT win26[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win26 dim=0 complete
-  INT win27[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win27 dim=0 complete
-  INT win28[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win28 dim=0 complete
-  INT win29[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win29 dim=0 complete
-  INT win30[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win30 dim=0 complete
-  INT win31[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win31 dim=0 complete
-  INT win32[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win32 dim=0 complete
-  INT win33[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win33 dim=0 complete
-  INT win34[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win34 dim=0 complete
-  INT win35[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win35 dim=0 complete
-  INT win36[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win36 dim=0 complete
-  INT win37[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win37 dim=0 complete
-  INT win38[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win38 dim=0 complete
-  INT win39[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win39 dim=0 complete
-  INT win40[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win40 dim=0 complete
-  INT win41[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win41 dim=0 complete
-  INT win42[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win42 dim=0 complete
-  INT win43[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win43 dim=0 complete
-  INT win44[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win44 dim=0 complete
-  INT win45[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win45 dim=0 complete
-  INT win46[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win46 dim=0 complete
-  INT win47[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win47 dim=0 complete
-  INT win48[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win48 dim=0 complete
-  INT win49[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win49 dim=0 complete
-  INT win50[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win50 dim=0 complete
-  INT win51[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win51 dim=0 complete
-  INT win52[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win52 dim=0 complete
-  INT win53[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win53 dim=0 complete
-  INT win54[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win54 dim=0 complete
-  INT win55[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win55 dim=0 complete
-  INT win56[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win56 dim=0 complete
-  INT win57[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win57 dim=0 complete
-  INT win58[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win58 dim=0 complete
-  INT win59[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win59 dim=0 complete
-  INT win60[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win60 dim=0 complete
-  INT win61[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win61 dim=0 complete
-  INT win62[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win62 dim=0 complete
-  INT win63[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win63 dim=0 complete
-  INT win64[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win64 dim=0 complete
-  
-  IN in_pixel, out_pixel, temp_lb;
 
-  int row, col, i, j;
+  OUT out_pixel;
+  IN temp_lb, in_pixel;
+  int i, j ,row, col;
+
+  int mod = GROUP_DELAY%2;
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  process_main_loop:
+  for (int row = 0; row < height + GROUP_DELAY; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GROUP_DELAY; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
+
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
@@ -3164,271 +2682,299 @@ void processVECT64(
 
       //**********************************************************
       // UPDATE THE WINDOW
-      // The line buffer behaves normally
       //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-        for(i = 0; i < SWIN_Y; i++){
+      if (col < width + GROUP_DELAY & row < height + GROUP_DELAY){
+        for(i = 0; i < KERNEL_SIZE; i++){
         #pragma HLS unroll
-          for(j = 0; j < SWIN_X-1; j++){
+          for(j = 0; j < KERNEL_SIZE-1; j++){
             win_tmp[i][j] = win_tmp[i][j+1];
           }
         }
-      } 
+      }
 
-     //**********************************************************
-     // UPDATE THE LINE BUFFER
-     // The line buffer behaves normally
-     //**********************************************************
-     if (col < width & row < height + GROUP_DELAY_Y){
-       LINE_BUFF_1:
-       for(i = 0; i < SWIN_Y-1; i++){
-       #pragma HLS unroll
-         if (i == 0) {
-           win_tmp[i][SWIN_X-1] = lineBuff[i][col];
-         } else {
-           temp_lb = lineBuff[i][col];
-           win_tmp[i][SWIN_X-1] = temp_lb;
-           lineBuff[i-1][col] = temp_lb;
-         }
-       }
-       if (SWIN_Y > 1) {
-         lineBuff[SWIN_Y-2][col] = in_pixel;
-       }
-       win_tmp[SWIN_Y-1][SWIN_X-1] = in_pixel;
-      } 
+      //**********************************************************
+      // UPDATE THE LINE BUFFER
+      //**********************************************************
+      if (col < width & row < height+GROUP_DELAY){
+        LINE_BUFF_1:
+        for(i = 0; i < KERNEL_SIZE-1; i++){
+        #pragma HLS unroll
+          if (i == 0) {
+            win_tmp[i][KERNEL_SIZE-1] = lineBuff[i][col];
+          } else {
+            temp_lb = lineBuff[i][col];
+            win_tmp[i][KERNEL_SIZE-1] = temp_lb;
+            lineBuff[i-1][col] = temp_lb;
+          }
+        }
+        //this is not necessary for the last lines, but it does not hurt and simplifies control
+        if (KERNEL_SIZE > 1) {
+          lineBuff[KERNEL_SIZE-2][col] = in_pixel;
+        }
+        win_tmp[KERNEL_SIZE-1][KERNEL_SIZE-1] = in_pixel;
+      }
 
-     //**********************************************************
-     // UPDATE THE LP WINDOW
-     // Window update includes mirroring border treatment
-     //**********************************************************
-      if (col < width+GROUP_DELAY_X & row < height + GROUP_DELAY_Y)
-      {
-       // X-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int jx = getNewCoords(j,SWIN_X,GROUP_DELAY_X,col,width,borderPadding);
-           win[i][j] = win_tmp[i][jx];
-         }
-       }
-       // Y-DIRECTION
-       for(i = 0; i < SWIN_Y; i++){
-         for(j = 0; j < SWIN_X; j++){
-           int iy = getNewCoords(i,SWIN_Y,GROUP_DELAY_Y,row,height,borderPadding);
-            win[i][j] = win[iy][j];
-         }
-       }
-     
-     //**********************************************************
-     // ASSIGN WINDOWS 
-     //**********************************************************
-     // left
-       for(int j = 0; j < KERNEL_SIZE; j++){
-         winPos j1 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j,  KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j2 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+1,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j3 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+2,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j4 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+3,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j5 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+4,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         winPos j6 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+5,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j7 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+6,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j8 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+7,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j9 =  getWinCoords((SRADIUS_X*VECT)-RADIUS+j+8,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j10 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+9,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j11 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+10,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j12 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+11,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j13 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+12,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j14 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+13,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j15 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+14,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j16 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+15,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j17 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+16,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j18 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+17,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j19 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+18,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j20 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+19,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j21 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+20,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j22 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+21,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j23 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+22,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j24 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+23,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j25 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+24,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j26 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+25,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j27 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+26,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j28 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+27,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j29 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+28,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j30 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+29,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j31 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+30,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j32 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+31,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j33 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+32,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j34 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+33,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j35 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+34,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j36 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+35,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j37 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+36,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j38 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+37,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j39 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+38,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j40 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+39,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j41 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+40,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j42 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+41,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j43 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+42,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j44 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+43,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j45 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+44,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j46 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+45,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j47 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+46,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j48 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+47,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j49 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+48,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j50 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+49,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j51 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+50,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j52 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+51,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j53 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+52,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j54 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+53,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j55 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+54,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j56 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+55,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j57 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+56,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j58 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+57,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j59 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+58,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j60 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+59,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j61 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+60,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j62 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+61,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j63 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+62,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY_X,col,width,borderPadding);
-         winPos j64 = getWinCoords((SRADIUS_X*VECT)-RADIUS+j+63,KERNEL_SIZE, SWIN_X,VECT,GROUP_DELAY,col,width,borderPadding);
-         for(int i = 0; i < KERNEL_SIZE; i++){
-           win1[i][j] = win[i][j1.win]((j1.pos)*WIDTH,(j1.pos+1)*WIDTH-1);
-           win2[i][j] = win[i][j2.win]((j2.pos)*WIDTH,(j2.pos+1)*WIDTH-1);
-           win3[i][j] = win[i][j3.win]((j3.pos)*WIDTH,(j3.pos+1)*WIDTH-1);
-           win4[i][j] = win[i][j4.win]((j4.pos)*WIDTH,(j4.pos+1)*WIDTH-1);
-           win5[i][j] = win[i][j5.win]((j5.pos)*WIDTH,(j5.pos+1)*WIDTH-1);
-           win6[i][j] = win[i][j6.win]((j6.pos)*WIDTH,(j6.pos+1)*WIDTH-1);
-           win7[i][j] = win[i][j7.win]((j7.pos)*WIDTH,(j7.pos+1)*WIDTH-1);
-           win8[i][j] = win[i][j8.win]((j8.pos)*WIDTH,(j8.pos+1)*WIDTH-1);
-           win9[i][j] = win[i][j9.win]((j9.pos)*WIDTH,(j9.pos+1)*WIDTH-1);
-           win10[i][j] = win[i][j10.win]((j10.pos)*WIDTH,(j10.pos+1)*WIDTH-1);
-           win11[i][j] = win[i][j11.win]((j11.pos)*WIDTH,(j11.pos+1)*WIDTH-1);
-           win12[i][j] = win[i][j12.win]((j12.pos)*WIDTH,(j12.pos+1)*WIDTH-1);
-           win13[i][j] = win[i][j13.win]((j13.pos)*WIDTH,(j13.pos+1)*WIDTH-1);
-           win14[i][j] = win[i][j14.win]((j14.pos)*WIDTH,(j14.pos+1)*WIDTH-1);
-           win15[i][j] = win[i][j15.win]((j15.pos)*WIDTH,(j15.pos+1)*WIDTH-1);
-           win16[i][j] = win[i][j16.win]((j16.pos)*WIDTH,(j16.pos+1)*WIDTH-1);
-           win17[i][j] = win[i][j17.win]((j17.pos)*WIDTH,(j17.pos+1)*WIDTH-1);
-           win18[i][j] = win[i][j18.win]((j18.pos)*WIDTH,(j18.pos+1)*WIDTH-1);
-           win19[i][j] = win[i][j19.win]((j19.pos)*WIDTH,(j19.pos+1)*WIDTH-1);
-           win20[i][j] = win[i][j20.win]((j20.pos)*WIDTH,(j20.pos+1)*WIDTH-1);
-           win21[i][j] = win[i][j21.win]((j21.pos)*WIDTH,(j21.pos+1)*WIDTH-1);
-           win22[i][j] = win[i][j22.win]((j22.pos)*WIDTH,(j22.pos+1)*WIDTH-1);
-           win23[i][j] = win[i][j23.win]((j23.pos)*WIDTH,(j23.pos+1)*WIDTH-1);
-           win24[i][j] = win[i][j24.win]((j24.pos)*WIDTH,(j24.pos+1)*WIDTH-1);
-           win25[i][j] = win[i][j25.win]((j25.pos)*WIDTH,(j25.pos+1)*WIDTH-1);
-           win26[i][j] = win[i][j26.win]((j26.pos)*WIDTH,(j26.pos+1)*WIDTH-1);
-           win27[i][j] = win[i][j27.win]((j27.pos)*WIDTH,(j27.pos+1)*WIDTH-1);
-           win28[i][j] = win[i][j28.win]((j28.pos)*WIDTH,(j28.pos+1)*WIDTH-1);
-           win29[i][j] = win[i][j29.win]((j29.pos)*WIDTH,(j29.pos+1)*WIDTH-1);
-           win30[i][j] = win[i][j30.win]((j30.pos)*WIDTH,(j30.pos+1)*WIDTH-1);
-           win31[i][j] = win[i][j31.win]((j31.pos)*WIDTH,(j31.pos+1)*WIDTH-1);
-           win32[i][j] = win[i][j32.win]((j32.pos)*WIDTH,(j32.pos+1)*WIDTH-1);
-           win33[i][j] = win[i][j33.win]((j33.pos)*WIDTH,(j33.pos+1)*WIDTH-1);
-           win34[i][j] = win[i][j34.win]((j34.pos)*WIDTH,(j34.pos+1)*WIDTH-1);
-           win35[i][j] = win[i][j35.win]((j35.pos)*WIDTH,(j35.pos+1)*WIDTH-1);
-           win36[i][j] = win[i][j36.win]((j36.pos)*WIDTH,(j36.pos+1)*WIDTH-1);
-           win37[i][j] = win[i][j37.win]((j37.pos)*WIDTH,(j37.pos+1)*WIDTH-1);
-           win38[i][j] = win[i][j38.win]((j38.pos)*WIDTH,(j38.pos+1)*WIDTH-1);
-           win39[i][j] = win[i][j39.win]((j39.pos)*WIDTH,(j39.pos+1)*WIDTH-1);
-           win40[i][j] = win[i][j40.win]((j40.pos)*WIDTH,(j40.pos+1)*WIDTH-1);
-           win41[i][j] = win[i][j41.win]((j41.pos)*WIDTH,(j41.pos+1)*WIDTH-1);
-           win42[i][j] = win[i][j42.win]((j42.pos)*WIDTH,(j42.pos+1)*WIDTH-1);
-           win43[i][j] = win[i][j43.win]((j43.pos)*WIDTH,(j43.pos+1)*WIDTH-1);
-           win44[i][j] = win[i][j44.win]((j44.pos)*WIDTH,(j44.pos+1)*WIDTH-1);
-           win45[i][j] = win[i][j45.win]((j45.pos)*WIDTH,(j45.pos+1)*WIDTH-1);
-           win46[i][j] = win[i][j46.win]((j46.pos)*WIDTH,(j46.pos+1)*WIDTH-1);
-           win47[i][j] = win[i][j47.win]((j47.pos)*WIDTH,(j47.pos+1)*WIDTH-1);
-           win48[i][j] = win[i][j48.win]((j48.pos)*WIDTH,(j48.pos+1)*WIDTH-1);
-           win49[i][j] = win[i][j49.win]((j49.pos)*WIDTH,(j49.pos+1)*WIDTH-1);
-           win50[i][j] = win[i][j50.win]((j50.pos)*WIDTH,(j50.pos+1)*WIDTH-1);
-           win51[i][j] = win[i][j51.win]((j51.pos)*WIDTH,(j51.pos+1)*WIDTH-1);
-           win52[i][j] = win[i][j52.win]((j52.pos)*WIDTH,(j52.pos+1)*WIDTH-1);
-           win53[i][j] = win[i][j53.win]((j53.pos)*WIDTH,(j53.pos+1)*WIDTH-1);
-           win54[i][j] = win[i][j54.win]((j54.pos)*WIDTH,(j54.pos+1)*WIDTH-1);
-           win55[i][j] = win[i][j55.win]((j55.pos)*WIDTH,(j55.pos+1)*WIDTH-1);
-           win56[i][j] = win[i][j56.win]((j56.pos)*WIDTH,(j56.pos+1)*WIDTH-1);
-           win57[i][j] = win[i][j57.win]((j57.pos)*WIDTH,(j57.pos+1)*WIDTH-1);
-           win58[i][j] = win[i][j58.win]((j58.pos)*WIDTH,(j58.pos+1)*WIDTH-1);
-           win59[i][j] = win[i][j59.win]((j59.pos)*WIDTH,(j59.pos+1)*WIDTH-1);
-           win60[i][j] = win[i][j60.win]((j60.pos)*WIDTH,(j60.pos+1)*WIDTH-1);
-           win61[i][j] = win[i][j61.win]((j61.pos)*WIDTH,(j61.pos+1)*WIDTH-1);
-           win62[i][j] = win[i][j62.win]((j62.pos)*WIDTH,(j62.pos+1)*WIDTH-1);
-           win63[i][j] = win[i][j63.win]((j63.pos)*WIDTH,(j63.pos+1)*WIDTH-1);
-           win64[i][j] = win[i][j64.win]((j64.pos)*WIDTH,(j64.pos+1)*WIDTH-1);
-         }
-       }
-     }
       //**********************************************************
-      // DO CALCULATIONS
+      // HANDLE BORDERS 
       //**********************************************************
-      if(row >= GROUP_DELAY_Y && col >= GROUP_DELAY_X)
-      {
-        INT outp[VECT];
-        outp[0] = filter(win1);
-        outp[1] = filter(win2);
-        outp[2] = filter(win3);
-        outp[3] = filter(win4);
-        outp[4] = filter(win5);
-        outp[5] = filter(win6);
-        outp[6] = filter(win7);
-        outp[7] = filter(win8);
-        outp[8] = filter(win9);
-        outp[9] = filter(win10);
-        outp[10] = filter(win11);
-        outp[11] = filter(win12);
-        outp[12] = filter(win13);
-        outp[13] = filter(win14);
-        outp[14] = filter(win15);
-        outp[15] = filter(win16);
-        outp[16] = filter(win17);
-        outp[17] = filter(win18);
-        outp[18] = filter(win19);
-        outp[19] = filter(win20);
-        outp[20] = filter(win21);
-        outp[21] = filter(win22);
-        outp[22] = filter(win23);
-        outp[23] = filter(win24);
-        outp[24] = filter(win25);
-        outp[25] = filter(win26);
-        outp[26] = filter(win27);
-        outp[27] = filter(win28);
-        outp[28] = filter(win29);
-        outp[29] = filter(win30);
-        outp[30] = filter(win31);
-        outp[31] = filter(win32);
-        outp[32] = filter(win33);
-        outp[33] = filter(win34);
-        outp[34] = filter(win35);
-        outp[35] = filter(win36);
-        outp[36] = filter(win37);
-        outp[37] = filter(win38);
-        outp[38] = filter(win39);
-        outp[39] = filter(win40);
-        outp[40] = filter(win41);
-        outp[41] = filter(win42);
-        outp[42] = filter(win43);
-        outp[43] = filter(win44);
-        outp[44] = filter(win45);
-        outp[45] = filter(win46);
-        outp[46] = filter(win47);
-        outp[47] = filter(win48);
-        outp[48] = filter(win49);
-        outp[49] = filter(win50);
-        outp[50] = filter(win51);
-        outp[51] = filter(win52);
-        outp[52] = filter(win53);
-        outp[53] = filter(win54);
-        outp[54] = filter(win55);
-        outp[55] = filter(win56);
-        outp[56] = filter(win57);
-        outp[57] = filter(win58);
-        outp[58] = filter(win59);
-        outp[59] = filter(win60);
-        outp[60] = filter(win61);
-        outp[61] = filter(win62);
-        outp[62] = filter(win63);
-        outp[63] = filter(win64);
-        for(int i = 0; i < VECT; i++)
-          out_pixel(i*WIDTH,(i+1)*WIDTH-1) = outp[i];
-        out_s << out_pixel; 
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE; i++){
+        for(j = 0; j < KERNEL_SIZE; j++){
+          int jx = getNewCoords(j,KERNEL_SIZE,GROUP_DELAY,col,width,borderPadding);
+          win[i][j] = win_tmp[i][jx];
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE; i++){
+        for(j = 0; j < KERNEL_SIZE; j++){
+          int ix = getNewCoords(i,KERNEL_SIZE,GROUP_DELAY,row,height,borderPadding);
+          win[i][j] = win[ix][j];
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
+      //**********************************************************
+      // Do the filtering
+      if (row >= GROUP_DELAY && col >= GROUP_DELAY){
+        out_pixel = filter(win);
+        //only retain every factor-th pixel
+        // oh, and start with the first, so that we can hide some delay on the way out :)
+        if(row%factor == mod && col%factor == mod) 
+          out_s.write(out_pixel);
+      }
+    }
+  }
+}
+
+// upsampling
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void upsample(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    const int factor,
+    Filter &filter,
+    const enum BorderPadding::values borderPadding)
+{
+  // TODO fix this
+  #ifdef ASSERTION_CHECK
+    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
+    assert( (KERNEL_SIZE % 2) == 1 );
+  #endif
+
+  IN lineBuff[KERNEL_SIZE-1][MAX_WIDTH];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
+  IN win[KERNEL_SIZE][KERNEL_SIZE];
+  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
+  IN win_tmp[KERNEL_SIZE][KERNEL_SIZE];
+  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
+
+  OUT out_pixel;
+  IN temp_lb, in_pixel;
+  int i, j ,row, col;
+
+  int mod = factor - 1;
+
+  process_main_loop:
+  for (int row = 0; row < height + GROUP_DELAY; row++) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int col = 0; col < width + GROUP_DELAY; col++) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      #pragma HLS INLINE region
+
+      //**********************************************************
+      // GET NEW INPUT
+      //**********************************************************
+      if(col < width && row < height){
+        if(col%factor == mod && row%factor == mod)
+          in_s >> in_pixel;
+        else
+          in_pixel = 0;
+      }
+
+      //**********************************************************
+      // UPDATE THE WINDOW
+      //**********************************************************
+      if (col < width + GROUP_DELAY & row < height + GROUP_DELAY){
+        for(i = 0; i < KERNEL_SIZE; i++){
+        #pragma HLS unroll
+          for(j = 0; j < KERNEL_SIZE-1; j++){
+            win_tmp[i][j] = win_tmp[i][j+1];
+          }
+        }
+      }
+
+      //**********************************************************
+      // UPDATE THE LINE BUFFER
+      //**********************************************************
+      if (col < width & row < height+GROUP_DELAY){
+        LINE_BUFF_1:
+        for(i = 0; i < KERNEL_SIZE-1; i++){
+        #pragma HLS unroll
+          if (i == 0) {
+            win_tmp[i][KERNEL_SIZE-1] = lineBuff[i][col];
+          } else {
+            temp_lb = lineBuff[i][col];
+            win_tmp[i][KERNEL_SIZE-1] = temp_lb;
+            lineBuff[i-1][col] = temp_lb;
+          }
+        }
+        //this is not necessary for the last lines, but it does not hurt and simplifies control
+        if (KERNEL_SIZE > 1) {
+          lineBuff[KERNEL_SIZE-2][col] = in_pixel;
+        }
+        win_tmp[KERNEL_SIZE-1][KERNEL_SIZE-1] = in_pixel;
+      }
+
+      //**********************************************************
+      // HANDLE BORDERS 
+      //**********************************************************
+      // X-DIRECTION
+      for(i = 0; i < KERNEL_SIZE; i++){
+        for(j = 0; j < KERNEL_SIZE; j++){
+          int jx = getNewCoords(j,KERNEL_SIZE,GROUP_DELAY,col,width,borderPadding);
+          win[i][j] = win_tmp[i][jx];
+        }
+      }
+      // Y-DIRECTION
+      for(i = 0; i < KERNEL_SIZE; i++){
+        for(j = 0; j < KERNEL_SIZE; j++){
+          int ix = getNewCoords(i,KERNEL_SIZE,GROUP_DELAY,row,height,borderPadding);
+          win[i][j] = win[ix][j];
+        }
+      }
+
+      //**********************************************************
+      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
+      //**********************************************************
+      // Do the filtering
+      if (row >= GROUP_DELAY && col >= GROUP_DELAY){
+        out_pixel = filter(win, col, row); 
+        out_s.write(out_pixel);
+      }
+    }
+  }
+}
+
+
+// Resampling of streams between adjacent pyramid levels, inserted by the
+// compiler for accessors reading another level than the one iterated, see
+// HostDataDeps::resampleSpace. Pixels are mapped as by the interpolation of the
+// other back ends: nearest neighbor reads pixel scale*x, linear filtering
+// weights the four pixels around scale*x - 0.5. Frame sizes have to be even.
+inline void getLinearTaps(
+    const int pos,
+    const float scale,
+    const int size,
+    int &idx0,
+    int &idx1,
+    float &frac)
+{
+  #pragma HLS INLINE
+  const float mapped = scale * pos - 0.5f;
+  const int idx = mapped;
+  frac = mapped - idx;
+  idx0 = MIN(MAX(idx, 0), size-1);
+  idx1 = MIN(MAX(idx+1, 0), size-1);
+}
+
+template<typename T>
+T interpolateLinear(const T a, const T b, const T c, const T d, const float fx, const float fy)
+{
+  #pragma HLS INLINE
+  return (1.0f-fx) * (1.0f-fy) * a + fx * (1.0f-fy) * b +
+         (1.0f-fx) * fy * c + fx * fy * d;
+}
+
+// downsampling to the next level, width and height are the input size
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, bool LINEAR, typename T>
+void downsampleStream(
+    hls::stream<T> &in_s,
+    hls::stream<T> &out_s,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+  assert(width % 2 == 0); assert(height % 2 == 0);
+
+  // current and previous row
+  T lineBuff[2][MAX_WIDTH];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
+
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int x = 0; x < width; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      const T pixel = in_s.read();
+      lineBuff[y%2][x] = pixel;
+
+      if (!LINEAR) {
+        if (y%2 == 0 && x%2 == 0)
+          out_s << pixel;
+      } else if ((y == 1 || (y > 1 && y%2 == 0)) &&
+                 (x == 1 || (x > 1 && x%2 == 0))) {
+        // all four pixels have been read, the lower right one just now
+        int x0, x1, y0, y1;
+        float fx, fy;
+        getLinearTaps(x/2, 2.0f, width, x0, x1, fx);
+        getLinearTaps(y/2, 2.0f, height, y0, y1, fy);
+        out_s << interpolateLinear(lineBuff[y0%2][x0], lineBuff[y0%2][x1],
+                                   lineBuff[y1%2][x0], lineBuff[y1%2][x1],
+                                   fx, fy);
+      }
+    }
+  }
+}
+
+// upsampling to the previous level, width and height are the output size.
+// Each input row is read while emitting two output rows, linear filtering
+// emits the rows two input rows later.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, bool LINEAR, typename T>
+void upsampleStream(
+    hls::stream<T> &in_s,
+    hls::stream<T> &out_s,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+  assert(width % 2 == 0); assert(height % 2 == 0);
+
+  const int in_width = width/2;
+  const int in_height = height/2;
+  const int delay = LINEAR ? 2 : 0;
+
+  // rows emitted from and the row currently read
+  T lineBuff[4][MAX_WIDTH/2];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
+
+  for (int r = 0; r < in_height + delay; ++r) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT/2)
+    for (int sub = 0; sub < 2; ++sub) {
+      for (int x = 0; x < width; ++x) {
+        PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH)
+        PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+        if (r < in_height && sub == 0 && x%2 == 0)
+          lineBuff[r%4][x/2] = in_s.read();
+
+        const int y = 2*(r-delay) + sub;
+        if (y < 0)
+          continue;
+
+        if (!LINEAR) {
+          out_s << lineBuff[(y/2)%4][x/2];
+        } else {
+          int x0, x1, y0, y1;
+          float fx, fy;
+          getLinearTaps(x, 0.5f, in_width, x0, x1, fx);
+          getLinearTaps(y, 0.5f, in_height, y0, y1, fy);
+          out_s << interpolateLinear(lineBuff[y0%4][x0], lineBuff[y0%4][x1],
+                                     lineBuff[y1%4][x0], lineBuff[y1%4][x1],
+                                     fx, fy);
+        }
       }
     }
   }
@@ -3436,12 +2982,11 @@ void processVECT64(
 
 
 //*********************************************************************************************************************
-// POINT VECTOR OPERATORS
-// currently only supports factor 2
+// POINT OPERATORS
 //*********************************************************************************************************************
-
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
-void processPixelsVECT(
+// 1:1
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
+void processPixels(
     hls::stream<IN> &in_s,
     hls::stream<OUT> &out_s,
     const int &width,
@@ -3451,26 +2996,17 @@ void processPixelsVECT(
   assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
   for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+    for (int x = 0; x < width + GDELAY_X; ++x) {
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       if (x >= width)
         continue;
       const IN val = in_s.read();
-      INT_I temp_i[VECT];
-      INT_O temp_o[VECT]; 
-      OUT out_val;
-      for(int i = 0; i < VECT; i++){
-        #pragma HLS unroll
-        temp_i[i] = val(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp_o[i] = filter(temp_i[i]);
-        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
-      }
-      out_s << out_val;
+      out_s << filter(val);
     }
 }
 // 2:1
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
-void processPixels2VECT(
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
+void processPixels2(
     hls::stream<IN> &in1_s,
     hls::stream<IN> &in2_s,
     hls::stream<OUT> &out_s,
@@ -3481,29 +3017,18 @@ void processPixels2VECT(
   assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
   for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+    for (int x = 0; x < width + GDELAY_X; ++x) {
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       if (x >= width)
         continue;
       const IN val1 = in1_s.read();
       const IN val2 = in2_s.read();
-      INT_I temp1_i[VECT];
-      INT_I temp2_i[VECT];
-      INT_O temp_o[VECT]; 
-      OUT out_val;
-      for(int i = 0; i < VECT; i++){
-        #pragma HLS unroll
-        temp1_i[i] = val1(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp2_i[i] = val2(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp_o[i] = filter(temp1_i[i], temp2_i[i]);
-        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
-      }
-      out_s << out_val;
+      out_s.write(filter(val1, val2));
     }
 }
 // 3:1
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT_I, typename INT_O, typename IN, typename OUT, class Filter>
-void processPixels3VECT(
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
+void processPixels3(
     hls::stream<IN> &in1_s,
     hls::stream<IN> &in2_s,
     hls::stream<IN> &in3_s,
@@ -3515,1613 +3040,656 @@ void processPixels3VECT(
   assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
   for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GROUP_DELAY; ++x) {
+    for (int x = 0; x < width + GDELAY_X; ++x) {
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       if (x >= width)
         continue;
       const IN val1 = in1_s.read();
       const IN val2 = in2_s.read();
       const IN val3 = in3_s.read();
-      INT_I temp1_i[VECT];
-      INT_I temp2_i[VECT];
-      INT_I temp3_i[VECT];
-      INT_O temp_o[VECT]; 
-      OUT out_val;
-      for(int i = 0; i < VECT; i++){
-        #pragma HLS unroll
-        temp1_i[i] = val1(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp2_i[i] = val2(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp3_i[i] = val3(i*INT_I_WIDTH,(i+1)*INT_I_WIDTH-1);
-        temp_o[i] = filter(temp1_i[i], temp2_i[i], temp3_i[i]);
-        out_val(i*INT_O_WIDTH,(i+1)*INT_O_WIDTH-1) = temp_o[i];
-      }
-      out_s << out_val;
+      out_s.write(filter(val1, val2, val3));
     }
 }
 
+// N:M with the pixels read from the RAW input streams mapped to the NUM_IN
+// filter inputs, see processMappedMIMO
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int NUM_OUT, int NUM_IN, typename RAW, typename IN, typename OUT, class Map, class Filter, typename... Streams>
+void processPixelsMappedMIMO(
+    const int &width,
+    const int &height,
+    Map &map,
+    Filter &filter,
+    Streams&... streams)
+{
+  enum { NUM_RAW = sizeof...(Streams) - NUM_OUT };
 
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-//*********************************************************************************************************************
-//PYRAMID VECTOR OPERATORS 
-// currently only supports factor 2
-//*********************************************************************************************************************
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT>
-void downsampleVECT(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
+  RAW raw_pixel[NUM_RAW];
+  #pragma HLS ARRAY_PARTITION variable=raw_pixel complete
+  IN in_pixel[NUM_IN];
+  #pragma HLS ARRAY_PARTITION variable=in_pixel complete
+  OUT out_pixel;
+
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GDELAY_X; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
+      transferStreams<0,NUM_OUT>(raw_pixel, out_pixel, true, false, streams...);
+      map(raw_pixel, in_pixel);
+      out_pixel = applyFilter<OUT>(filter, in_pixel, typename MakeIndexSeq<NUM_IN>::type());
+      transferStreams<0,NUM_OUT>(raw_pixel, out_pixel, false, true, streams...);
+    }
+}
+
+// N:M, the stream arguments are the NUM_OUT output streams followed by the
+// input streams
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int NUM_OUT, typename IN, typename OUT, class Filter, typename... Streams>
+void processPixelsMIMO(
     const int &width,
-    const int &height)
+    const int &height,
+    Filter &filter,
+    Streams&... streams)
 {
-  assert( width <= MAX_WIDTH); assert( height <= MAX_HEIGHT);
-  
-  IN in_pixel, out_pixel; 
+  InputIdentity map;
+  processPixelsMappedMIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,NUM_OUT,sizeof...(Streams)-NUM_OUT,IN,IN,OUT>(width, height, map, filter, streams...);
+}
 
-  int row, col, i;
+// streaming reduction of a frame at one pixel per II_TARGET cycles: pixel i
+// is reduced into partial result i%LATENCY, so that consecutive calls of the
+// reduce function are independent as long as its latency does not exceed
+// LATENCY. The partial results are combined in a tree at the end of the frame.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int LATENCY, typename T, class Reduce>
+void processReduce(
+    hls::stream<T> &in_s,
+    T &result,
+    const int &width,
+    const int &height,
+    Reduce &reduce)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  T partial[LATENCY];
+  #pragma HLS ARRAY_PARTITION variable=partial complete
+  int slot = 0;
+  bool first = true;
+
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x) {
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-        if(col%2 == 0 && row%2==0){
-          for(i = 0; i < VECT/2; i++)
-            out_pixel(i*WIDTH,(i+1)*WIDTH-1) = in_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1);
-        }else{
-          for(i = 0; i < VECT/2; i++)
-            out_pixel((i+VECT/2)*WIDTH,(i+VECT/2+1)*WIDTH-1) = in_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1);
-          out_s << out_pixel;
-        }
+      PRAGMA_HLS(HLS dependence variable=partial inter distance=LATENCY true)
+      const T pixel = in_s.read();
+      partial[slot] = first ? pixel : reduce(partial[slot], pixel);
+      if (slot == LATENCY-1) {
+        slot = 0;
+        first = false;
+      } else {
+        ++slot;
+      }
+    }
+
+  // only the first width*height partial results are valid for small frames
+  const int valid = width*height;
+  for (int stride = 1; stride < LATENCY; stride *= 2) {
+    #pragma HLS unroll
+    for (int i = 0; i + stride < LATENCY; i += 2*stride) {
+      #pragma HLS unroll
+      if (i + stride < valid) {
+        partial[i] = reduce(partial[i], partial[i + stride]);
       }
     }
   }
+  result = partial[0];
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT>
-void upsampleVECT(
-    hls::stream<IN> &in_s, 
-    hls::stream<OUT> &out_s,
+// streaming histogram of a frame at one pixel per II_TARGET cycles: pixel i is
+// counted in bank i%BANKS, so that the read-modify-write of a bin is separated
+// by BANKS cycles. Each bank holds the count of the bin it hit last in a
+// register, runs of pixels falling into the same bin are forwarded from there
+// without accessing the BRAM. The banks are summed up at the end of the frame.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int BANKS, int NUM_BINS, typename T, class Binning>
+void processBinning(
+    hls::stream<T> &in_s,
+    uint bins[NUM_BINS],
     const int &width,
-    const int &height)
+    const int &height,
+    Binning &binning)
 {
-  assert( width <= MAX_WIDTH); assert( height <= MAX_HEIGHT);
-  
-  IN in_pixel, out_pixel; 
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-  int row, col, i;
+  uint hist[BANKS][NUM_BINS];
+  #pragma HLS ARRAY_PARTITION variable=hist complete dim=1
+  uint last[BANKS];
+  uint count[BANKS];
+  #pragma HLS ARRAY_PARTITION variable=last complete
+  #pragma HLS ARRAY_PARTITION variable=count complete
+
+  for (int i = 0; i < NUM_BINS; ++i) {
+    PRAGMA_HLS(HLS pipeline ii=1)
+    for (int b = 0; b < BANKS; ++b) {
+      #pragma HLS unroll
+      hist[b][i] = 0;
+    }
+  }
+  for (int b = 0; b < BANKS; ++b) {
+    #pragma HLS unroll
+    last[b] = NUM_BINS;
+    count[b] = 0;
+  }
 
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GROUP_DELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0; col < MAX_WIDTH+GROUP_DELAY_X; ++col){
+  int bank = 0;
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x) {
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        out_pixel = 0;
-        if(col%2 == 0 && row%2==0){
-          in_s >> in_pixel;  
-          for(i = 0; i < VECT/2; i++)
-             out_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1) = in_pixel(i*WIDTH,(i+1)*WIDTH-1);
-        }else{
-          for(i = 0; i < VECT/2; i++)
-             out_pixel((i*2)*WIDTH,((i*2)+1)*WIDTH-1) = in_pixel((i+VECT/2)*WIDTH,(i+VECT/2+1)*WIDTH-1);
+      PRAGMA_HLS(HLS dependence variable=hist inter distance=BANKS true)
+      const T pixel = in_s.read();
+      const uint bin = binning(pixel, NUM_BINS);
+      if (bin < NUM_BINS) {
+        if (bin == last[bank]) {
+          // read-after-write forwarding
+          ++count[bank];
+        } else {
+          if (last[bank] < NUM_BINS) {
+            hist[bank][last[bank]] = count[bank];
+          }
+          count[bank] = hist[bank][bin] + 1;
+          last[bank] = bin;
         }
-        out_s << in_pixel;
       }
+      bank = (bank == BANKS-1) ? 0 : bank+1;
+    }
+
+  for (int b = 0; b < BANKS; ++b) {
+    #pragma HLS unroll
+    if (last[b] < NUM_BINS) {
+      hist[b][last[b]] = count[b];
     }
   }
+  for (int i = 0; i < NUM_BINS; ++i) {
+    PRAGMA_HLS(HLS pipeline ii=1)
+    uint sum = 0;
+    for (int b = 0; b < BANKS; ++b) {
+      #pragma HLS unroll
+      sum += hist[b][i];
+    }
+    bins[i] = sum;
+  }
 }
 
-//*********************************************************************************************************************
-// LOCAL OPERATORS
-//*********************************************************************************************************************
-// normal processing, one input, one output stream
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void process(
+//1:2
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT1, typename OUT2>
+void splitStream(
     hls::stream<IN> &in_s,
-    hls::stream<OUT> &out_s,
+    hls::stream<OUT1> &out1_s,
+    hls::stream<OUT2> &out2_s,
     const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    const int &height)
 {
-  // TODO fix this
-  #ifdef ASSERTION_CHECK
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert( (KERNEL_SIZE_X % 2) == 1 );
-    assert( (KERNEL_SIZE_Y % 2) == 1 );
-  #endif
-
-  IN lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-  OUT out_pixel;
-  IN temp_lb, in_pixel;
-  int i, j ,row, col;
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GDELAY_X; ++x) {
+PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
 
-  process_main_loop:
-  for (int row = 0; row < MAX_HEIGHT + GDELAY_Y; row++) {
-    for (int col = 0; col < MAX_WIDTH + GDELAY_X; col++) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
+      const IN val = in_s.read();
 
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
+      out1_s << val;
+      out2_s << val;
+    }
+}
 
-      //**********************************************************
-      // UPDATE THE WINDOW
-      //**********************************************************
-      if (col < width + GDELAY_X & row < height + GDELAY_Y){
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      }
+// 1:3
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT>
+void splitStream3(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out1_s,
+    hls::stream<OUT> &out2_s,
+    hls::stream<OUT> &out3_s,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-      //**********************************************************
-      // UPDATE THE LINE BUFFER
-      //**********************************************************
-      if (col < width & row < height+GDELAY_Y){
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X-1] = lineBuff[i][col];
-          } else {
-            temp_lb = lineBuff[i][col];
-            win_tmp[i][KERNEL_SIZE_X-1] = temp_lb;
-            lineBuff[i-1][col] = temp_lb;
-          }
-        }
-        //this is not necessary for the last lines, but it does not hurt and simplifies control
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][col] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel;
-      }
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GDELAY_X; ++x) {
+PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
 
-      //**********************************************************
-      // HANDLE BORDERS 
-      //**********************************************************
-      // X-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int jx = getNewCoords(j,KERNEL_SIZE_X,GDELAY_X,col,width,borderPadding);
-          win[i][j] = win_tmp[i][jx];
-        }
-      }
-      // Y-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int ix = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-          win[i][j] = win[ix][j];
-        }
-      }
+      const IN val = in_s.read();
 
-      //**********************************************************
-      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
-      //**********************************************************
-      // Do the filtering
-      if (row >= GDELAY_Y && col >= GDELAY_X){
-        out_pixel = filter(win);
-        out_s.write(out_pixel);
-      }
+      out1_s << val;
+      out2_s << val;
+      out3_s << val;
     }
-  }
 }
 
-// process one input stream, put result into two output streams
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void processSIMO(
-                 hls::stream<IN> &in_s,
-                 hls::stream<OUT> &out1_s,
-                 hls::stream<OUT> &out2_s,
-                 const int &width,
-                 const int &height,
-                 Filter &filter,
-                 const enum BorderPadding::values borderPadding)
+//1:4
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT>
+void splitStream4(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out1_s,
+    hls::stream<OUT> &out2_s,
+    hls::stream<OUT> &out3_s,
+    hls::stream<OUT> &out4_s,
+    const int &width,
+    const int &height)
 {
-#ifdef ASSERTION_CHECK
-  assert( width <= MAX_WIDTH ); assert(height <= MAX_HEIGHT);
-  assert( (KERNEL_SIZE_X % 2) == 1 );
-  assert( (KERNEL_SIZE_Y % 2) == 1 );
-#endif
-  
-  IN lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-  
-  OUT out_pixel;
-  IN temp_lb, in_pixel;
-  int i, j ,row, col;
-  
-  ROW_LOOP:
-  for (int row = 0; row < MAX_HEIGHT + GDELAY_Y; row++) {
-    COL_LOOP:
-    for (int col = 0; col < MAX_WIDTH + GDELAY_X; col++) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-    
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
-      
-      //**********************************************************
-      // UPDATE THE WINDOW
-      //**********************************************************
-      if (col < width + GDELAY_X & row < height + GDELAY_Y){
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      }
-      
-      //**********************************************************
-      // UPDATE THE LINE BUFFER
-      //**********************************************************
-      if (col < width & row < height+GDELAY_Y){
-      LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X-1] = lineBuff[i][col];
-          } else {
-            temp_lb = lineBuff[i][col];
-            win_tmp[i][KERNEL_SIZE_X-1] = temp_lb;
-            lineBuff[i-1][col] = temp_lb;
-          }
-        }
-        //this is not necessary for the last lines, but it does not hurt and simplifies control
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][col] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel;
-      }
-      
-      //**********************************************************
-      // HANDLE BORDERS
-      //**********************************************************
-      // X-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int jx = getNewCoords(j,KERNEL_SIZE_X,GDELAY_X,col,width,borderPadding);
-          win[i][j] = win_tmp[i][jx];
-        }
-      }
-      // Y-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int ix = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-          win[i][j] = win[ix][j];
-        }
-      }
-      
-      //**********************************************************
-      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
-      //**********************************************************
-      // Do the filtering
-      if (row >= GDELAY_Y && col >= GDELAY_X){
-        out_pixel = filter(win);
-        out1_s.write(out_pixel);
-        out2_s.write(out_pixel);
-      }
-    }
-  }
-}
-
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void processMISO(
-    hls::stream<IN> &in1_s,
-    hls::stream<IN> &in2_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  #ifdef ASSERTION_CHECK
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert( (KERNEL_SIZE_X % 2) == 1 );
-    assert( (KERNEL_SIZE_Y % 2) == 1 );
-  #endif
-
-  IN lineBuff1[KERNEL_SIZE_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff1 dim=1 complete
-  IN win1[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  IN win1_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win1_tmp dim=0 complete
-
-  IN lineBuff2[KERNEL_SIZE_Y-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff2 dim=1 complete
-  IN win2[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  IN win2_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-  #pragma HLS ARRAY_PARTITION variable=win2_tmp dim=0 complete
-
-  OUT out_pixel;
-  IN temp_lb2, in_pixel2;
-  IN temp_lb1, in_pixel1;
-
-  int i, j ,row, col;
-
-  process_main_loop:
-  for (int row = 0; row < MAX_HEIGHT + GDELAY_Y; row++) {
-    for (int col = 0; col < MAX_WIDTH + GDELAY_X; col++) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in1_s >> in_pixel1;
-        in2_s >> in_pixel2;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      //**********************************************************
-      if (col < width + GDELAY_X & row < height + GDELAY_Y){
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X-1; j++){
-            win1_tmp[i][j] = win1_tmp[i][j+1];
-            win2_tmp[i][j] = win2_tmp[i][j+1];
-          }
-        }
-      }
-
-      //**********************************************************
-      // UPDATE THE LINE BUFFER
-      //**********************************************************
-      if (col < width & row < height+GDELAY_Y){
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win1_tmp[i][KERNEL_SIZE_X-1] = lineBuff1[i][col];
-            win2_tmp[i][KERNEL_SIZE_X-1] = lineBuff2[i][col];
-          } else {
-            temp_lb1 = lineBuff1[i][col];
-            temp_lb2 = lineBuff2[i][col];
-            win1_tmp[i][KERNEL_SIZE_X-1] = temp_lb1;
-            win2_tmp[i][KERNEL_SIZE_X-1] = temp_lb2;
-            lineBuff1[i-1][col] = temp_lb1;
-            lineBuff2[i-1][col] = temp_lb2;
-          }
-        }
-        //this is not necessary for the last lines, but it does not hurt and simplifies control
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff1[KERNEL_SIZE_Y-2][col] = in_pixel1;
-          lineBuff2[KERNEL_SIZE_Y-2][col] = in_pixel2;
-        }
-        win1_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel1;
-        win2_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X-1] = in_pixel2;
-      }
-
-      //**********************************************************
-      // HANDLE BORDERS
-      //**********************************************************
-      // X-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int jx = getNewCoords(j,KERNEL_SIZE_X,GDELAY_X,col,width,borderPadding);
-          win1[i][j] = win1_tmp[i][jx];
-          win2[i][j] = win2_tmp[i][jx];
-        }
-      }
-      // Y-DIRECTION
-      for(i = 0; i < KERNEL_SIZE_Y; i++){
-        for(j = 0; j < KERNEL_SIZE_X; j++){
-          int ix = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-          win1[i][j] = win1[ix][j];
-          win2[i][j] = win2[ix][j];
-        }
-      }
-
-      //**********************************************************
-      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT
-      //**********************************************************
-      // Do the filtering
-      if (row >= GDELAY_Y && col >= GDELAY_X){
-        out_pixel = filter(win1, win2);
-        out_s.write(out_pixel);
-      }
-    }
-  }
-}
-
-//*********************************************************************************************************************
-// PYRAMID OPERATORS
-//*********************************************************************************************************************
-// downsampling
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void downsample(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    const int &factor,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  #ifdef ASSERTION_CHECK
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert( (KERNEL_SIZE % 2) == 1 );
-  #endif
-
-  IN lineBuff[KERNEL_SIZE-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  OUT out_pixel;
-  IN temp_lb, in_pixel;
-  int i, j ,row, col;
-
-  int mod = GROUP_DELAY%2;
-
-  process_main_loop:
-  for (int row = 0; row < MAX_HEIGHT + GROUP_DELAY; row++) {
-    for (int col = 0; col < MAX_WIDTH + GROUP_DELAY; col++) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      //**********************************************************
-      if (col < width + GROUP_DELAY & row < height + GROUP_DELAY){
-        for(i = 0; i < KERNEL_SIZE; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      }
-
-      //**********************************************************
-      // UPDATE THE LINE BUFFER
-      //**********************************************************
-      if (col < width & row < height+GROUP_DELAY){
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE-1] = lineBuff[i][col];
-          } else {
-            temp_lb = lineBuff[i][col];
-            win_tmp[i][KERNEL_SIZE-1] = temp_lb;
-            lineBuff[i-1][col] = temp_lb;
-          }
-        }
-        //this is not necessary for the last lines, but it does not hurt and simplifies control
-        if (KERNEL_SIZE > 1) {
-          lineBuff[KERNEL_SIZE-2][col] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE-1][KERNEL_SIZE-1] = in_pixel;
-      }
-
-      //**********************************************************
-      // HANDLE BORDERS 
-      //**********************************************************
-      // X-DIRECTION
-      for(i = 0; i < KERNEL_SIZE; i++){
-        for(j = 0; j < KERNEL_SIZE; j++){
-          int jx = getNewCoords(j,KERNEL_SIZE,GROUP_DELAY,col,width,borderPadding);
-          win[i][j] = win_tmp[i][jx];
-        }
-      }
-      // Y-DIRECTION
-      for(i = 0; i < KERNEL_SIZE; i++){
-        for(j = 0; j < KERNEL_SIZE; j++){
-          int ix = getNewCoords(i,KERNEL_SIZE,GROUP_DELAY,row,height,borderPadding);
-          win[i][j] = win[ix][j];
-        }
-      }
-
-      //**********************************************************
-      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
-      //**********************************************************
-      // Do the filtering
-      if (row >= GROUP_DELAY && col >= GROUP_DELAY){
-        out_pixel = filter(win);
-        //only retain every factor-th pixel
-        // oh, and start with the first, so that we can hide some delay on the way out :)
-        if(row%factor == mod && col%factor == mod) 
-          out_s.write(out_pixel);
-      }
-    }
-  }
-}
-
-// upsampling
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void upsample(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    const int factor,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  #ifdef ASSERTION_CHECK
-    assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-    assert( (KERNEL_SIZE % 2) == 1 );
-  #endif
-
-  IN lineBuff[KERNEL_SIZE-1][MAX_WIDTH];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  IN win[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  IN win_tmp[KERNEL_SIZE][KERNEL_SIZE];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  OUT out_pixel;
-  IN temp_lb, in_pixel;
-  int i, j ,row, col;
-
-  int mod = factor - 1;
-
-  process_main_loop:
-  for (int row = 0; row < MAX_HEIGHT + GROUP_DELAY; row++) {
-    for (int col = 0; col < MAX_WIDTH + GROUP_DELAY; col++) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width && row < height){
-        if(col%factor == mod && row%factor == mod)
-          in_s >> in_pixel;
-        else
-          in_pixel = 0;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      //**********************************************************
-      if (col < width + GROUP_DELAY & row < height + GROUP_DELAY){
-        for(i = 0; i < KERNEL_SIZE; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-      }
-
-      //**********************************************************
-      // UPDATE THE LINE BUFFER
-      //**********************************************************
-      if (col < width & row < height+GROUP_DELAY){
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE-1] = lineBuff[i][col];
-          } else {
-            temp_lb = lineBuff[i][col];
-            win_tmp[i][KERNEL_SIZE-1] = temp_lb;
-            lineBuff[i-1][col] = temp_lb;
-          }
-        }
-        //this is not necessary for the last lines, but it does not hurt and simplifies control
-        if (KERNEL_SIZE > 1) {
-          lineBuff[KERNEL_SIZE-2][col] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE-1][KERNEL_SIZE-1] = in_pixel;
-      }
-
-      //**********************************************************
-      // HANDLE BORDERS 
-      //**********************************************************
-      // X-DIRECTION
-      for(i = 0; i < KERNEL_SIZE; i++){
-        for(j = 0; j < KERNEL_SIZE; j++){
-          int jx = getNewCoords(j,KERNEL_SIZE,GROUP_DELAY,col,width,borderPadding);
-          win[i][j] = win_tmp[i][jx];
-        }
-      }
-      // Y-DIRECTION
-      for(i = 0; i < KERNEL_SIZE; i++){
-        for(j = 0; j < KERNEL_SIZE; j++){
-          int ix = getNewCoords(i,KERNEL_SIZE,GROUP_DELAY,row,height,borderPadding);
-          win[i][j] = win[ix][j];
-        }
-      }
-
-      //**********************************************************
-      // FILTER COMPUTATION AND OUTPUT ASSIGNMENT 
-      //**********************************************************
-      // Do the filtering
-      if (row >= GROUP_DELAY && col >= GROUP_DELAY){
-        out_pixel = filter(win, col, row); 
-        out_s.write(out_pixel);
-      }
-    }
-  }
-}
-
-
-//*********************************************************************************************************************
-// POINT OPERATORS
-//*********************************************************************************************************************
-// 1:1
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void processPixels(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-      const IN val = in_s.read();
-      out_s << filter(val);
-    }
-}
-// 2:1
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void processPixels2(
-    hls::stream<IN> &in1_s,
-    hls::stream<IN> &in2_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-      const IN val1 = in1_s.read();
-      const IN val2 = in2_s.read();
-      out_s.write(filter(val1, val2));
-    }
-}
-// 3:1
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT, class Filter>
-void processPixels3(
-    hls::stream<IN> &in1_s,
-    hls::stream<IN> &in2_s,
-    hls::stream<IN> &in3_s,
-    hls::stream<OUT> &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-      const IN val1 = in1_s.read();
-      const IN val2 = in2_s.read();
-      const IN val3 = in3_s.read();
-      out_s.write(filter(val1, val2, val3));
-    }
-}
-
-//1:2
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT1, typename OUT2>
-void splitStream(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT1> &out1_s,
-    hls::stream<OUT2> &out2_s,
-    const int &width,
-    const int &height)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-
-      const IN val = in_s.read();
-
-      out1_s << val;
-      out2_s << val;
-    }
-}
-
-// 1:3
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT>
-void splitStream3(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT> &out1_s,
-    hls::stream<OUT> &out2_s,
-    hls::stream<OUT> &out3_s,
-    const int &width,
-    const int &height)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-
-      const IN val = in_s.read();
-
-      out1_s << val;
-      out2_s << val;
-      out3_s << val;
-    }
-}
-
-//1:4
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, typename IN, typename OUT>
-void splitStream4(
-    hls::stream<IN> &in_s,
-    hls::stream<OUT> &out1_s,
-    hls::stream<OUT> &out2_s,
-    hls::stream<OUT> &out3_s,
-    hls::stream<OUT> &out4_s,
-    const int &width,
-    const int &height)
-{
-  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
-
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width + GDELAY_X; ++x) {
-		PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      if (x >= width)
-        continue;
-
-      const IN val = in_s.read();
-
-      out1_s << val;
-      out2_s << val;
-      out3_s << val;
-      out4_s << val;
-    }
-}
-
-//*********************************************************************************************************************
-// LEGACY (QUADRATIC KERNEL SIZE)
-//*********************************************************************************************************************
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void process(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
-  process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void processSIMO(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
-  processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void processMISO(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
-  processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in1_s, in2_s, out_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void processPixels(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
-  processPixels<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void processPixels2(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
-  processPixels2<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in1_s, in2_s, out_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
-void processPixels3(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<IN> &in3_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
-  processPixels3<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in1_s, in2_s, in3_s, out_s, width, height, filter);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT1, typename OUT2>
-void splitStream(hls::stream<IN> &in_s, hls::stream<OUT1> &out1_s, hls::stream<OUT2> &out2_s, const int &width, const int &height) {
-  splitStream<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, width, height);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT>
-void splitStream3(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, hls::stream<OUT> &out3_s, const int &width, const int &height) {
-  splitStream3<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, out3_s, width, height);
-}
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT>
-void splitStream4(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, hls::stream<OUT> &out3_s, hls::stream<OUT> &out4_s, const int &width, const int &height) {
-  splitStream4<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, out3_s, out4_s, width, height);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-// Oliver's VECT alternatives:
-//   - processVECT
-//   - processVECTF
-//   - processSIMOVECT
-//   - processSIMOVECTF
-//   - processMISOVECT
-//   - processMISOVECTF
-//   - processPixelsVECT
-//   - processPixelsVECTF
-//   - processPixels2VECT
-//   - processPixels2VECTF
-//   - processPixels3VECT
-//   - processPixels3VECTF
-//   - splitStreamVECT
-//   - splitStream3VECT
-//   - splitStream4VECT
-////////////////////////////////////////////////////////////////////////////////
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processVECT(
-    hls::stream<ap_uint<BW_IN> > &in_s,
-    hls::stream<ap_uint<BW_OUT> > &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-
-  ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  ap_uint<BW_IN> win[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  ap_uint<BW_IN> win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  INT win_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win_vect dim=0 complete
-
-  ap_uint<BW_IN> in_pixel, temp_lb;
-  ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
-
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff[i][colv];
-          } else {
-            temp_lb = lineBuff[i][colv];
-            win_tmp[i][KERNEL_SIZE_X_V-1] = temp_lb;
-            lineBuff[i-1][colv] = temp_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][colv] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in_pixel;
-
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win[i][j] = win_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win[i][j] = win[iy][j];
-          }
-        }
-
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][j] = win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][KERNEL_SIZE_X+v] = win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-      }
-
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
-      {
-        for (int v = 0; v < VECT; v++) {
-          INT win_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win_small[i][j] = win_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = filter(win_small);
-        }
-        out_s << out_pixel;
-      }
-    }
-  }
-}
-
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processVECTF(
-    hls::stream<ap_uint<BW_IN> > &in_s,
-    hls::stream<ap_uint<BW_OUT> > &out_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-
-  ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  ap_uint<BW_IN> win[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  ap_uint<BW_IN> win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  INT win_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win_vect dim=0 complete
-
-  ap_uint<BW_IN> in_pixel, temp_lb;
-  ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
-
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff[i][colv];
-          } else {
-            temp_lb = lineBuff[i][colv];
-            win_tmp[i][KERNEL_SIZE_X_V-1] = temp_lb;
-            lineBuff[i-1][colv] = temp_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][colv] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in_pixel;
-
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win[i][j] = win_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win[i][j] = win[iy][j];
-          }
-        }
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
 
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][j] = i2f(win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width + GDELAY_X; ++x) {
+		PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      if (x >= width)
+        continue;
 
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][KERNEL_SIZE_X+v] = i2f(win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
-      }
+      const IN val = in_s.read();
 
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
-      {
-        for (int v = 0; v < VECT; v++) {
-          INT win_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win_small[i][j] = win_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = f2i(filter(win_small));
-        }
-        out_s << out_pixel;
-      }
+      out1_s << val;
+      out2_s << val;
+      out3_s << val;
+      out4_s << val;
     }
-  }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processSIMOVECT(
-    hls::stream<ap_uint<BW_IN> > &in_s,
-    hls::stream<ap_uint<BW_OUT> > &out1_s,
-    hls::stream<ap_uint<BW_OUT> > &out2_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-
-  ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  ap_uint<BW_IN> win[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  ap_uint<BW_IN> win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  INT win_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win_vect dim=0 complete
-
-  ap_uint<BW_IN> in_pixel, temp_lb;
-  ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
-
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
-
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
-
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff[i][colv];
-          } else {
-            temp_lb = lineBuff[i][colv];
-            win_tmp[i][KERNEL_SIZE_X_V-1] = temp_lb;
-            lineBuff[i-1][colv] = temp_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][colv] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in_pixel;
-
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win[i][j] = win_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win[i][j] = win[iy][j];
-          }
-        }
-
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][j] = win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][KERNEL_SIZE_X+v] = win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-      }
-
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
-      {
-        for (int v = 0; v < VECT; v++) {
-          INT win_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win_small[i][j] = win_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = filter(win_small);
-        }
-        out1_s << out_pixel;
-        out2_s << out_pixel;
-      }
-    }
+//*********************************************************************************************************************
+// LEGACY (QUADRATIC KERNEL SIZE)
+//*********************************************************************************************************************
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void process(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      process<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED>(in_s, out_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
   }
 }
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void processSIMO(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST>(in_s, out1_s, out2_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP>(in_s, out1_s, out2_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR>(in_s, out1_s, out2_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101>(in_s, out1_s, out2_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      processSIMO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED>(in_s, out1_s, out2_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
+  }
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void processMISO(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      processMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
+  }
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void processPixels(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
+  processPixels<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out_s, width, height, filter);
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void processPixels2(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
+  processPixels2<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in1_s, in2_s, out_s, width, height, filter);
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT, class Filter>
+void processPixels3(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<IN> &in3_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter) {
+  processPixels3<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in1_s, in2_s, in3_s, out_s, width, height, filter);
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT1, typename OUT2>
+void splitStream(hls::stream<IN> &in_s, hls::stream<OUT1> &out1_s, hls::stream<OUT2> &out2_s, const int &width, const int &height) {
+  splitStream<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, width, height);
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT>
+void splitStream3(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, hls::stream<OUT> &out3_s, const int &width, const int &height) {
+  splitStream3<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, out3_s, width, height);
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, typename IN, typename OUT>
+void splitStream4(hls::stream<IN> &in_s, hls::stream<OUT> &out1_s, hls::stream<OUT> &out2_s, hls::stream<OUT> &out3_s, hls::stream<OUT> &out4_s, const int &width, const int &height) {
+  splitStream4<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE>(in_s, out1_s, out2_s, out3_s, out4_s, width, height);
+}
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processSIMOVECTF(
-    hls::stream<ap_uint<BW_IN> > &in_s,
-    hls::stream<ap_uint<BW_OUT> > &out1_s,
-    hls::stream<ap_uint<BW_OUT> > &out2_s,
-    const int &width,
-    const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
-{
-  // TODO fix this
-  assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
-
-  ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
-  ap_uint<BW_IN> win[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
-  ap_uint<BW_IN> win_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win_tmp dim=0 complete
-
-  INT win_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win_vect dim=0 complete
-
-  ap_uint<BW_IN> in_pixel, temp_lb;
-  ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
-
-  IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
-    IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
-      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
-      #pragma HLS INLINE region
-      //**********************************************************
-      // GET NEW INPUT
-      //**********************************************************
-      if(col < width & row < height){
-        in_s >> in_pixel;
-      }
+// vectorized processing for any vectorization factor VECT, IN and OUT are
+// ap_uint vectors holding VECT pixels
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
+void processVECT(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      processVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      processVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      processVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      processVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      processVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
+  }
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
+void processVECTF(hls::stream<IN> &in_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      processVECTF<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      processVECTF<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      processVECTF<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      processVECTF<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      processVECTF<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED,VECT,INT>(in_s, out_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
+  }
+}
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE, int VECT, typename INT, typename IN, typename OUT, class Filter>
+void processMISOVECT(hls::stream<IN> &in1_s, hls::stream<IN> &in2_s, hls::stream<OUT> &out_s, const int &width, const int &height, Filter &filter, const enum BorderPadding::values borderPadding) {
+  switch (borderPadding) {
+    case BorderPadding::BORDER_CONST:
+      processMISOVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CONST,VECT,INT>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_CLAMP:
+      processMISOVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_CLAMP,VECT,INT>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR:
+      processMISOVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR,VECT,INT>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_MIRROR_101:
+      processMISOVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_MIRROR_101,VECT,INT>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    case BorderPadding::BORDER_UNDEFINED:
+      processMISOVECT<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE,KERNEL_SIZE,BorderPadding::BORDER_UNDEFINED,VECT,INT>(in1_s, in2_s, out_s, width, height, filter);
+      break;
+    default:
+      assert(false && "Border mode not supported");
+  }
+}
 
-      //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
-      //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win_tmp[i][j] = win_tmp[i][j+1];
-          }
-        }
+////////////////////////////////////////////////////////////////////////////////
+// Oliver's VECT alternatives:
+//   - processVECT
+//   - processVECTF
+//   - processSIMOVECT
+//   - processSIMOVECTF
+//   - processMISOVECT
+//   - processMISOVECTF
+//   - processPixelsVECT
+//   - processPixelsVECTF
+//   - processPixels2VECT
+//   - processPixels2VECTF
+//   - processPixels3VECT
+//   - processPixels3VECTF
+//   - splitStreamVECT
+//   - splitStream3VECT
+//   - splitStream4VECT
+////////////////////////////////////////////////////////////////////////////////
+// Geometry of the sliding window over vectors of VECT pixels, resolved at
+// compile time for any vectorization factor. The window holds RADIUS_WORDS
+// vectors on either side of the center vector, the first VECT results are
+// available DELAY pixels after the corresponding input.
+template<int KERNEL_SIZE_X, int VECT>
+struct VectWindow {
+  enum {
+    GDELAY       = KERNEL_SIZE_X/2,
+    RADIUS_WORDS = (GDELAY+VECT-1)/VECT,
+    WORDS        = 2*RADIUS_WORDS+1,
+    PIXELS       = WORDS*VECT,
+    DELAY        = RADIUS_WORDS*VECT,
+    // unpacked window position of the leftmost pixel needed for result 0
+    BASE         = DELAY-GDELAY
+  };
+};
 
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff[i][colv];
-          } else {
-            temp_lb = lineBuff[i][colv];
-            win_tmp[i][KERNEL_SIZE_X_V-1] = temp_lb;
-            lineBuff[i-1][colv] = temp_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff[KERNEL_SIZE_Y-2][colv] = in_pixel;
-        }
-        win_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in_pixel;
+// access to pixels packed into vectors, floats are stored as their bit pattern
+template<bool FLOAT>
+struct VectPixel {
+  template<typename INT, int BW>
+  static INT load(const ap_uint<BW> bits) { return (INT)bits; }
+  template<typename T>
+  static T store(const T val) { return val; }
+};
 
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win[i][j] = win_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win[i][j] = win[iy][j];
-          }
-        }
+template<>
+struct VectPixel<true> {
+  template<typename INT, int BW>
+  static INT load(const ap_uint<BW> bits) { return i2f((int)bits); }
+  template<typename T>
+  static int store(const T val) { return f2i(val); }
+};
 
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][j] = i2f(win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
+// Shifts the vector window by one vector and appends the vectors of column
+// colv, which are taken from the line buffer. Vectors right of the image are
+// never read, hence the line buffer is only updated for valid columns.
+template<int KERNEL_SIZE_Y, int WORDS, int LB_WORDS, int BW_IN>
+void shiftVectWindow(
+    ap_uint<BW_IN> win[KERNEL_SIZE_Y][WORDS],
+    ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][LB_WORDS],
+    const ap_uint<BW_IN> in_pixel,
+    const int colv,
+    const bool valid)
+{
+#pragma HLS INLINE
+  for (int i = 0; i < KERNEL_SIZE_Y; i++) {
+  #pragma HLS unroll
+    for (int j = 0; j < WORDS-1; j++) {
+      win[i][j] = win[i][j+1];
+    }
+  }
 
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win_vect[i][KERNEL_SIZE_X+v] = i2f(win[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
+  if (valid) {
+    for (int i = 0; i < KERNEL_SIZE_Y-1; i++) {
+    #pragma HLS unroll
+      ap_uint<BW_IN> temp_lb = lineBuff[i][colv];
+      win[i][WORDS-1] = temp_lb;
+      if (i > 0) {
+        lineBuff[i-1][colv] = temp_lb;
       }
+    }
+    if (KERNEL_SIZE_Y > 1) {
+      lineBuff[KERNEL_SIZE_Y-2][colv] = in_pixel;
+    }
+    win[KERNEL_SIZE_Y-1][WORDS-1] = in_pixel;
+  }
+}
 
-      //**********************************************************
-      // DO CALCULATIONS
-      //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
-      {
-        for (int v = 0; v < VECT; v++) {
-          INT win_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win_small[i][j] = win_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = f2i(filter(win_small));
+// Assembles the windows of all VECT results computed for column col. The
+// vector window is unpacked at fixed positions, result v reads its window at
+// offset BASE+v. Border handling selects among the unpacked pixels, so no
+// runtime division by VECT is needed.
+template<int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, bool FLOAT, typename INT, int BW_IN>
+void getVectWindows(
+    INT win_vect[VECT][KERNEL_SIZE_Y][KERNEL_SIZE_X],
+    ap_uint<BW_IN> win[KERNEL_SIZE_Y][VectWindow<KERNEL_SIZE_X,VECT>::WORDS],
+    const int col,
+    const int row,
+    const int width,
+    const int height)
+{
+#pragma HLS INLINE
+  typedef VectWindow<KERNEL_SIZE_X,VECT> VW;
+  const int I_WIDTH = BW_IN/VECT;
+
+  INT pixels[KERNEL_SIZE_Y][VW::PIXELS];
+  #pragma HLS ARRAY_PARTITION variable=pixels dim=0 complete
+  for (int i = 0; i < KERNEL_SIZE_Y; i++) {
+  #pragma HLS unroll
+    for (int k = 0; k < VW::PIXELS; k++) {
+      ap_uint<I_WIDTH> bits(win[i][k/VECT]((k%VECT)*I_WIDTH,(k%VECT+1)*I_WIDTH-1));
+      pixels[i][k] = VectPixel<FLOAT>::template load<INT>(bits);
+    }
+  }
+
+  for (int v = 0; v < VECT; v++) {
+  #pragma HLS unroll
+    // column of the last pixel in the window of result v
+    const int col_v = col - VW::DELAY + v + VW::GDELAY;
+    for (int j = 0; j < KERNEL_SIZE_X; j++) {
+      int jx = getNewCoords<BORDER_PADDING>(j,KERNEL_SIZE_X,VW::GDELAY,col_v,width);
+      for (int i = 0; i < KERNEL_SIZE_Y; i++) {
+        int iy = getNewCoords<BORDER_PADDING>(i,KERNEL_SIZE_Y,GDELAY_Y,row,height);
+        if (BORDER_PADDING == BorderPadding::BORDER_CONST && (jx < 0 || iy < 0)) {
+          win_vect[v][i][j] = (INT)BORDER_FILL_VALUE;
+        } else {
+          win_vect[v][i][j] = pixels[iy][VW::BASE+v+jx];
         }
-        out1_s << out_pixel;
-        out2_s << out_pixel;
       }
     }
   }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processMISOVECT(
-    hls::stream<ap_uint<BW_IN> > &in1_s,
-    hls::stream<ap_uint<BW_IN> > &in2_s,
-    hls::stream<ap_uint<BW_OUT> > &out_s,
+// one input, NUM_OUT outputs carrying the same results
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, bool FLOAT, int NUM_OUT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processVECTSISO(
+    hls::stream<ap_uint<BW_IN> > &in_s,
+    hls::stream<ap_uint<BW_OUT> > &out1_s,
+    hls::stream<ap_uint<BW_OUT> > &out2_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Filter &filter)
 {
   // TODO fix this
   assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
 
-  ap_uint<BW_IN> lineBuff1[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff1 dim=1 complete
-  ap_uint<BW_IN> lineBuff2[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
-  #pragma HLS ARRAY_PARTITION variable=lineBuff2 dim=1 complete
-  ap_uint<BW_IN> win1[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  ap_uint<BW_IN> win2[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  ap_uint<BW_IN> win1_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win1_tmp dim=0 complete
-  ap_uint<BW_IN> win2_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win2_tmp dim=0 complete
-
-  INT win1_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win1_vect dim=0 complete
-  INT win2_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
-  #pragma HLS ARRAY_PARTITION variable=win2_vect dim=0 complete
+  typedef VectWindow<KERNEL_SIZE_X,VECT> VW;
+  ap_uint<BW_IN> lineBuff[KERNEL_SIZE_Y-1][(MAX_WIDTH+VECT-1)/VECT];
+  #pragma HLS ARRAY_PARTITION variable=lineBuff dim=1 complete
+  ap_uint<BW_IN> win[KERNEL_SIZE_Y][VW::WORDS];
+  #pragma HLS ARRAY_PARTITION variable=win dim=0 complete
+  INT win_vect[VECT][KERNEL_SIZE_Y][KERNEL_SIZE_X];
+  #pragma HLS ARRAY_PARTITION variable=win_vect dim=0 complete
 
-  ap_uint<BW_IN> in1_pixel, temp1_lb;
-  ap_uint<BW_IN> in2_pixel, temp2_lb;
+  ap_uint<BW_IN> in_pixel;
   ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
+  int row, col, colv;
 
   IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
+  for(row = 0; row < height+GDELAY_Y; ++row){
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
     IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
+    for(col = 0, colv = 0; col < width+VW::DELAY; col+=VECT, ++colv){
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
       //**********************************************************
       // GET NEW INPUT
       //**********************************************************
       if(col < width & row < height){
-        in1_s >> in1_pixel;
-        in2_s >> in2_pixel;
+        in_s >> in_pixel;
       }
 
       //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
+      // UPDATE THE WINDOW AND THE LINE BUFFER
       //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win1_tmp[i][j] = win1_tmp[i][j+1];
-            win2_tmp[i][j] = win2_tmp[i][j+1];
-          }
-        }
-
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win1_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff1[i][colv];
-            win2_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff2[i][colv];
-          } else {
-            temp1_lb = lineBuff1[i][colv];
-            temp2_lb = lineBuff2[i][colv];
-            win1_tmp[i][KERNEL_SIZE_X_V-1] = temp1_lb;
-            win2_tmp[i][KERNEL_SIZE_X_V-1] = temp2_lb;
-            lineBuff1[i-1][colv] = temp1_lb;
-            lineBuff2[i-1][colv] = temp2_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff1[KERNEL_SIZE_Y-2][colv] = in1_pixel;
-          lineBuff2[KERNEL_SIZE_Y-2][colv] = in2_pixel;
-        }
-        win1_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in1_pixel;
-        win2_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in2_pixel;
-
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win1[i][j] = win1_tmp[i][jx];
-            win2[i][j] = win2_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win1[i][j] = win1[iy][j];
-             win2[i][j] = win2[iy][j];
-          }
-        }
-
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win1_vect[i][j] = win1[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-            win2_vect[i][j] = win2[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win1_vect[i][KERNEL_SIZE_X+v] = win1[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-            win2_vect[i][KERNEL_SIZE_X+v] = win2[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1);
-          }
-        }
-      }
+      shiftVectWindow<KERNEL_SIZE_Y,VW::WORDS>(win, lineBuff, in_pixel, colv, col < width);
 
       //**********************************************************
       // DO CALCULATIONS
       //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
+      if(row >= GDELAY_Y && col >= VW::DELAY)
       {
+        getVectWindows<KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,FLOAT>(win_vect, win, col, row, width, height);
         for (int v = 0; v < VECT; v++) {
-          INT win1_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          INT win2_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win1_small[i][j] = win1_vect[i][j+v];
-              win2_small[i][j] = win2_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = filter(win1_small, win2_small);
+          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = VectPixel<FLOAT>::store(filter(win_vect[v]));
+        }
+        out1_s << out_pixel;
+        if (NUM_OUT > 1) {
+          out2_s << out_pixel;
         }
-        out_s << out_pixel;
       }
     }
   }
 }
 
-template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
-void processMISOVECTF(
+// two inputs, one output
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, bool FLOAT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processVECTMISO(
     hls::stream<ap_uint<BW_IN> > &in1_s,
     hls::stream<ap_uint<BW_IN> > &in2_s,
     hls::stream<ap_uint<BW_OUT> > &out_s,
     const int &width,
     const int &height,
-    Filter &filter,
-    const enum BorderPadding::values borderPadding)
+    Filter &filter)
 {
   // TODO fix this
   assert( width <= MAX_WIDTH ); assert( height <= MAX_HEIGHT );
 
-  ap_uint<BW_IN> lineBuff1[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
+  typedef VectWindow<KERNEL_SIZE_X,VECT> VW;
+  ap_uint<BW_IN> lineBuff1[KERNEL_SIZE_Y-1][(MAX_WIDTH+VECT-1)/VECT];
   #pragma HLS ARRAY_PARTITION variable=lineBuff1 dim=1 complete
-  ap_uint<BW_IN> lineBuff2[KERNEL_SIZE_Y-1][MAX_WIDTH/VECT];
+  ap_uint<BW_IN> lineBuff2[KERNEL_SIZE_Y-1][(MAX_WIDTH+VECT-1)/VECT];
   #pragma HLS ARRAY_PARTITION variable=lineBuff2 dim=1 complete
-  ap_uint<BW_IN> win1[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
+  ap_uint<BW_IN> win1[KERNEL_SIZE_Y][VW::WORDS];
   #pragma HLS ARRAY_PARTITION variable=win1 dim=0 complete
-  ap_uint<BW_IN> win2[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
+  ap_uint<BW_IN> win2[KERNEL_SIZE_Y][VW::WORDS];
   #pragma HLS ARRAY_PARTITION variable=win2 dim=0 complete
-  ap_uint<BW_IN> win1_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win1_tmp dim=0 complete
-  ap_uint<BW_IN> win2_tmp[KERNEL_SIZE_Y][KERNEL_SIZE_X_V];
-  #pragma HLS ARRAY_PARTITION variable=win2_tmp dim=0 complete
-
-  INT win1_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
+  INT win1_vect[VECT][KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win1_vect dim=0 complete
-  INT win2_vect[KERNEL_SIZE_Y][KERNEL_SIZE_X+VECT-1];
+  INT win2_vect[VECT][KERNEL_SIZE_Y][KERNEL_SIZE_X];
   #pragma HLS ARRAY_PARTITION variable=win2_vect dim=0 complete
 
-  ap_uint<BW_IN> in1_pixel, temp1_lb;
-  ap_uint<BW_IN> in2_pixel, temp2_lb;
+  ap_uint<BW_IN> in1_pixel, in2_pixel;
   ap_uint<BW_OUT> out_pixel;
-  int row, col, i, j, colv;
+  int row, col, colv;
 
   IMG_ROWS:
-  for(row = 0; row < MAX_HEIGHT+GDELAY_Y; ++row){
-    //std::cout << "ROW: " << row << std::endl;
+  for(row = 0; row < height+GDELAY_Y; ++row){
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
     IMG_COLS:
-    for(col = 0, colv = 0; col < MAX_WIDTH+GDELAY_X; col+=VECT, ++colv){
+    for(col = 0, colv = 0; col < width+VW::DELAY; col+=VECT, ++colv){
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
       PRAGMA_HLS(HLS pipeline ii=II_TARGET)
       #pragma HLS INLINE region
       //**********************************************************
@@ -5133,103 +3701,20 @@ void processMISOVECTF(
       }
 
       //**********************************************************
-      // UPDATE THE WINDOW
-      // The line buffer behaves normally
+      // UPDATE THE WINDOWS AND THE LINE BUFFERS
       //**********************************************************
-      if (col < width & row < height + GDELAY_Y)
-      {
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-        #pragma HLS unroll
-          for(j = 0; j < KERNEL_SIZE_X_V-1; j++){
-            win1_tmp[i][j] = win1_tmp[i][j+1];
-            win2_tmp[i][j] = win2_tmp[i][j+1];
-          }
-        }
-
-        //**********************************************************
-        // UPDATE THE LINE BUFFER
-        // The line buffer behaves normally
-        //**********************************************************
-        LINE_BUFF_1:
-        for(i = 0; i < KERNEL_SIZE_Y-1; i++){
-        #pragma HLS unroll
-          if (i == 0) {
-            win1_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff1[i][colv];
-            win2_tmp[i][KERNEL_SIZE_X_V-1] = lineBuff2[i][colv];
-          } else {
-            temp1_lb = lineBuff1[i][colv];
-            temp2_lb = lineBuff2[i][colv];
-            win1_tmp[i][KERNEL_SIZE_X_V-1] = temp1_lb;
-            win2_tmp[i][KERNEL_SIZE_X_V-1] = temp2_lb;
-            lineBuff1[i-1][colv] = temp1_lb;
-            lineBuff2[i-1][colv] = temp2_lb;
-          }
-        }
-        if (KERNEL_SIZE_Y > 1) {
-          lineBuff1[KERNEL_SIZE_Y-2][colv] = in1_pixel;
-          lineBuff2[KERNEL_SIZE_Y-2][colv] = in2_pixel;
-        }
-        win1_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in1_pixel;
-        win2_tmp[KERNEL_SIZE_Y-1][KERNEL_SIZE_X_V-1] = in2_pixel;
-
-        //**********************************************************
-        // UPDATE THE LP WINDOW
-        // Window update includes mirroring border treatment
-        //**********************************************************
-        // X-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int jx = getNewCoords(j,KERNEL_SIZE_X_V,GDELAY_X,col,width,borderPadding);
-            win1[i][j] = win1_tmp[i][jx];
-            win2[i][j] = win2_tmp[i][jx];
-          }
-        }
-        // Y-DIRECTION
-        for(i = 0; i < KERNEL_SIZE_Y; i++){
-          for(j = 0; j < KERNEL_SIZE_X_V; j++){
-            int iy = getNewCoords(i,KERNEL_SIZE_Y,GDELAY_Y,row,height,borderPadding);
-             win1[i][j] = win1[iy][j];
-             win2[i][j] = win2[iy][j];
-          }
-        }
-
-        //**********************************************************
-        // ASSIGN WINDOWS
-        //**********************************************************
-        // fill original window
-        for(int j = 0; j < KERNEL_SIZE_X; j++){
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+j,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win1_vect[i][j] = i2f(win1[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-            win2_vect[i][j] = i2f(win2[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
-
-        // fill window extension caused by vectorization
-        for (int v = 0; v < VECT-1; v++) {
-          winPos jv = getWinCoords((GDELAY_X_V*VECT)-GDELAY_X+KERNEL_SIZE_X+v,KERNEL_SIZE_X, KERNEL_SIZE_X_V,VECT,GDELAY_X,col,width,borderPadding);
-          for(int i = 0; i < KERNEL_SIZE_Y; i++){
-            win1_vect[i][KERNEL_SIZE_X+v] = i2f(win1[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-            win2_vect[i][KERNEL_SIZE_X+v] = i2f(win2[i][jv.win]((jv.pos)*I_WIDTH_V,(jv.pos+1)*I_WIDTH_V-1));
-          }
-        }
-      }
+      shiftVectWindow<KERNEL_SIZE_Y,VW::WORDS>(win1, lineBuff1, in1_pixel, colv, col < width);
+      shiftVectWindow<KERNEL_SIZE_Y,VW::WORDS>(win2, lineBuff2, in2_pixel, colv, col < width);
 
       //**********************************************************
       // DO CALCULATIONS
       //**********************************************************
-      if(row >= GDELAY_Y && col >= GDELAY_X)
+      if(row >= GDELAY_Y && col >= VW::DELAY)
       {
+        getVectWindows<KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,FLOAT>(win1_vect, win1, col, row, width, height);
+        getVectWindows<KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,FLOAT>(win2_vect, win2, col, row, width, height);
         for (int v = 0; v < VECT; v++) {
-          INT win1_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          INT win2_small[KERNEL_SIZE_Y][KERNEL_SIZE_X];
-          for (int i = 0; i < KERNEL_SIZE_Y; i++) {
-            for (int j = 0; j < KERNEL_SIZE_X; j++) {
-              win1_small[i][j] = win1_vect[i][j+v];
-              win2_small[i][j] = win2_vect[i][j+v];
-            }
-          }
-          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = f2i(filter(win1_small, win2_small));
+          out_pixel(v*O_WIDTH_V,(v+1)*O_WIDTH_V-1) = VectPixel<FLOAT>::store(filter(win1_vect[v], win2_vect[v]));
         }
         out_s << out_pixel;
       }
@@ -5237,6 +3722,76 @@ void processMISOVECTF(
   }
 }
 
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processVECT(
+    hls::stream<ap_uint<BW_IN> > &in_s,
+    hls::stream<ap_uint<BW_OUT> > &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTSISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,false,1,INT>(in_s, out_s, out_s, width, height, filter);
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processVECTF(
+    hls::stream<ap_uint<BW_IN> > &in_s,
+    hls::stream<ap_uint<BW_OUT> > &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTSISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,true,1,INT>(in_s, out_s, out_s, width, height, filter);
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processSIMOVECT(
+    hls::stream<ap_uint<BW_IN> > &in_s,
+    hls::stream<ap_uint<BW_OUT> > &out1_s,
+    hls::stream<ap_uint<BW_OUT> > &out2_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTSISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,false,2,INT>(in_s, out1_s, out2_s, width, height, filter);
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processSIMOVECTF(
+    hls::stream<ap_uint<BW_IN> > &in_s,
+    hls::stream<ap_uint<BW_OUT> > &out1_s,
+    hls::stream<ap_uint<BW_OUT> > &out2_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTSISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,true,2,INT>(in_s, out1_s, out2_s, width, height, filter);
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processMISOVECT(
+    hls::stream<ap_uint<BW_IN> > &in1_s,
+    hls::stream<ap_uint<BW_IN> > &in2_s,
+    hls::stream<ap_uint<BW_OUT> > &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,false,INT>(in1_s, in2_s, out_s, width, height, filter);
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, BorderPadding::values BORDER_PADDING, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
+void processMISOVECTF(
+    hls::stream<ap_uint<BW_IN> > &in1_s,
+    hls::stream<ap_uint<BW_IN> > &in2_s,
+    hls::stream<ap_uint<BW_OUT> > &out_s,
+    const int &width,
+    const int &height,
+    Filter &filter)
+{
+  processVECTMISO<II_TARGET,MAX_WIDTH,MAX_HEIGHT,KERNEL_SIZE_X,KERNEL_SIZE_Y,BORDER_PADDING,VECT,true,INT>(in1_s, in2_s, out_s, width, height, filter);
+}
+
 template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, int KERNEL_SIZE_X, int KERNEL_SIZE_Y, int VECT, typename INT, int BW_IN, int BW_OUT, class Filter>
 void processPixelsVECT(
     hls::stream<ap_uint<BW_IN> > &in_s,
@@ -5498,6 +4053,221 @@ void splitStream4VECT(
     }
 }
 
+// Memory ports: frames are stored line by line in words of VECT pixels, each
+// line is transferred in one pipelined loop, which is inferred as bursts on
+// m_axi interfaces
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T>
+void readMemoryPort(
+    const T *mem,
+    hls::stream<T> &out_s,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int words = (width + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    const T *line = mem + y * words;
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      out_s << line[x];
+    }
+  }
+}
+
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T>
+void writeMemoryPort(
+    hls::stream<T> &in_s,
+    T *mem,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int words = (width + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    T *line = mem + y * words;
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      line[x] = in_s.read();
+    }
+  }
+}
+
+// Strip-mining: the columns x0 up to x0+width of each line of a frame of
+// frameWidth pixels are streamed as a frame of width pixels; x0 is a multiple
+// of VECT
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T>
+void readMemoryStrip(
+    const T *mem,
+    hls::stream<T> &out_s,
+    const int &frameWidth,
+    const int &x0,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int frameWords = (frameWidth + VECT - 1) / VECT;
+  const int words = (width + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    const T *line = mem + y * frameWords + x0 / VECT;
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      out_s << line[x];
+    }
+  }
+}
+
+// Writes count columns starting at column skip of the strip read from column
+// x0 of the frame, the remaining columns are the halos of the neighbouring
+// strips; skip is a multiple of VECT
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T>
+void writeMemoryStrip(
+    hls::stream<T> &in_s,
+    T *mem,
+    const int &frameWidth,
+    const int &x0,
+    const int &width,
+    const int &skip,
+    const int &count,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int frameWords = (frameWidth + VECT - 1) / VECT;
+  const int words = (width + VECT - 1) / VECT;
+  const int first = skip / VECT;
+  const int last = (skip + count + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    T *line = mem + y * frameWords + x0 / VECT;
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      const T val = in_s.read();
+      if (x >= first && x < last) {
+        line[x] = val;
+      }
+    }
+  }
+}
+
+// Video mode: frames arrive back to back on AXI4-Stream interfaces. Words are
+// dropped until the start of a frame, so that the pipeline resynchronizes
+// after an incomplete frame. Returns the first word of the frame.
+template<typename T>
+HipaccVideo<T> readVideoStart(hls::stream<HipaccVideo<T> > &in_s)
+{
+  HipaccVideo<T> word;
+  do {
+    PRAGMA_HLS(HLS pipeline ii=1)
+    word = in_s.read();
+  } while (!word.user);
+  return word;
+}
+
+// Reads the frame starting with word. Each line ends with TLAST: a line that
+// ends early is padded with its last pixel, the excess words of a line that is
+// too long are dropped, so that exactly width x height pixels are forwarded.
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T>
+void readVideoFrame(
+    hls::stream<HipaccVideo<T> > &in_s,
+    hls::stream<T> &out_s,
+    HipaccVideo<T> word,
+    const int &width,
+    const int &height)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int words = (width + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    bool eol = false;
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      if ((y > 0 || x > 0) && !eol) {
+        word = in_s.read();
+      }
+      eol = eol || word.last;
+      out_s << word.data;
+    }
+    while (!eol) {
+      PRAGMA_HLS(HLS pipeline ii=1)
+      word = in_s.read();
+      eol = word.last;
+    }
+  }
+}
+
+// Reads the frames of further inputs, their size is taken from the parameters
+// latched at the start of the frame (see HipaccVideoParams)
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T, typename P>
+void readVideoStream(
+    hls::stream<HipaccVideo<T> > &in_s,
+    hls::stream<T> &out_s,
+    hls::stream<P> &param_s,
+    const int level)
+{
+  const P param = param_s.read();
+  HipaccVideo<T> word = readVideoStart(in_s);
+  readVideoFrame<MAX_WIDTH, MAX_HEIGHT, VECT>(in_s, out_s, word,
+      param.width >> level, param.height >> level);
+}
+
+template<int MAX_WIDTH, int MAX_HEIGHT, int VECT, typename T, typename P>
+void writeVideoStream(
+    hls::stream<T> &in_s,
+    hls::stream<HipaccVideo<T> > &out_s,
+    hls::stream<P> &param_s,
+    const int level)
+{
+  const P param = param_s.read();
+  const int width = param.width >> level;
+  const int height = param.height >> level;
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int words = (width + VECT - 1) / VECT;
+  for (int y = 0; y < height; ++y) {
+    PRAGMA_HLS(HLS loop_tripcount max=MAX_HEIGHT)
+    for (int x = 0; x < words; ++x) {
+      PRAGMA_HLS(HLS loop_tripcount max=MAX_WIDTH/VECT)
+      PRAGMA_HLS(HLS pipeline ii=1)
+      HipaccVideo<T> word;
+      word.data = in_s.read();
+      word.user = (x == 0 && y == 0);
+      word.last = (x == words - 1);
+      out_s << word;
+    }
+  }
+}
+
+// Copies a scalar or the coefficients of a mask from the AXI4-Lite control
+// interface into the parameters of a frame
+template<typename T>
+void latchVideoParam(T &dst, const T &src)
+{
+  dst = src;
+}
+
+template<typename T, int SIZE_Y, int SIZE_X>
+void latchVideoParam(T (&dst)[SIZE_Y][SIZE_X], const T src[][SIZE_X])
+{
+  for (int y = 0; y < SIZE_Y; ++y) {
+    for (int x = 0; x < SIZE_X; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=1)
+      dst[y][x] = src[y][x];
+    }
+  }
+}
+
 #ifndef _OPSTUFF_
 #define _OPSTUFF_
 template<typename T>
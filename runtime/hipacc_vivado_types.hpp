@@ -46,6 +46,7 @@
 
 
 #include "ap_int.h"
+#include "ap_fixed.h"
 
 
 typedef unsigned char       uchar;
@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Stand-in for the Vivado HLS arbitrary precision fixed-point types. Provides
+// the subset of ap_fixed<W,I,Q,O> used by the code generated for kernels
+// converted to fixed-point, so that pipelines can be simulated without a
+// Vivado HLS installation. Values of up to 53 bits are stored as integer
+// multiples of 2^(I-W). Arithmetic is performed on doubles and rounded on
+// assignment, like Vivado HLS computes intermediate results at full precision
+// and quantizes when assigning to a variable of the target format. Doubles
+// represent these values exactly, the compiler does not emit wider formats.
+
+#ifndef __HIPACC_SIM_AP_FIXED_H__
+#define __HIPACC_SIM_AP_FIXED_H__
+
+#include <stdint.h>
+#include <math.h>
+
+#include "ap_int.h"
+
+enum ap_q_mode {
+  AP_RND,         // round to plus infinity
+  AP_RND_ZERO,    // round to zero
+  AP_RND_MIN_INF, // round to minus infinity
+  AP_RND_INF,     // round to infinity
+  AP_RND_CONV,    // convergent rounding
+  AP_TRN,         // truncate to minus infinity
+  AP_TRN_ZERO     // truncate to zero
+};
+
+enum ap_o_mode {
+  AP_SAT,         // saturate
+  AP_SAT_ZERO,    // set to zero on overflow
+  AP_SAT_SYM,     // saturate symmetrically
+  AP_WRAP,        // wrap around
+  AP_WRAP_SM      // wrap around sign magnitude
+};
+
+
+template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O>
+class ap_fixed_base {
+  static_assert(W > 0 && W <= 53, "ap_fixed stand-in supports up to 53 bits");
+
+  public:
+    // value is raw * 2^(I-W)
+    int64_t raw;
+
+  private:
+    static double scale() { return ldexp(1.0, W-I); }
+
+    static int64_t quantize(double val) {
+      double scaled = val * scale();
+      double q = floor(scaled);
+      double frac = scaled - q;
+      switch (Q) {
+        case AP_RND:         if (frac >= 0.5) q += 1; break;
+        case AP_RND_ZERO:    if (frac > 0.5 || (frac == 0.5 && q < 0)) q += 1;
+                             break;
+        case AP_RND_MIN_INF: if (frac > 0.5) q += 1; break;
+        case AP_RND_INF:     if (frac > 0.5 || (frac == 0.5 && q >= 0)) q += 1;
+                             break;
+        case AP_RND_CONV:    if (frac > 0.5 ||
+                                 (frac == 0.5 && fmod(q, 2.0) != 0)) q += 1;
+                             break;
+        case AP_TRN:         break;
+        case AP_TRN_ZERO:    if (frac > 0 && q < 0) q += 1; break;
+      }
+
+      double lo = S ? -ldexp(1.0, W-1) : 0;
+      double hi = S ? ldexp(1.0, W-1) - 1 : ldexp(1.0, W) - 1;
+      if (q >= lo && q <= hi) {
+        return (int64_t)q;
+      }
+      switch (O) {
+        case AP_SAT:
+        case AP_SAT_SYM:  return (int64_t)(q < lo ? (O == AP_SAT_SYM ? -hi : lo)
+                                                  : hi);
+        case AP_SAT_ZERO: return 0;
+        default:          break;
+      }
+      // keep the lower W bits
+      double range = ldexp(1.0, W);
+      q = fmod(q - lo, range);
+      if (q < 0) q += range;
+      return (int64_t)(q + lo);
+    }
+
+  public:
+    ap_fixed_base() : raw(0) {}
+    ap_fixed_base(double val) : raw(quantize(val)) {}
+
+    template<int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2>
+    ap_fixed_base(const ap_fixed_base<W2,I2,S2,Q2,O2> &val)
+      : raw(quantize(val.to_double())) {}
+
+    template<int W2, bool S2>
+    ap_fixed_base(const ap_int_base<W2,S2> &val)
+      : raw(quantize(S2 ? (double)val.to_int64() : (double)val.to_uint64())) {}
+
+    double to_double() const { return (double)raw / scale(); }
+    float to_float() const { return (float)to_double(); }
+    int to_int() const { return (int)to_double(); }
+    operator double() const { return to_double(); }
+
+    ap_fixed_base &operator+=(double val) {
+      raw = quantize(to_double() + val); return *this;
+    }
+    ap_fixed_base &operator-=(double val) {
+      raw = quantize(to_double() - val); return *this;
+    }
+    ap_fixed_base &operator*=(double val) {
+      raw = quantize(to_double() * val); return *this;
+    }
+    ap_fixed_base &operator/=(double val) {
+      raw = quantize(to_double() / val); return *this;
+    }
+    ap_fixed_base &operator++() { return *this += 1; }
+    ap_fixed_base &operator--() { return *this -= 1; }
+    ap_fixed_base operator++(int) { ap_fixed_base t(*this); ++*this; return t; }
+    ap_fixed_base operator--(int) { ap_fixed_base t(*this); --*this; return t; }
+};
+
+
+template<int W, int I, ap_q_mode Q=AP_TRN, ap_o_mode O=AP_WRAP, int N=0>
+class ap_fixed : public ap_fixed_base<W,I,true,Q,O> {
+  typedef ap_fixed_base<W,I,true,Q,O> Base;
+
+  public:
+    ap_fixed() : Base() {}
+    ap_fixed(double val) : Base(val) {}
+    template<int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2>
+    ap_fixed(const ap_fixed_base<W2,I2,S2,Q2,O2> &val) : Base(val) {}
+    template<int W2, bool S2>
+    ap_fixed(const ap_int_base<W2,S2> &val) : Base(val) {}
+};
+
+
+template<int W, int I, ap_q_mode Q=AP_TRN, ap_o_mode O=AP_WRAP, int N=0>
+class ap_ufixed : public ap_fixed_base<W,I,false,Q,O> {
+  typedef ap_fixed_base<W,I,false,Q,O> Base;
+
+  public:
+    ap_ufixed() : Base() {}
+    ap_ufixed(double val) : Base(val) {}
+    template<int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2>
+    ap_ufixed(const ap_fixed_base<W2,I2,S2,Q2,O2> &val) : Base(val) {}
+    template<int W2, bool S2>
+    ap_ufixed(const ap_int_base<W2,S2> &val) : Base(val) {}
+};
+
+#endif  // __HIPACC_SIM_AP_FIXED_H__
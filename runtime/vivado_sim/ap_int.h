@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Stand-in for the Vivado HLS arbitrary precision integer types. Provides the
+// subset of ap_int<W>/ap_uint<W> used by the HIPAcc Vivado runtime and the
+// generated code, so that pipelines can be simulated without a Vivado HLS
+// installation. Values are stored in 64-bit words, arithmetic on types wider
+// than 64 bits is performed on the lower 64 bits; bit access, ranges, bitwise
+// operators, and comparison for equality work on the full width. As in Vivado
+// HLS, a range (lo, hi) with lo > hi returns the bits in reversed order.
+
+#ifndef __HIPACC_SIM_AP_INT_H__
+#define __HIPACC_SIM_AP_INT_H__
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+template<int W, bool S> class ap_int_base;
+template<int W, bool S> class ap_range_ref;
+template<int W, bool S> class ap_bit_ref;
+
+
+template<int W, bool S>
+class ap_int_base {
+  public:
+    enum { WORDS = (W+63)/64 };
+    typedef typename std::conditional<S, long long, unsigned long long>::type
+      RetType;
+
+    // bits above W in the top word hold the sign extension for signed types
+    // and are zero for unsigned types
+    uint64_t words[WORDS];
+
+  private:
+    void clear(uint64_t ext=0) {
+      for (int i=0; i<WORDS; ++i) words[i] = ext;
+    }
+
+    template<typename T>
+    void setIntegral(T val) {
+      uint64_t ext = (std::is_signed<T>::value && val < 0) ? ~0ULL : 0ULL;
+      clear(ext);
+      words[0] = (uint64_t)val;
+      normalize();
+    }
+
+  public:
+    void normalize() {
+      if (W % 64) {
+        uint64_t mask = ~0ULL << (W % 64);
+        if (S && ((words[WORDS-1] >> ((W-1) % 64)) & 1)) {
+          words[WORDS-1] |= mask;
+        } else {
+          words[WORDS-1] &= ~mask;
+        }
+      }
+    }
+
+    bool isNegative() const {
+      return S && ((words[WORDS-1] >> ((W-1) % 64)) & 1);
+    }
+
+    // get up to 64 bits starting at bit pos
+    uint64_t getBits(int pos, int len) const {
+      int word = pos / 64, off = pos % 64;
+      uint64_t val = words[word] >> off;
+      if (off && off+len > 64 && word+1 < WORDS) {
+        val |= words[word+1] << (64-off);
+      }
+      return len < 64 ? val & ((1ULL << len) - 1) : val;
+    }
+
+    // set up to 64 bits starting at bit pos
+    void setBits(int pos, int len, uint64_t val) {
+      uint64_t mask = len < 64 ? (1ULL << len) - 1 : ~0ULL;
+      int word = pos / 64, off = pos % 64;
+      val &= mask;
+      words[word] = (words[word] & ~(mask << off)) | (val << off);
+      if (off && off+len > 64 && word+1 < WORDS) {
+        words[word+1] = (words[word+1] & ~(mask >> (64-off))) |
+                        (val >> (64-off));
+      }
+    }
+
+    ap_int_base() { clear(); }
+
+    template<typename T,
+             typename std::enable_if<std::is_integral<T>::value, int>::type=0>
+    ap_int_base(T val) { setIntegral(val); }
+
+    template<typename T,
+             typename std::enable_if<std::is_floating_point<T>::value,
+                                     int>::type=0>
+    ap_int_base(T val) { setIntegral((long long)val); }
+
+    template<int W2, bool S2>
+    ap_int_base(const ap_int_base<W2, S2> &val) {
+      uint64_t ext = val.isNegative() ? ~0ULL : 0ULL;
+      for (int i=0; i<WORDS; ++i) {
+        words[i] = i < ap_int_base<W2, S2>::WORDS ? val.words[i] : ext;
+      }
+      normalize();
+    }
+
+    template<int W2, bool S2>
+    ap_int_base(const ap_range_ref<W2, S2> &val) {
+      *this = ap_int_base(val.get());
+    }
+
+    template<int W2, bool S2>
+    ap_int_base(const ap_bit_ref<W2, S2> &val) {
+      setIntegral((int)(bool)val);
+    }
+
+    operator RetType() const { return (RetType)words[0]; }
+
+    // conversion
+    int to_int() const { return (int)words[0]; }
+    unsigned to_uint() const { return (unsigned)words[0]; }
+    long to_long() const { return (long)words[0]; }
+    unsigned long to_ulong() const { return (unsigned long)words[0]; }
+    long long to_int64() const { return (long long)words[0]; }
+    unsigned long long to_uint64() const { return words[0]; }
+    double to_double() const { return (double)(RetType)words[0]; }
+    int length() const { return W; }
+
+    // bit and range access
+    ap_bit_ref<W, S> operator[](int idx) {
+      return ap_bit_ref<W, S>(*this, idx);
+    }
+    bool operator[](int idx) const { return getBits(idx, 1); }
+    ap_bit_ref<W, S> bit(int idx) { return ap_bit_ref<W, S>(*this, idx); }
+    bool bit(int idx) const { return getBits(idx, 1); }
+    ap_range_ref<W, S> range(int hi, int lo) {
+      return ap_range_ref<W, S>(*this, hi, lo);
+    }
+    ap_range_ref<W, S> operator()(int hi, int lo) {
+      return ap_range_ref<W, S>(*this, hi, lo);
+    }
+    ap_int_base<W, false> range(int hi, int lo) const {
+      return ap_range_ref<W, S>(const_cast<ap_int_base &>(*this), hi, lo).get();
+    }
+    ap_int_base<W, false> operator()(int hi, int lo) const {
+      return range(hi, lo);
+    }
+    ap_range_ref<W, S> range() { return range(W-1, 0); }
+
+    // shift operators keep the width of the operand
+    ap_int_base operator<<(int sh) const {
+      if (sh < 0) return *this >> -sh;
+      ap_int_base ret;
+      for (int i=WORDS-1; i>=0; --i) {
+        int src = i - sh/64;
+        uint64_t val = 0;
+        if (src >= 0) {
+          val = words[src] << (sh % 64);
+          if (sh % 64 && src > 0) val |= words[src-1] >> (64 - sh % 64);
+        }
+        ret.words[i] = val;
+      }
+      ret.normalize();
+      return ret;
+    }
+
+    ap_int_base operator>>(int sh) const {
+      if (sh < 0) return *this << -sh;
+      uint64_t ext = isNegative() ? ~0ULL : 0ULL;
+      ap_int_base ret;
+      for (int i=0; i<WORDS; ++i) {
+        int src = i + sh/64;
+        uint64_t lo = src < WORDS ? words[src] : ext;
+        uint64_t hi = src+1 < WORDS ? words[src+1] : ext;
+        ret.words[i] = sh % 64 ? (lo >> (sh % 64)) | (hi << (64 - sh % 64))
+                               : lo;
+      }
+      ret.normalize();
+      return ret;
+    }
+
+    template<int W2, bool S2>
+    ap_int_base operator<<(const ap_int_base<W2, S2> &sh) const {
+      return *this << (int)sh.to_int64();
+    }
+    template<int W2, bool S2>
+    ap_int_base operator>>(const ap_int_base<W2, S2> &sh) const {
+      return *this >> (int)sh.to_int64();
+    }
+
+    // bitwise operators between arbitrary precision types work on full width
+    #define AP_BITWISE_OP(OP) \
+    template<int W2, bool S2> \
+    ap_int_base<(W>W2?W:W2), (S&&S2)> \
+    operator OP(const ap_int_base<W2, S2> &val) const { \
+      ap_int_base<(W>W2?W:W2), (S&&S2)> lhs(*this), rhs(val); \
+      for (int i=0; i<ap_int_base<(W>W2?W:W2), (S&&S2)>::WORDS; ++i) \
+        lhs.words[i] = lhs.words[i] OP rhs.words[i]; \
+      lhs.normalize(); \
+      return lhs; \
+    } \
+    template<int W2, bool S2> \
+    ap_int_base &operator OP##=(const ap_int_base<W2, S2> &val) { \
+      ap_int_base rhs(val); \
+      for (int i=0; i<WORDS; ++i) words[i] = words[i] OP rhs.words[i]; \
+      normalize(); \
+      return *this; \
+    } \
+    template<typename T, \
+             typename std::enable_if<std::is_arithmetic<T>::value, \
+                                     int>::type=0> \
+    ap_int_base &operator OP##=(T val) { \
+      return *this OP##= ap_int_base<64, std::is_signed<T>::value>(val); \
+    }
+    AP_BITWISE_OP(&)
+    AP_BITWISE_OP(|)
+    AP_BITWISE_OP(^)
+    #undef AP_BITWISE_OP
+
+    ap_int_base operator~() const {
+      ap_int_base ret;
+      for (int i=0; i<WORDS; ++i) ret.words[i] = ~words[i];
+      ret.normalize();
+      return ret;
+    }
+
+    // arithmetic compound assignment, performed on the lower 64 bits
+    #define AP_ARITH_OP(OP) \
+    template<typename T> \
+    ap_int_base &operator OP##=(const T &val) { \
+      *this = ap_int_base((RetType)*this OP val); \
+      return *this; \
+    }
+    AP_ARITH_OP(+)
+    AP_ARITH_OP(-)
+    AP_ARITH_OP(*)
+    AP_ARITH_OP(/)
+    AP_ARITH_OP(%)
+    #undef AP_ARITH_OP
+
+    ap_int_base &operator<<=(int sh) { return *this = *this << sh; }
+    ap_int_base &operator>>=(int sh) { return *this = *this >> sh; }
+
+    ap_int_base &operator++() { return *this += 1; }
+    ap_int_base &operator--() { return *this -= 1; }
+    ap_int_base operator++(int) { ap_int_base ret(*this); *this += 1; return ret; }
+    ap_int_base operator--(int) { ap_int_base ret(*this); *this -= 1; return ret; }
+};
+
+
+template<int W, bool S, int W2, bool S2>
+bool operator==(const ap_int_base<W, S> &lhs, const ap_int_base<W2, S2> &rhs) {
+  typedef ap_int_base<(W>W2?W:W2)+1, true> Common;
+  Common l(lhs), r(rhs);
+  for (int i=0; i<Common::WORDS; ++i) {
+    if (l.words[i] != r.words[i]) return false;
+  }
+  return true;
+}
+
+template<int W, bool S, int W2, bool S2>
+bool operator!=(const ap_int_base<W, S> &lhs, const ap_int_base<W2, S2> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<int W, bool S>
+std::ostream &operator<<(std::ostream &os, const ap_int_base<W, S> &val) {
+  if (W <= 64) return os << (typename ap_int_base<W, S>::RetType)val;
+
+  std::ios::fmtflags flags = os.flags();
+  os << "0x" << std::hex << std::setfill('0');
+  for (int i=ap_int_base<W, S>::WORDS-1; i>=0; --i) {
+    os << std::setw(16) << val.words[i];
+  }
+  os.flags(flags);
+  return os;
+}
+
+
+template<int W, bool S>
+class ap_range_ref {
+  private:
+    ap_int_base<W, S> &ref;
+    int hi, lo;
+
+  public:
+    ap_range_ref(ap_int_base<W, S> &ref, int hi, int lo)
+      : ref(ref), hi(hi), lo(lo) {}
+
+    int length() const { return (hi > lo ? hi - lo : lo - hi) + 1; }
+
+    ap_int_base<W, false> get() const {
+      int len = length();
+      int start = hi > lo ? lo : hi;
+      ap_int_base<W, false> ret;
+      for (int pos=0; pos<len; pos+=64) {
+        int chunk = len - pos < 64 ? len - pos : 64;
+        ret.setBits(pos, chunk, ref.getBits(start + pos, chunk));
+      }
+      if (lo > hi) {
+        ap_int_base<W, false> rev;
+        for (int i=0; i<len; ++i) rev.setBits(len - 1 - i, 1, ret.getBits(i, 1));
+        return rev;
+      }
+      return ret;
+    }
+
+    void set(const ap_int_base<W, false> &val) {
+      int len = length();
+      int start = hi > lo ? lo : hi;
+      if (lo > hi) {
+        for (int i=0; i<len; ++i) {
+          ref.setBits(start + len - 1 - i, 1, val.getBits(i, 1));
+        }
+      } else {
+        for (int pos=0; pos<len; pos+=64) {
+          int chunk = len - pos < 64 ? len - pos : 64;
+          ref.setBits(start + pos, chunk, val.getBits(pos, chunk));
+        }
+      }
+      ref.normalize();
+    }
+
+    operator unsigned long long() const { return get().words[0]; }
+
+    template<typename T>
+    ap_range_ref &operator=(const T &val) {
+      set(ap_int_base<W, false>(val));
+      return *this;
+    }
+    ap_range_ref &operator=(const ap_range_ref &val) {
+      set(val.get());
+      return *this;
+    }
+
+    int to_int() const { return (int)get().words[0]; }
+    unsigned to_uint() const { return (unsigned)get().words[0]; }
+    long to_long() const { return (long)get().words[0]; }
+    unsigned long to_ulong() const { return (unsigned long)get().words[0]; }
+    long long to_int64() const { return (long long)get().words[0]; }
+    unsigned long long to_uint64() const { return get().words[0]; }
+};
+
+
+template<int W, bool S>
+class ap_bit_ref {
+  private:
+    ap_int_base<W, S> &ref;
+    int idx;
+
+  public:
+    ap_bit_ref(ap_int_base<W, S> &ref, int idx) : ref(ref), idx(idx) {}
+
+    operator bool() const { return ref.getBits(idx, 1); }
+
+    ap_bit_ref &operator=(unsigned long long val) {
+      ref.setBits(idx, 1, val ? 1 : 0);
+      ref.normalize();
+      return *this;
+    }
+    ap_bit_ref &operator=(const ap_bit_ref &val) {
+      return *this = (unsigned long long)(bool)val;
+    }
+
+    bool to_bool() const { return (bool)*this; }
+};
+
+
+template<int W>
+class ap_int : public ap_int_base<W, true> {
+  public:
+    ap_int() {}
+    template<typename T>
+    ap_int(const T &val) : ap_int_base<W, true>(val) {}
+};
+
+template<int W>
+class ap_uint : public ap_int_base<W, false> {
+  public:
+    ap_uint() {}
+    template<typename T>
+    ap_uint(const T &val) : ap_int_base<W, false>(val) {}
+};
+
+#endif  // __HIPACC_SIM_AP_INT_H__
@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Threaded executor for simulating the dataflow region of generated Vivado
+// pipelines. Each process called within HIPACC_DATAFLOW_BEGIN and
+// HIPACC_DATAFLOW_END runs on its own thread and communicates through bounded
+// hls::stream FIFOs, like the processes of the synthesized design. A watchdog
+// aborts the simulation with a report of the blocked streams once no process
+// can make progress anymore. Setting the environment variable HIPACC_SIM_STATS
+// prints the run time of each region and the occupancy of its streams.
+
+#ifndef __HIPACC_VIVADO_SIM_HPP__
+#define __HIPACC_VIVADO_SIM_HPP__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// default depth of streams declared within a dataflow region, matches the
+// default FIFO depth of Vivado HLS
+#ifndef HIPACC_SIM_STREAM_DEPTH
+#define HIPACC_SIM_STREAM_DEPTH 2
+#endif
+
+// time without progress after which blocked processes are reported (in ms)
+#ifndef HIPACC_SIM_DEADLOCK_TIMEOUT
+#define HIPACC_SIM_DEADLOCK_TIMEOUT 500
+#endif
+
+
+namespace hipacc_sim {
+
+class Dataflow;
+
+// statistics and state of a stream shared with the executor
+struct StreamInfo {
+  std::string name;
+  size_t depth;                     // 0 for unbounded streams
+  size_t size;
+  size_t maxSize;
+  unsigned long long reads, writes;
+  unsigned long long fullStalls, emptyStalls;
+  int blockedReaders, blockedWriters;
+
+  StreamInfo() : depth(0), size(0), maxSize(0), reads(0), writes(0),
+      fullStalls(0), emptyStalls(0), blockedReaders(0), blockedWriters(0) {}
+};
+
+
+class Dataflow {
+  private:
+    std::string name_;
+    std::vector<std::thread> threads_;
+    std::thread watchdog_;
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    std::vector<StreamInfo *> streams_;
+    std::map<std::string, std::string> blocked_;
+    std::atomic<int> active_, running_;
+    std::atomic<unsigned long long> progress_;
+    bool done_;
+    Dataflow *parent_;
+    std::chrono::steady_clock::time_point start_;
+
+    // region the calling thread declares streams in
+    static Dataflow *&current() {
+      static thread_local Dataflow *region = nullptr;
+      return region;
+    }
+    // region and name of the process running on the calling thread
+    static Dataflow *&owner() {
+      static thread_local Dataflow *region = nullptr;
+      return region;
+    }
+    static std::string *&processName() {
+      static thread_local std::string *name = nullptr;
+      return name;
+    }
+
+    void report() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fprintf(stderr, "ERROR: Deadlock in dataflow region '%s':\n",
+          name_.c_str());
+      for (auto &proc : blocked_) {
+        fprintf(stderr, "  process '%s' blocked on %s\n", proc.first.c_str(),
+            proc.second.c_str());
+      }
+      printStreams(stderr);
+      fprintf(stderr, "Increase the depth of the streams listed above.\n");
+      fflush(stderr);
+    }
+
+    void printStreams(FILE *file) {
+      fprintf(file, "  %-24s %8s %8s %12s %12s %12s %12s\n", "stream",
+          "depth", "max", "writes", "reads", "full", "empty");
+      for (auto info : streams_) {
+        fprintf(file, "  %-24s %8s %8zu %12llu %12llu %12llu %12llu\n",
+            info->name.c_str(),
+            info->depth ? std::to_string(info->depth).c_str() : "inf",
+            info->maxSize, info->writes, info->reads, info->fullStalls,
+            info->emptyStalls);
+      }
+    }
+
+    void watch() {
+      unsigned long long last = progress_;
+      auto timeout = std::chrono::milliseconds(HIPACC_SIM_DEADLOCK_TIMEOUT);
+      auto idle = std::chrono::steady_clock::now();
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!done_) {
+        finished_.wait_for(lock, std::chrono::milliseconds(10));
+        if (done_) break;
+
+        unsigned long long now = progress_;
+        if (running_ > 0 || now != last) {
+          last = now;
+          idle = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - idle > timeout) {
+          lock.unlock();
+          report();
+          _Exit(EXIT_FAILURE);
+        }
+      }
+    }
+
+  public:
+    explicit Dataflow(const char *name="hipaccRun")
+      : name_(name), active_(0), running_(0), progress_(0), done_(false),
+        parent_(current()), start_(std::chrono::steady_clock::now()) {
+      current() = this;
+      watchdog_ = std::thread(&Dataflow::watch, this);
+    }
+
+    ~Dataflow() {
+      if (!done_) join();
+    }
+
+    // dataflow region the calling thread declares streams in
+    static Dataflow *region() { return current(); }
+
+    // run process f on its own thread
+    void spawn(const std::string &call, std::function<void()> f) {
+      std::string name = call.substr(0, call.find_first_of("(<"));
+      name.erase(0, name.find_first_not_of(" \t\n"));
+      ++active_;
+      ++running_;
+      threads_.emplace_back([this, name, f]() {
+        std::string proc_name(name);
+        processName() = &proc_name;
+        owner() = this;
+        f();
+        --running_;
+        --active_;
+        ++progress_;
+      });
+    }
+
+    void join() {
+      for (auto &thread : threads_) thread.join();
+      threads_.clear();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+      }
+      finished_.notify_all();
+      watchdog_.join();
+      current() = parent_;
+
+      if (getenv("HIPACC_SIM_STATS")) {
+        std::chrono::duration<double, std::milli> time =
+          std::chrono::steady_clock::now() - start_;
+        fprintf(stderr, "<HIPACC:> Dataflow region '%s': %.3f ms\n",
+            name_.c_str(), time.count());
+        std::lock_guard<std::mutex> lock(mutex_);
+        printStreams(stderr);
+      }
+    }
+
+    void addStream(StreamInfo *info) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      streams_.push_back(info);
+    }
+
+    void removeStream(StreamInfo *info) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      streams_.erase(std::remove(streams_.begin(), streams_.end(), info),
+          streams_.end());
+    }
+
+    // called by a process before it waits for a stream
+    static void block(const std::string &what) {
+      Dataflow *region = owner();
+      std::lock_guard<std::mutex> lock(region->mutex_);
+      region->blocked_[*processName()] = what;
+      --region->running_;
+    }
+
+    static void unblock() {
+      Dataflow *region = owner();
+      std::lock_guard<std::mutex> lock(region->mutex_);
+      region->blocked_.erase(*processName());
+      ++region->running_;
+    }
+
+    static void notifyProgress() {
+      if (owner()) ++owner()->progress_;
+    }
+
+    // true if the calling thread runs a process of a dataflow region
+    static bool inProcess() { return owner() != nullptr; }
+};
+
+
+inline void fatal(const std::string &msg) {
+  fprintf(stderr, "ERROR: %s\n", msg.c_str());
+  fflush(stderr);
+  abort();
+}
+
+} // end namespace hipacc_sim
+
+
+#define HIPACC_DATAFLOW_BEGIN  hipacc_sim::Dataflow _hipacc_dataflow;
+#define HIPACC_PROCESS(...)    _hipacc_dataflow.spawn(#__VA_ARGS__, [&]() { __VA_ARGS__; })
+#define HIPACC_DATAFLOW_END    _hipacc_dataflow.join();
+#define HIPACC_STREAM_DEPTH(s, d)  s.set_depth(d);
+
+#endif  // __HIPACC_VIVADO_SIM_HPP__
@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2014, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Stand-in for the Vivado HLS stream type. Streams declared within a dataflow
+// region, also one nested within a process, are bounded FIFOs of depth
+// HIPACC_SIM_STREAM_DEPTH shared between process threads; all other streams
+// (testbench streams, streams local to a process) are unbounded queues, as in
+// the C simulation of Vivado HLS.
+
+#ifndef __HIPACC_SIM_HLS_STREAM_H__
+#define __HIPACC_SIM_HLS_STREAM_H__
+
+#include <deque>
+
+#include "hipacc_vivado_sim.hpp"
+
+namespace hls {
+
+template<typename T>
+class stream {
+  private:
+    std::deque<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_, not_full_;
+    hipacc_sim::StreamInfo info_;
+    hipacc_sim::Dataflow *region_;
+
+    stream(const stream &);
+    stream &operator=(const stream &);
+
+    void init(const std::string &name) {
+      static std::atomic<int> count(0);
+      info_.name = name.empty() ? "hls::stream." + std::to_string(count++)
+                                : name;
+      // processes only declare bounded streams within nested dataflow
+      // regions, e.g. hipaccRunStreams called by the memory port variant
+      region_ = hipacc_sim::Dataflow::region();
+      if (region_) {
+        info_.depth = HIPACC_SIM_STREAM_DEPTH;
+        region_->addStream(&info_);
+      }
+    }
+
+    bool isFull() const {
+      return info_.depth && queue_.size() >= info_.depth;
+    }
+
+  public:
+    stream() { init(""); }
+    explicit stream(const char *name) { init(name); }
+
+    ~stream() {
+      if (region_) region_->removeStream(&info_);
+    }
+
+    // simulation only: set the number of elements the stream can hold, 0 for
+    // an unbounded stream
+    void set_depth(size_t depth) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      info_.depth = depth;
+      not_full_.notify_all();
+    }
+
+    bool empty() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return queue_.empty();
+    }
+
+    bool full() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return isFull();
+    }
+
+    size_t size() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return queue_.size();
+    }
+
+    void read(T &dout) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (queue_.empty()) {
+        ++info_.emptyStalls;
+        if (!hipacc_sim::Dataflow::inProcess()) {
+          hipacc_sim::fatal("Stream '" + info_.name + "' is read while empty.");
+        }
+        hipacc_sim::Dataflow::block("reading empty stream '" + info_.name + "'");
+        not_empty_.wait(lock, [this] { return !queue_.empty(); });
+        hipacc_sim::Dataflow::unblock();
+      }
+      dout = queue_.front();
+      queue_.pop_front();
+      ++info_.reads;
+      info_.size = queue_.size();
+      hipacc_sim::Dataflow::notifyProgress();
+      not_full_.notify_one();
+    }
+
+    T read() {
+      T dout;
+      read(dout);
+      return dout;
+    }
+
+    bool read_nb(T &dout) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) return false;
+      dout = queue_.front();
+      queue_.pop_front();
+      ++info_.reads;
+      info_.size = queue_.size();
+      hipacc_sim::Dataflow::notifyProgress();
+      not_full_.notify_one();
+      return true;
+    }
+
+    void write(const T &din) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (isFull()) {
+        ++info_.fullStalls;
+        if (!hipacc_sim::Dataflow::inProcess()) {
+          hipacc_sim::fatal("Stream '" + info_.name + "' is written while full.");
+        }
+        hipacc_sim::Dataflow::block("writing full stream '" + info_.name + "'");
+        not_full_.wait(lock, [this] { return !isFull(); });
+        hipacc_sim::Dataflow::unblock();
+      }
+      queue_.push_back(din);
+      ++info_.writes;
+      info_.size = queue_.size();
+      info_.maxSize = std::max(info_.maxSize, info_.size);
+      hipacc_sim::Dataflow::notifyProgress();
+      not_empty_.notify_one();
+    }
+
+    bool write_nb(const T &din) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (isFull()) return false;
+      queue_.push_back(din);
+      ++info_.writes;
+      info_.size = queue_.size();
+      info_.maxSize = std::max(info_.maxSize, info_.size);
+      hipacc_sim::Dataflow::notifyProgress();
+      not_empty_.notify_one();
+      return true;
+    }
+
+    void operator>>(T &rdata) { read(rdata); }
+    void operator<<(const T &wdata) { write(wdata); }
+};
+
+} // end namespace hls
+
+#endif  // __HIPACC_SIM_HLS_STREAM_H__
@@ -16,7 +16,7 @@ OFLAGS          = -O3
 
 CC_CC           = @CMAKE_CXX_COMPILER@ -std=c++11 ${CMAKE_THREAD_LIBS_INIT} -Wall -Wunused
 CU_CC           = @NVCC@ $(NVCC_FLAGS) -Xcompiler -Wall -Xcompiler -Wunused
-CC_LINK         = -lm -ldl -lstdc++ @TIME_LINK@
+CC_LINK         = -lm -ldl -lstdc++ -pthread @TIME_LINK@
 CU_LINK         = $(CC_LINK) @CUDA_LINK@
 # OpenCL specific configuration
 ifeq ($(HIPACC_TARGET),Midgard)
@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <sys/time.h>
+
+#include "hipacc.hpp"
+
+// variables set by Makefile
+//#define WIDTH 4096
+//#define HEIGHT 4096
+#define NUM_BINS 32
+
+using namespace hipacc;
+
+
+// get time in milliseconds
+double time_ms () {
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+
+    return ((double)(tv.tv_sec) * 1e+3 + (double)(tv.tv_usec) * 1e-3);
+}
+
+// reference
+std::vector<uint> calc_histogram(uchar *in, int width, int height, int
+        offset_x, int offset_y, int is_width, int is_height, uint num_bins) {
+    std::vector<uint> bins(num_bins, 0);
+
+    for (int y=offset_y; y<offset_y+is_height; ++y) {
+        for (int x=offset_x; x<offset_x+is_width; ++x) {
+            ++bins[in[x + y*width] * num_bins / 256];
+        }
+    }
+
+    return bins;
+}
+std::vector<uint> calc_histogram(uchar *in, int width, int height, uint
+        num_bins) {
+    return calc_histogram(in, width, height, 0, 0, width, height, num_bins);
+}
+
+
+// Kernel description in Hipacc
+class Histogram : public Kernel<uchar> {
+    private:
+        Accessor<uchar> &in;
+
+    public:
+        Histogram(IterationSpace<uchar> &iter, Accessor<uchar> &in) :
+            Kernel(iter),
+            in(in)
+        { add_accessor(&in); }
+
+        void kernel() {
+            output() = in();
+        }
+
+        uint binning(uchar pixel, uint num_bins) {
+            return pixel * num_bins / 256;
+        }
+};
+
+
+int main(int argc, const char **argv) {
+    double time0, time1, dt;
+    const int width = WIDTH;
+    const int height = HEIGHT;
+
+    // host memory for image of width x height pixels
+    uchar *input = new uchar[width*height];
+    uchar *reference_out = new uchar[width*height];
+
+    // initialize data
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            input[y*width + x] = (uchar) (x*height + y);
+            reference_out[y*width + x] = 0;
+        }
+    }
+
+    // input and output image of width x height pixels
+    Image<uchar> in(width, height, input);
+    Image<uchar> out(width, height, reference_out);
+
+    Accessor<uchar> img_in(in);
+    Accessor<uchar> acc_in(in, width/3, height/3, width/3, height/3);
+
+    // iteration spaces
+    IterationSpace<uchar> out_iter(out);
+    IterationSpace<uchar> out_acc_iter(out, width/3, height/3, width/3, height/3);
+
+    // histograms of Images and Accessors
+    Histogram histIN(out_iter, img_in);
+    Histogram histAccIN(out_acc_iter, acc_in);
+
+    std::cerr << "Calculating histograms ..." << std::endl;
+    time0 = time_ms();
+
+    histIN.execute();
+    std::vector<uint> bins_img = histIN.binned_data(NUM_BINS);
+
+    histAccIN.execute();
+    std::vector<uint> bins_acc = histAccIN.binned_data(NUM_BINS);
+
+    time1 = time_ms();
+    dt = time1 - time0;
+
+    std::cerr << "Hipacc: " << dt << " ms, " << (width*height/dt)/1000 << " Mpixel/s" << std::endl;
+
+
+    std::cerr << std::endl << "Calculating reference ..." << std::endl;
+    time0 = time_ms();
+
+    std::vector<uint> ref_img = calc_histogram(input, width, height, NUM_BINS);
+    std::vector<uint> ref_acc = calc_histogram(input, width, height, width/3, height/3, width/3, height/3, NUM_BINS);
+
+    time1 = time_ms();
+    dt = time1 - time0;
+    std::cerr << "Reference: " << dt << " ms, " << (width*height/dt)/1000 << " Mpixel/s" << std::endl;
+
+    // compare results
+    bool passed_all = true;
+    std::cerr << std::endl << "Comparing results ..." << std::endl;
+    for (int i=0; i<NUM_BINS; ++i) {
+        if (bins_img[i] != ref_img[i]) {
+            std::cerr << "Test FAILED for histogram (img) at bin " << i << ": " << bins_img[i] << " vs. " << ref_img[i] << ", aborting ..." << std::endl;
+            passed_all = false;
+            break;
+        }
+    }
+    if (passed_all) {
+        std::cerr << "Histogram (img): PASSED" << std::endl;
+    }
+    for (int i=0; i<NUM_BINS; ++i) {
+        if (bins_acc[i] != ref_acc[i]) {
+            std::cerr << "Test FAILED for histogram (acc) at bin " << i << ": " << bins_acc[i] << " vs. " << ref_acc[i] << ", aborting ..." << std::endl;
+            passed_all = false;
+            break;
+        }
+    }
+    if (passed_all) {
+        std::cerr << "Histogram (acc): PASSED" << std::endl;
+    }
+
+    // print final result
+    if (passed_all) {
+        std::cerr << "Tests PASSED" << std::endl;
+    } else {
+        std::cerr << "Tests FAILED" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // memory cleanup
+    delete[] input;
+    delete[] reference_out;
+
+    return EXIT_SUCCESS;
+}
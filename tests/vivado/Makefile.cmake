@@ -22,7 +22,7 @@ OFLAGS          = -O3
 
 CC_CC           = @CMAKE_CXX_COMPILER@ -std=c++11 -Wall -Wunused
 CU_CC           = @NVCC@ $(NVCC_FLAGS) -Xcompiler -Wall -Xcompiler -Wunused
-CC_LINK         = -lm -ldl -lstdc++ @TIME_LINK@
+CC_LINK         = -lm -ldl -lstdc++ -pthread @TIME_LINK@
 CU_LINK         = $(CC_LINK) @CUDA_LINK@
 # OpenCL specific configuration
 ifeq ($(HIPACC_TARGET),Midgard)
@@ -49,6 +49,9 @@ ifge = $(shell if [ $(1) -ge $(2) ]; then echo true; else echo false; fi)
 # use specific configuration for kernels -> set HIPACC_CONFIG to nxm
 # generate code that explores configuration -> set HIPACC_EXPLORE to off|on
 # generate code that times kernel execution -> set HIPACC_TIMING to off|on
+# Vivado: use m_axi memory ports -> set HIPACC_M_AXI to nxm
+# Vivado: process frames in strips of n pixels -> set HIPACC_STRIP_WIDTH to n
+# Vivado: emit a free-running video entry -> set HIPACC_VIDEO to off|on
 HIPACC_LMEM?=off
 HIPACC_TEX?=off
 HIPACC_VEC?=off
@@ -87,6 +90,18 @@ endif
 ifdef HIPACC_TARGET_II
     HIPACC_OPTS+= -target-II $(HIPACC_TARGET_II)
 endif
+ifdef HIPACC_FIXED_POINT
+    HIPACC_OPTS+= -fixed-point $(HIPACC_FIXED_POINT)
+endif
+ifdef HIPACC_M_AXI
+    HIPACC_OPTS+= -m-axi $(HIPACC_M_AXI)
+endif
+ifdef HIPACC_STRIP_WIDTH
+    HIPACC_OPTS+= -strip-width $(HIPACC_STRIP_WIDTH)
+endif
+ifeq ($(HIPACC_VIDEO),on)
+    HIPACC_OPTS+= -video
+endif
 
 # set target GPU architecture to the compute capability encoded in target
 GPU_ARCH := $(shell echo $(HIPACC_TARGET) |cut -f2 -d-)
@@ -153,8 +168,40 @@ vivado:
 	$(COMPILER) $(TEST_CASE)/main.cpp $(MYFLAGS) $(COMPILER_INC) -emit-vivado $(HIPACC_OPTS) -o main.cc
 	vivado_hls -f script.tcl
 
+# C simulation without Vivado HLS: each process of the dataflow region runs on
+# its own thread, set HIPACC_SIM_STATS=1 to print stream statistics
+vivado-sim:
+	@echo 'Executing HIPAcc Compiler for Vivado HLS:'
+	$(COMPILER) $(TEST_CASE)/main.cpp $(MYFLAGS) $(COMPILER_INC) -emit-vivado $(HIPACC_OPTS) -o main.cc
+	@echo 'Compiling Vivado HLS C simulation using g++:'
+	$(CC_CC) -I$(HIPACC_DIR)/include/vivado_sim -I$(HIPACC_DIR)/include $(COMMON_INC) $(MYFLAGS) $(OFLAGS) -o main_vivado_sim main.cc hipacc_run.cc $(CC_LINK)
+	@echo 'Executing Vivado HLS C simulation'
+	./main_vivado_sim
+
+# compares the output of the C simulation against the C++ target, with
+# streams, memory ports, strips and video mode; the test case writes its
+# output to the file given as argument. Finally, the fixed-point conversion is
+# checked by tests/fixed_point against its floating-point reference, e.g.
+# make vivado-sim-check TEST_CASE=./tests/edge_pipeline \
+#     MYFLAGS="-DWIDTH=64 -DHEIGHT=48"
+define vivado-sim-compare
+	$(MAKE) vivado-sim $(1)
+	@echo 'Comparing Vivado HLS C simulation ($(1)) against C++'
+	./main_vivado_sim output_vivado_sim.raw
+	cmp output_cpu.raw output_vivado_sim.raw
+endef
+
+vivado-sim-check:
+	$(MAKE) cpu
+	./main_cpu output_cpu.raw
+	$(call vivado-sim-compare,)
+	$(call vivado-sim-compare,HIPACC_M_AXI=16x2)
+	$(call vivado-sim-compare,HIPACC_M_AXI=16x2 HIPACC_STRIP_WIDTH=16)
+	$(call vivado-sim-compare,HIPACC_VIDEO=on)
+	$(MAKE) vivado-sim TEST_CASE=./tests/fixed_point HIPACC_FIXED_POINT=0.01
+
 clean:
-	rm -f main_* *.cu *.cc *.cubin *.cl *.isa *.rs *.fs *.log
+	rm -f main_* *.cu *.cc *.cubin *.cl *.isa *.rs *.fs *.log *.raw
 	rm -rf hipacc_project
 	rm -rf build_*
 
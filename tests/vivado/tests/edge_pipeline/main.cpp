@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <iostream>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hipacc.hpp"
+
+// Pipeline of a Gaussian blur, a Laplace filter reading the blurred image, and
+// a point operator combining both results. Compares the result against a
+// reference and writes it to the file given as argument, see target
+// vivado-sim-check comparing the C simulation against the C++ target.
+
+// variables set by Makefile
+#ifndef WIDTH
+#define WIDTH  64
+#endif
+#ifndef HEIGHT
+#define HEIGHT 48
+#endif
+#define THRESHOLD 16
+
+using namespace hipacc;
+using namespace hipacc::math;
+
+
+// reference
+int clamp_idx(int idx, int upper) {
+    return idx < 0 ? 0 : idx >= upper ? upper-1 : idx;
+}
+int mirror_idx(int idx, int upper) {
+    return idx < 0 ? -idx-1 : idx >= upper ? 2*upper-idx-1 : idx;
+}
+
+void calc_reference(uchar *in, uchar *blur, uchar *out, int width, int
+        height) {
+    const int gauss[3][3] = { { 1, 2, 1 }, { 2, 4, 2 }, { 1, 2, 1 } };
+
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            int sum = 0;
+            for (int yf=-1; yf<=1; ++yf) {
+                for (int xf=-1; xf<=1; ++xf) {
+                    sum += gauss[yf+1][xf+1] * in[clamp_idx(y+yf, height)*width
+                        + clamp_idx(x+xf, width)];
+                }
+            }
+            blur[y*width + x] = (uchar)(sum / 16);
+        }
+    }
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            int sum = 4 * blur[y*width + x]
+                - blur[mirror_idx(y-1, height)*width + x]
+                - blur[mirror_idx(y+1, height)*width + x]
+                - blur[y*width + mirror_idx(x-1, width)]
+                - blur[y*width + mirror_idx(x+1, width)];
+            sum = sum < 0 ? -sum : sum;
+            out[y*width + x] = sum > THRESHOLD ? blur[y*width + x] : 0;
+        }
+    }
+}
+
+
+// Kernel description in Hipacc
+class GaussianBlur : public Kernel<uchar> {
+    private:
+        Accessor<uchar> &input;
+        Mask<int> &mask;
+
+    public:
+        GaussianBlur(IterationSpace<uchar> &iter, Accessor<uchar> &input,
+                Mask<int> &mask) :
+            Kernel(iter),
+            input(input),
+            mask(mask)
+        { add_accessor(&input); }
+
+        void kernel() {
+            int sum = convolve(mask, Reduce::SUM, [&] () -> int {
+                    return mask() * input(mask);
+                    });
+            output() = (uchar)(sum / 16);
+        }
+};
+
+class LaplaceFilter : public Kernel<uchar> {
+    private:
+        Accessor<uchar> &input;
+        Domain &dom;
+        Mask<int> &mask;
+
+    public:
+        LaplaceFilter(IterationSpace<uchar> &iter, Accessor<uchar> &input,
+                Domain &dom, Mask<int> &mask) :
+            Kernel(iter),
+            input(input),
+            dom(dom),
+            mask(mask)
+        { add_accessor(&input); }
+
+        void kernel() {
+            int sum = reduce(dom, Reduce::SUM, [&] () -> int {
+                    return mask(dom) * input(dom);
+                    });
+            output() = (uchar)min(abs(sum), 255);
+        }
+};
+
+class Threshold : public Kernel<uchar> {
+    private:
+        Accessor<uchar> &blur;
+        Accessor<uchar> &edge;
+
+    public:
+        Threshold(IterationSpace<uchar> &iter, Accessor<uchar> &blur,
+                Accessor<uchar> &edge) :
+            Kernel(iter),
+            blur(blur),
+            edge(edge)
+        { add_accessor(&blur); add_accessor(&edge); }
+
+        void kernel() {
+            uchar out = 0;
+            if (edge() > THRESHOLD) {
+                out = blur();
+            }
+            output() = out;
+        }
+};
+
+
+int main(int argc, const char **argv) {
+    const int width = WIDTH;
+    const int height = HEIGHT;
+
+    const int gauss[3][3] = {
+        { 1, 2, 1 },
+        { 2, 4, 2 },
+        { 1, 2, 1 }
+    };
+    const int laplace[3][3] = {
+        {  0, -1,  0 },
+        { -1,  4, -1 },
+        {  0, -1,  0 }
+    };
+
+    // host memory for image of width x height pixels
+    uchar *host_in = new uchar[width*height];
+    uchar *host_out = new uchar[width*height];
+    uchar *reference_blur = new uchar[width*height];
+    uchar *reference_out = new uchar[width*height];
+
+    // initialize data: blocks of different intensities and a gradient
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            host_in[y*width + x] = (uchar)(((x/8 + y/8) % 2) * 160 + x + y);
+            host_out[y*width + x] = 0;
+        }
+    }
+
+    // input, intermediate, and output images of width x height pixels
+    Image<uchar> IN(width, height);
+    Image<uchar> BLUR(width, height);
+    Image<uchar> EDGE(width, height);
+    Image<uchar> OUT(width, height);
+
+    Mask<int> G(gauss);
+    Mask<int> L(laplace);
+    Domain D(L);
+
+    IterationSpace<uchar> IsBlur(BLUR);
+    IterationSpace<uchar> IsEdge(EDGE);
+    IterationSpace<uchar> IsOut(OUT);
+
+    IN = host_in;
+    OUT = host_out;
+
+    BoundaryCondition<uchar> BcInClamp(IN, G, Boundary::CLAMP);
+    Accessor<uchar> AccInClamp(BcInClamp);
+    GaussianBlur GB(IsBlur, AccInClamp, G);
+    GB.execute();
+
+    BoundaryCondition<uchar> BcBlurMirror(BLUR, L, Boundary::MIRROR);
+    Accessor<uchar> AccBlurMirror(BcBlurMirror);
+    LaplaceFilter LF(IsEdge, AccBlurMirror, D, L);
+    LF.execute();
+
+    Accessor<uchar> AccBlur(BLUR);
+    Accessor<uchar> AccEdge(EDGE);
+    Threshold TH(IsOut, AccBlur, AccEdge);
+    TH.execute();
+
+    // get results
+    host_out = OUT.data();
+
+    calc_reference(host_in, reference_blur, reference_out, width, height);
+
+    // compare results
+    bool passed = true;
+    for (int y=0; y<height && passed; ++y) {
+        for (int x=0; x<width; ++x) {
+            if (host_out[y*width + x] != reference_out[y*width + x]) {
+                fprintf(stderr, "Test FAILED at (%d,%d): %d vs. %d\n", x, y,
+                        host_out[y*width + x], reference_out[y*width + x]);
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // output for comparing targets
+    if (argc > 1) {
+        FILE *file = fopen(argv[1], "wb");
+        if (file == NULL) {
+            fprintf(stderr, "Could not open %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        fwrite(host_out, sizeof(uchar), width*height, file);
+        fclose(file);
+    }
+
+    // memory cleanup
+    delete[] host_in;
+    delete[] reference_blur;
+    delete[] reference_out;
+
+    if (!passed) {
+        fprintf(stderr, "Tests FAILED\n");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "Tests PASSED\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <iostream>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hipacc.hpp"
+
+// Floating-point Gaussian blur converted to fixed-point with -fixed-point
+// MAX_ERROR, see target vivado-sim-check. Compares the result against a
+// floating-point reference, allowing for the error bound of the conversion.
+
+// variables set by Makefile
+#ifndef WIDTH
+#define WIDTH  64
+#endif
+#ifndef HEIGHT
+#define HEIGHT 48
+#endif
+#ifndef MAX_ERROR
+#define MAX_ERROR 0.01f
+#endif
+
+using namespace hipacc;
+
+
+// reference
+int clamp_idx(int idx, int upper) {
+    return idx < 0 ? 0 : idx >= upper ? upper-1 : idx;
+}
+
+void calc_reference(uchar *in, float *out, const float mask[3][3], int width,
+        int height) {
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            float sum = 0;
+            for (int yf=-1; yf<=1; ++yf) {
+                for (int xf=-1; xf<=1; ++xf) {
+                    sum += mask[yf+1][xf+1] * in[clamp_idx(y+yf, height)*width
+                        + clamp_idx(x+xf, width)];
+                }
+            }
+            out[y*width + x] = sum;
+        }
+    }
+}
+
+
+// Kernel description in Hipacc
+class GaussianBlur : public Kernel<float> {
+    private:
+        Accessor<uchar> &input;
+        Mask<float> &mask;
+
+    public:
+        GaussianBlur(IterationSpace<float> &iter, Accessor<uchar> &input,
+                Mask<float> &mask) :
+            Kernel(iter),
+            input(input),
+            mask(mask)
+        { add_accessor(&input); }
+
+        void kernel() {
+            output() = convolve(mask, Reduce::SUM, [&] () -> float {
+                    return mask() * input(mask);
+                    });
+        }
+};
+
+
+int main(int argc, const char **argv) {
+    const int width = WIDTH;
+    const int height = HEIGHT;
+
+    // Gaussian of sigma 1, the coefficients are not representable exactly
+    const float gauss[3][3] = {
+        { 0.075114f, 0.123841f, 0.075114f },
+        { 0.123841f, 0.204180f, 0.123841f },
+        { 0.075114f, 0.123841f, 0.075114f }
+    };
+
+    // host memory for image of width x height pixels
+    uchar *host_in = new uchar[width*height];
+    float *host_out = new float[width*height];
+    float *reference_out = new float[width*height];
+
+    // initialize data: blocks of different intensities and a gradient
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            host_in[y*width + x] = (uchar)(((x/8 + y/8) % 2) * 160 + x + y);
+            host_out[y*width + x] = 0;
+        }
+    }
+
+    // input and output images of width x height pixels
+    Image<uchar> IN(width, height);
+    Image<float> OUT(width, height);
+
+    Mask<float> G(gauss);
+
+    IterationSpace<float> IsOut(OUT);
+
+    IN = host_in;
+    OUT = host_out;
+
+    BoundaryCondition<uchar> BcInClamp(IN, G, Boundary::CLAMP);
+    Accessor<uchar> AccInClamp(BcInClamp);
+    GaussianBlur GB(IsOut, AccInClamp, G);
+    GB.execute();
+
+    // get results
+    host_out = OUT.data();
+
+    calc_reference(host_in, reference_out, gauss, width, height);
+
+    // compare results, the reference itself is rounded to float
+    bool passed = true;
+    for (int y=0; y<height && passed; ++y) {
+        for (int x=0; x<width; ++x) {
+            if (fabsf(host_out[y*width + x] - reference_out[y*width + x]) >
+                MAX_ERROR + 1e-4f) {
+                fprintf(stderr, "Test FAILED at (%d,%d): %f vs. %f\n", x, y,
+                        host_out[y*width + x], reference_out[y*width + x]);
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // output for comparing targets
+    if (argc > 1) {
+        FILE *file = fopen(argv[1], "wb");
+        if (file == NULL) {
+            fprintf(stderr, "Could not open %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        fwrite(host_out, sizeof(float), width*height, file);
+        fclose(file);
+    }
+
+    // memory cleanup
+    delete[] host_in;
+    delete[] reference_out;
+
+    if (!passed) {
+        fprintf(stderr, "Tests FAILED\n");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "Tests PASSED\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <iostream>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hipacc.hpp"
+
+// Pipeline of kernels whose variables and streams are narrowed by their value
+// ranges: squares of unsigned variables exceeding the range of int after
+// integer promotion, unsigned subtractions wrapping around, and a constant
+// border outside of the range of the narrowed stream read by a convolution.
+// Compares the result against a reference and writes it to the file given as
+// argument, see target vivado-sim-check.
+
+// variables set by Makefile
+#ifndef WIDTH
+#define WIDTH  64
+#endif
+#ifndef HEIGHT
+#define HEIGHT 48
+#endif
+
+using namespace hipacc;
+
+
+// reference
+void calc_reference(ushort *in, int *out, int width, int height) {
+    uchar *bias = new uchar[width*height];
+
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            uint v = in[y*width + x];
+            uint sq = v * v;
+            uint a = sq >> 24;
+            uchar wrapped = (uchar)((a - 300) / 2);
+            bias[y*width + x] = wrapped / 2 + 16;
+        }
+    }
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            int sum = 0;
+            for (int yf=-1; yf<=1; ++yf) {
+                for (int xf=-1; xf<=1; ++xf) {
+                    int val = 0;
+                    if (y+yf >= 0 && y+yf < height && x+xf >= 0 &&
+                        x+xf < width) {
+                        val = bias[(y+yf)*width + x+xf];
+                    }
+                    sum += val - 16;
+                }
+            }
+            out[y*width + x] = sum;
+        }
+    }
+
+    delete[] bias;
+}
+
+
+// Kernel description in Hipacc
+class Square : public Kernel<uint> {
+    private:
+        Accessor<ushort> &input;
+
+    public:
+        Square(IterationSpace<uint> &iter, Accessor<ushort> &input) :
+            Kernel(iter),
+            input(input)
+        { add_accessor(&input); }
+
+        void kernel() {
+            uint v = input();
+            uint sq = v * v;
+            output() = sq >> 24;
+        }
+};
+
+class Wrap : public Kernel<uchar> {
+    private:
+        Accessor<uint> &input;
+
+    public:
+        Wrap(IterationSpace<uchar> &iter, Accessor<uint> &input) :
+            Kernel(iter),
+            input(input)
+        { add_accessor(&input); }
+
+        void kernel() {
+            uint a = input();
+            output() = (uchar)((a - 300) / 2);
+        }
+};
+
+class Bias : public Kernel<uchar> {
+    private:
+        Accessor<uchar> &input;
+
+    public:
+        Bias(IterationSpace<uchar> &iter, Accessor<uchar> &input) :
+            Kernel(iter),
+            input(input)
+        { add_accessor(&input); }
+
+        void kernel() {
+            output() = input() / 2 + 16;
+        }
+};
+
+class Unbias : public Kernel<int> {
+    private:
+        Accessor<uchar> &input;
+        Mask<int> &mask;
+
+    public:
+        Unbias(IterationSpace<int> &iter, Accessor<uchar> &input,
+                Mask<int> &mask) :
+            Kernel(iter),
+            input(input),
+            mask(mask)
+        { add_accessor(&input); }
+
+        void kernel() {
+            int sum = convolve(mask, Reduce::SUM, [&] () -> int {
+                    return mask() * (input(mask) - 16);
+                    });
+            output() = sum;
+        }
+};
+
+
+int main(int argc, const char **argv) {
+    const int width = WIDTH;
+    const int height = HEIGHT;
+
+    const int ones[3][3] = {
+        { 1, 1, 1 },
+        { 1, 1, 1 },
+        { 1, 1, 1 }
+    };
+
+    // host memory for image of width x height pixels
+    ushort *host_in = new ushort[width*height];
+    int *host_out = new int[width*height];
+    int *reference_out = new int[width*height];
+
+    // initialize data: the full range of ushort
+    for (int y=0; y<height; ++y) {
+        for (int x=0; x<width; ++x) {
+            host_in[y*width + x] = (ushort)((y*width + x) * 65535 /
+                                            (width*height - 1));
+            host_out[y*width + x] = 0;
+        }
+    }
+
+    // input, intermediate, and output images of width x height pixels
+    Image<ushort> IN(width, height);
+    Image<uint> SQ(width, height);
+    Image<uchar> WRAP(width, height);
+    Image<uchar> BIAS(width, height);
+    Image<int> OUT(width, height);
+
+    Mask<int> M(ones);
+
+    IterationSpace<uint> IsSq(SQ);
+    IterationSpace<uchar> IsWrap(WRAP);
+    IterationSpace<uchar> IsBias(BIAS);
+    IterationSpace<int> IsOut(OUT);
+
+    IN = host_in;
+    OUT = host_out;
+
+    Accessor<ushort> AccIn(IN);
+    Square SQR(IsSq, AccIn);
+    SQR.execute();
+
+    Accessor<uint> AccSq(SQ);
+    Wrap WR(IsWrap, AccSq);
+    WR.execute();
+
+    Accessor<uchar> AccWrap(WRAP);
+    Bias BI(IsBias, AccWrap);
+    BI.execute();
+
+    BoundaryCondition<uchar> BcBiasConst(BIAS, M, Boundary::CONSTANT, 0);
+    Accessor<uchar> AccBiasConst(BcBiasConst);
+    Unbias UB(IsOut, AccBiasConst, M);
+    UB.execute();
+
+    // get results
+    host_out = OUT.data();
+
+    calc_reference(host_in, reference_out, width, height);
+
+    // compare results
+    bool passed = true;
+    for (int y=0; y<height && passed; ++y) {
+        for (int x=0; x<width; ++x) {
+            if (host_out[y*width + x] != reference_out[y*width + x]) {
+                fprintf(stderr, "Test FAILED at (%d,%d): %d vs. %d\n", x, y,
+                        host_out[y*width + x], reference_out[y*width + x]);
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // output for comparing targets
+    if (argc > 1) {
+        FILE *file = fopen(argv[1], "wb");
+        if (file == NULL) {
+            fprintf(stderr, "Could not open %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        fwrite(host_out, sizeof(int), width*height, file);
+        fclose(file);
+    }
+
+    // memory cleanup
+    delete[] host_in;
+    delete[] reference_out;
+
+    if (!passed) {
+        fprintf(stderr, "Tests FAILED\n");
+        return EXIT_FAILURE;
+    }
+    fprintf(stderr, "Tests PASSED\n");
+
+    return EXIT_SUCCESS;
+}